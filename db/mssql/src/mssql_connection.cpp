@@ -192,6 +192,21 @@ void mssql_connection::rollback()
   execute_no_result("ROLLBACK;");
 }
 
+void mssql_connection::savepoint(const std::string &name)
+{
+  execute_no_result("SAVE TRANSACTION " + name + ";");
+}
+
+void mssql_connection::rollback_to(const std::string &name)
+{
+  execute_no_result("ROLLBACK TRANSACTION " + name + ";");
+}
+
+void mssql_connection::release(const std::string &)
+{
+  // sql server doesn't release savepoints
+}
+
 std::string mssql_connection::type() const
 {
   return "mssql";
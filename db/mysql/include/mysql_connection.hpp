@@ -90,6 +90,10 @@ public:
   virtual void commit() override;
   virtual void rollback() override;
 
+  virtual void savepoint(const std::string &name) override;
+  virtual void rollback_to(const std::string &name) override;
+  virtual void release(const std::string &name) override;
+
   virtual std::string type() const override;
   virtual std::string version() const override;
 
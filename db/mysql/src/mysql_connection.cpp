@@ -138,6 +138,24 @@ void mysql_connection::rollback()
   std::unique_ptr<mysql_result> res(static_cast<mysql_result*>(execute("ROLLBACK;")));
 }
 
+void mysql_connection::savepoint(const std::string &name)
+{
+  // TODO: check result
+  std::unique_ptr<mysql_result> res(static_cast<mysql_result*>(execute("SAVEPOINT " + name + ";")));
+}
+
+void mysql_connection::rollback_to(const std::string &name)
+{
+  // TODO: check result
+  std::unique_ptr<mysql_result> res(static_cast<mysql_result*>(execute("ROLLBACK TO SAVEPOINT " + name + ";")));
+}
+
+void mysql_connection::release(const std::string &name)
+{
+  // TODO: check result
+  std::unique_ptr<mysql_result> res(static_cast<mysql_result*>(execute("RELEASE SAVEPOINT " + name + ";")));
+}
+
 std::string mysql_connection::type() const
 {
   return "mysql";
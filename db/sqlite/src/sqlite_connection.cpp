@@ -94,6 +94,21 @@ void sqlite_connection::rollback()
   std::unique_ptr<sqlite_result> res(static_cast<sqlite_result*>(execute("ROLLBACK TRANSACTION;")));
 }
 
+void sqlite_connection::savepoint(const std::string &name)
+{
+  std::unique_ptr<sqlite_result> res(static_cast<sqlite_result*>(execute("SAVEPOINT " + name + ";")));
+}
+
+void sqlite_connection::rollback_to(const std::string &name)
+{
+  std::unique_ptr<sqlite_result> res(static_cast<sqlite_result*>(execute("ROLLBACK TO SAVEPOINT " + name + ";")));
+}
+
+void sqlite_connection::release(const std::string &name)
+{
+  std::unique_ptr<sqlite_result> res(static_cast<sqlite_result*>(execute("RELEASE SAVEPOINT " + name + ";")));
+}
+
 std::string sqlite_connection::type() const
 {
   return "sqlite";
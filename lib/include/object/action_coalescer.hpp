@@ -0,0 +1,82 @@
+#ifndef OOS_ACTION_COALESCER_HPP
+#define OOS_ACTION_COALESCER_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+#define OOS_API __declspec(dllexport)
+#define EXPIMP_TEMPLATE
+#else
+#define OOS_API __declspec(dllimport)
+#define EXPIMP_TEMPLATE extern
+#endif
+#pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
+#include "object/action_visitor.hpp"
+#include "object/action.hpp"
+
+#include <unordered_set>
+#include <vector>
+
+namespace oos {
+
+/// @cond OOS_DEV
+
+/**
+ * @class action_coalescer
+ * @brief Reduces the actions of a transaction to their net effect
+ *
+ * While a transaction is running each object is backed
+ * up once per savepoint: repeated updates and updates
+ * of inserted objects don't add actions and a deletion
+ * replaces the update action or removes the object from
+ * its insert action. The action log is kept as it is to
+ * be able to roll the transaction back.
+ *
+ * On commit the coalescer creates the write set from
+ * the log. Objects inserted and deleted are left out,
+ * inserted or deleted objects aren't updated, updates
+ * which didn't change any field are dropped and each
+ * object is updated at most once.
+ */
+class OOS_API action_coalescer : public action_visitor
+{
+public:
+  typedef std::shared_ptr<action> action_ptr;
+  typedef std::vector<action_ptr> t_action_vactor;
+
+public:
+  virtual ~action_coalescer() {}
+
+  /**
+   * Appends the net actions of the
+   * given action log to result.
+   *
+   * @param actions The action log of the transaction
+   * @param result The resulting write set
+   */
+  void coalesce(const t_action_vactor &actions, t_action_vactor &result);
+
+  virtual void visit(insert_action *a);
+  virtual void visit(update_action *a);
+  virtual void visit(delete_action *a);
+
+private:
+  enum class pass { COLLECT, REDUCE };
+
+  pass pass_ = pass::COLLECT;
+  action_ptr current_;
+  t_action_vactor *result_ = nullptr;
+
+  std::unordered_set<unsigned long> inserted_;
+  std::unordered_set<unsigned long> deleted_;
+  std::unordered_set<unsigned long> written_;
+};
+
+/// @endcond
+
+}
+
+#endif //OOS_ACTION_COALESCER_HPP
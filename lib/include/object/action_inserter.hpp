@@ -42,8 +42,29 @@ public:
 
   virtual ~action_inserter() { }
 
+  /**
+   * Adds the proxy to the insert action of its type
+   * at or after the given index or appends a new
+   * insert action.
+   *
+   * @param proxy The proxy to add
+   * @param first The index of the first action to consider
+   * @return The index of the insert action
+   */
   template < class T >
-  t_action_vactor::size_type insert(object_proxy *proxy);
+  t_action_vactor::size_type insert(object_proxy *proxy, t_action_vactor::size_type first = 0);
+
+  /**
+   * Adds all proxies to the insert action of their
+   * type. The proxies must be of the same type, so
+   * the actions are searched only once.
+   *
+   * @param proxies The proxies to add
+   * @param first The index of the first action to consider
+   * @return The index of the insert action
+   */
+  template < class T >
+  t_action_vactor::size_type insert(const std::vector<object_proxy*> &proxies, t_action_vactor::size_type first = 0);
 
   virtual void visit(insert_action *a);
   virtual void visit(update_action *a);
@@ -60,11 +81,11 @@ private:
 };
 
 template < class T >
-action_inserter::t_action_vactor::size_type action_inserter::insert(object_proxy *proxy) {
+action_inserter::t_action_vactor::size_type action_inserter::insert(object_proxy *proxy, t_action_vactor::size_type first) {
   proxy_ = proxy;
   inserted_ = false;
   t_action_vactor::size_type end = actions_.get().size();
-  for (t_action_vactor::size_type i = 0; i < end; ++i) {
+  for (t_action_vactor::size_type i = first; i < end; ++i) {
 //  while (first != last) {
     actions_.get().at(i)->accept(this);
 
@@ -84,6 +105,21 @@ action_inserter::t_action_vactor::size_type action_inserter::insert(object_proxy
   return actions_.get().size();
 }
 
+template < class T >
+action_inserter::t_action_vactor::size_type action_inserter::insert(const std::vector<object_proxy*> &proxies, t_action_vactor::size_type first) {
+  if (proxies.empty()) {
+    return actions_.get().size();
+  }
+  t_action_vactor::size_type index = insert<T>(proxies.front(), first);
+  if (index < actions_.get().size()) {
+    insert_action *ia = static_cast<insert_action*>(actions_.get().at(index).get());
+    for (std::vector<object_proxy*>::size_type i = 1; i < proxies.size(); ++i) {
+      ia->push_back(proxies[i]);
+    }
+  }
+  return index;
+}
+
 /// @endcond
 
 }
@@ -0,0 +1,274 @@
+#ifndef OOS_ATTRIBUTE_INDEX_HPP
+#define OOS_ATTRIBUTE_INDEX_HPP
+
+#include "object/object_index.hpp"
+#include "object/object_exception.hpp"
+#include "object/has_one.hpp"
+#include "object/abstract_has_many.hpp"
+
+#include "tools/access.hpp"
+#include "tools/date.hpp"
+#include "tools/time.hpp"
+#include "tools/varchar.hpp"
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace oos {
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * @class index_value_reader
+ * @brief Reads the value of one attribute for an index
+ *
+ * Only attributes of exactly type V are read.
+ *
+ * @tparam V The type of the value
+ */
+template < class V >
+class index_value_reader
+{
+public:
+  index_value_reader(const char *id, V &to)
+    : id_(id), to_(to)
+  {}
+
+  bool success() const { return success_; }
+
+  template < class T >
+  void serialize(T &x)
+  {
+    oos::access::serialize(*this, x);
+  }
+
+  template < class T >
+  void serialize(const char *id, T &from, typename std::enable_if<std::is_same<T, V>::value>::type* = 0)
+  {
+    if (strcmp(id_, id) == 0) {
+      to_ = from;
+      success_ = true;
+    }
+  }
+
+  template < class T >
+  void serialize(const char *, T &, typename std::enable_if<!std::is_same<T, V>::value>::type* = 0) {}
+  void serialize(const char *, char*, size_t) {}
+  template < class HAS_ONE >
+  void serialize(const char *, HAS_ONE &, cascade_type) {}
+  template < class HAS_MANY >
+  void serialize(const char *, HAS_MANY &, const char *, const char *) {}
+
+private:
+  const char *id_;
+  V &to_;
+  bool success_ = false;
+};
+
+/**
+ * All string like attributes (std::string,
+ * varchar and character arrays) are read
+ * as std::string.
+ */
+template <>
+class index_value_reader<std::string>
+{
+public:
+  index_value_reader(const char *id, std::string &to)
+    : id_(id), to_(to)
+  {}
+
+  bool success() const { return success_; }
+
+  template < class T >
+  void serialize(T &x)
+  {
+    oos::access::serialize(*this, x);
+  }
+
+  void serialize(const char *id, std::string &from)
+  {
+    if (strcmp(id_, id) == 0) {
+      to_ = from;
+      success_ = true;
+    }
+  }
+
+  template < unsigned int C >
+  void serialize(const char *id, varchar<C> &from)
+  {
+    if (strcmp(id_, id) == 0) {
+      to_ = from.str();
+      success_ = true;
+    }
+  }
+
+  void serialize(const char *id, char *from, size_t len)
+  {
+    if (strcmp(id_, id) == 0) {
+      to_.assign(from, strnlen(from, len));
+      success_ = true;
+    }
+  }
+
+  template < class T >
+  void serialize(const char *, T &) {}
+  template < class HAS_ONE >
+  void serialize(const char *, HAS_ONE &, cascade_type) {}
+  template < class HAS_MANY >
+  void serialize(const char *, HAS_MANY &, const char *, const char *) {}
+
+private:
+  const char *id_;
+  std::string &to_;
+  bool success_ = false;
+};
+
+/**
+ * @class attribute_index
+ * @brief Index over the attribute of objects of type T
+ *
+ * @tparam T The object type
+ * @tparam V The type of the attribute value
+ */
+template < class T, class V >
+class attribute_index : public object_index<V>
+{
+public:
+  attribute_index(const char *attribute, index_type type)
+    : object_index<V>(attribute, type)
+  {}
+
+protected:
+  virtual bool read(object_proxy *proxy, V &value) const
+  {
+    T *obj = static_cast<T*>(basic_object_index::object(proxy));
+    index_value_reader<V> reader(this->attribute(), value);
+    oos::access::serialize(reader, *obj);
+    return reader.success();
+  }
+};
+
+/**
+ * @class index_builder
+ * @brief Creates the index matching the type of an attribute
+ *
+ * The builder serializes a prototype of T and creates
+ * an attribute_index for the value type of the requested
+ * attribute. Arithmetic, string like, date and time
+ * attributes can be indexed.
+ *
+ * @tparam T The object type
+ */
+template < class T >
+class index_builder
+{
+public:
+  index_builder(const char *attribute, index_type type)
+    : attribute_(attribute), type_(type)
+  {}
+
+  /**
+   * Creates the index for the attribute.
+   *
+   * @return The created index
+   * @throws oos::object_exception if the attribute is unknown or can't be indexed
+   */
+  std::unique_ptr<basic_object_index> build()
+  {
+    T prototype;
+    oos::access::serialize(*this, prototype);
+    if (!index_) {
+      throw object_exception("unknown attribute for index");
+    }
+    return std::move(index_);
+  }
+
+  template < class V >
+  void serialize(V &x)
+  {
+    oos::access::serialize(*this, x);
+  }
+
+  template < class V >
+  void serialize(const char *id, V &, typename std::enable_if<std::is_arithmetic<V>::value>::type* = 0)
+  {
+    create<V>(id);
+  }
+
+  void serialize(const char *id, std::string &)
+  {
+    create<std::string>(id);
+  }
+
+  template < unsigned int C >
+  void serialize(const char *id, varchar<C> &)
+  {
+    create<std::string>(id);
+  }
+
+  void serialize(const char *id, char *, size_t)
+  {
+    create<std::string>(id);
+  }
+
+  void serialize(const char *id, date &)
+  {
+    create<date>(id);
+  }
+
+  void serialize(const char *id, time &)
+  {
+    create<time>(id);
+  }
+
+  template < class V >
+  void serialize(const char *id, V &, typename std::enable_if<!std::is_arithmetic<V>::value>::type* = 0)
+  {
+    unsupported(id);
+  }
+
+  template < class V >
+  void serialize(const char *id, has_one<V> &, cascade_type)
+  {
+    unsupported(id);
+  }
+
+  template < class HAS_MANY >
+  void serialize(const char *id, HAS_MANY &, const char *, const char *)
+  {
+    unsupported(id);
+  }
+
+private:
+  template < class V >
+  void create(const char *id)
+  {
+    if (attribute_ == id) {
+      index_.reset(new attribute_index<T, V>(id, type_));
+    }
+  }
+
+  void unsupported(const char *id)
+  {
+    if (attribute_ == id) {
+      throw object_exception("attribute type can't be indexed");
+    }
+  }
+
+private:
+  std::string attribute_;
+  index_type type_;
+  std::unique_ptr<basic_object_index> index_;
+};
+
+/// @endcond
+
+}
+}
+
+#endif //OOS_ATTRIBUTE_INDEX_HPP
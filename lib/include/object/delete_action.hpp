@@ -112,6 +112,8 @@ private:
       proxy = act->proxy_;
 //      proxy = new object_proxy(new T, act->id(), store);
       action::insert_proxy(store, proxy);
+      // a committed delete is undone, the store owns the proxy again
+      act->deleted_ = false;
     } else {
       act->mark_deleted();
     }
@@ -0,0 +1,120 @@
+#ifndef OOS_FIELD_RECORDER_HPP
+#define OOS_FIELD_RECORDER_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
+#include "tools/access.hpp"
+#include "tools/serializer.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace oos {
+
+template < class T >
+class has_one;
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+typedef std::vector<std::pair<std::string, std::string>> t_field_values; /**< Shortcut for the recorded field values */
+
+/**
+ * @class field_recorder
+ * @brief Records the value of each field of an object
+ *
+ * The recorder walks the fields of an object and keeps
+ * the bytes of each value under the name of the field.
+ * Relations are recorded by the primary key of the
+ * related object, has many relations are skipped.
+ * Two recordings of the same object are compared with
+ * modified_fields to find the fields which changed.
+ */
+class OOS_API field_recorder : public serializer
+{
+public:
+  /**
+   * Records the fields of the given object.
+   *
+   * @tparam T The type of the object
+   * @param obj The object to record
+   * @param values The recorded values
+   */
+  template < class T >
+  void record(T &obj, t_field_values &values)
+  {
+    values.clear();
+    values_ = &values;
+    oos::access::serialize(*this, obj);
+    values_ = nullptr;
+  }
+
+  /**
+   * Returns the names of all fields whose
+   * values differ between both recordings.
+   *
+   * @param before The older recording
+   * @param after The newer recording
+   * @return The names of the modified fields
+   */
+  static std::vector<std::string> modified_fields(const t_field_values &before, const t_field_values &after);
+
+  virtual void serialize(const char *id, char &x) override;
+  virtual void serialize(const char *id, short &x) override;
+  virtual void serialize(const char *id, int &x) override;
+  virtual void serialize(const char *id, long &x) override;
+  virtual void serialize(const char *id, unsigned char &x) override;
+  virtual void serialize(const char *id, unsigned short &x) override;
+  virtual void serialize(const char *id, unsigned int &x) override;
+  virtual void serialize(const char *id, unsigned long &x) override;
+  virtual void serialize(const char *id, bool &x) override;
+  virtual void serialize(const char *id, float &x) override;
+  virtual void serialize(const char *id, double &x) override;
+  virtual void serialize(const char *id, char *x, size_t s) override;
+  virtual void serialize(const char *id, std::string &x) override;
+  virtual void serialize(const char *id, varchar_base &x) override;
+  virtual void serialize(const char *id, time &x) override;
+  virtual void serialize(const char *id, date &x) override;
+  virtual void serialize(const char *id, basic_identifier &x) override;
+  virtual void serialize(const char *id, identifiable_holder &x, cascade_type) override;
+
+  using serializer::serialize;
+
+  template < class T >
+  void serialize(const char *id, has_one<T> &x, cascade_type cascade)
+  {
+    serialize(id, static_cast<identifiable_holder&>(x), cascade);
+  }
+
+  template < class T >
+  void serialize(const char *id, has_one<T> &x)
+  {
+    serialize(id, static_cast<identifiable_holder&>(x), NONE);
+  }
+
+private:
+  void append(const char *id, const void *bytes, size_t size);
+
+private:
+  t_field_values *values_ = nullptr;
+};
+
+/// @endcond
+
+}
+}
+
+#endif //OOS_FIELD_RECORDER_HPP
@@ -5,8 +5,26 @@
 #ifndef OOS_IDENTIFIER_PROXY_MAP_HPP
 #define OOS_IDENTIFIER_PROXY_MAP_HPP
 
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
 #include "tools/basic_identifier.hpp"
+#include "tools/identifier.hpp"
 
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
 #include <unordered_map>
 
 namespace oos {
@@ -42,6 +60,160 @@ typedef std::shared_ptr<basic_identifier> identifier_ptr; /**< Shortcut to share
 typedef std::unordered_map<identifier_ptr, object_proxy*, identifier_hash<identifier_ptr>, identifier_equal> t_identifier_map;
 typedef std::unordered_multimap<identifier_ptr, object_proxy*, identifier_hash<identifier_ptr>, identifier_equal> t_identifier_multimap;
 
+/**
+ * @class identifier_proxy_map
+ * @brief Maps primary keys of one prototype node to their proxies
+ *
+ * The entries are bucketed by the hash of the identifier
+ * value, which equals the hash of the raw value. So a proxy
+ * can be looked up by a raw integral or string value
+ * without creating an identifier and without calling
+ * a virtual method.
+ *
+ * All identifiers of one map are expected to be of the
+ * same type, as all objects of a prototype node share
+ * the type of their primary key.
+ */
+class OOS_API identifier_proxy_map
+{
+public:
+  typedef std::pair<identifier_ptr, object_proxy*> value_type; /**< Shortcut to the value type */
+  typedef std::unordered_multimap<std::size_t, value_type> t_hash_map; /**< Shortcut to the hash map */
+  typedef t_hash_map::size_type size_type; /**< Shortcut to the size type */
+
+  /**
+   * Inserts a primary key proxy pair. If the
+   * primary key already exists nothing is inserted.
+   *
+   * @param value The primary key proxy pair
+   * @return True if the pair was inserted
+   */
+  bool insert(const value_type &value);
+
+  /**
+   * Erases the proxy with the given primary key.
+   *
+   * @param pk The primary key
+   * @return The number of erased elements
+   */
+  size_type erase(const identifier_ptr &pk);
+
+  /**
+   * Finds the proxy of the given primary key.
+   *
+   * @param pk The primary key
+   * @return The proxy or nullptr
+   */
+  object_proxy* find(const identifier_ptr &pk) const;
+
+  /**
+   * Finds the proxy of the given integral primary key
+   * value. The value is converted into the integral
+   * type of the stored identifiers.
+   *
+   * @tparam V The integral type of the value
+   * @param value The primary key value
+   * @return The proxy or nullptr
+   */
+  template < class V >
+  object_proxy* find(V value, typename std::enable_if<std::is_integral<V>::value>::type* = 0) const
+  {
+    if (type_ == nullptr) {
+      return nullptr;
+    } else if (is_type<V>()) {
+      return find_value<V>(value);
+    } else if (is_type<long>()) {
+      return find_value<long>(static_cast<long>(value));
+    } else if (is_type<unsigned long>()) {
+      return find_value<unsigned long>(static_cast<unsigned long>(value));
+    } else if (is_type<int>()) {
+      return find_value<int>(static_cast<int>(value));
+    } else if (is_type<unsigned int>()) {
+      return find_value<unsigned int>(static_cast<unsigned int>(value));
+    } else if (is_type<long long>()) {
+      return find_value<long long>(static_cast<long long>(value));
+    } else if (is_type<unsigned long long>()) {
+      return find_value<unsigned long long>(static_cast<unsigned long long>(value));
+    } else if (is_type<short>()) {
+      return find_value<short>(static_cast<short>(value));
+    } else if (is_type<unsigned short>()) {
+      return find_value<unsigned short>(static_cast<unsigned short>(value));
+    }
+    return nullptr;
+  }
+
+  /**
+   * Finds the proxy of the given string
+   * primary key value.
+   *
+   * @param value The primary key value
+   * @return The proxy or nullptr
+   */
+  object_proxy* find(const std::string &value) const;
+
+  /**
+   * Reserves room for n elements.
+   *
+   * @param n The number of elements
+   */
+  void reserve(size_type n);
+
+  /**
+   * Removes all elements.
+   */
+  void clear();
+
+  /**
+   * Returns the number of elements.
+   *
+   * @return The number of elements
+   */
+  size_type size() const;
+
+  /**
+   * Returns the number of buckets.
+   *
+   * @return The number of buckets
+   */
+  size_type bucket_count() const;
+
+  /**
+   * Returns true if the map is empty.
+   *
+   * @return True if the map is empty
+   */
+  bool empty() const;
+
+private:
+  template < class T >
+  bool is_type() const
+  {
+    return *type_ == typeid(identifier<T>);
+  }
+
+  template < class T >
+  object_proxy* find_value(const T &value) const
+  {
+    if (!is_type<T>()) {
+      return nullptr;
+    }
+    // identifier<T>::hash() is the hash of the value
+    auto range = map_.equal_range(std::hash<T>()(value));
+    for (auto i = range.first; i != range.second; ++i) {
+      if (static_cast<const identifier<T>&>(*i->second.first).reference() == value) {
+        return i->second.second;
+      }
+    }
+    return nullptr;
+  }
+
+  t_hash_map::const_iterator find_entry(const identifier_ptr &pk) const;
+
+private:
+  t_hash_map map_;
+  const std::type_info *type_ = nullptr;
+};
+
 /// @endcond
 
 }
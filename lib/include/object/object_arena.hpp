@@ -0,0 +1,207 @@
+#ifndef OOS_OBJECT_ARENA_HPP
+#define OOS_OBJECT_ARENA_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace oos {
+
+/**
+ * @brief Storage policy for an attached object type
+ *
+ * When passed to object_store::attach the prototype_node
+ * of the type owns a chunked arena. All objects created
+ * with object_store::emplace are constructed in place
+ * within this arena and lie side by side in memory.
+ */
+struct pooled_storage
+{
+  /**
+   * Creates a pooled storage policy
+   *
+   * @param size Number of objects per chunk
+   */
+  explicit pooled_storage(std::size_t size = 256)
+    : chunk_size(size)
+  {}
+
+  std::size_t chunk_size; /**< Number of objects per chunk */
+};
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * @class basic_object_arena
+ * @brief Untyped chunked arena of equally sized slots
+ *
+ * Each slot is prefixed by a header holding the owning
+ * arena, so a slot can be released without knowing
+ * its arena. Freed slots are recycled through a free list.
+ */
+class OOS_API basic_object_arena
+{
+public:
+  basic_object_arena(std::size_t object_size, std::size_t object_alignment, std::size_t chunk_size);
+  virtual ~basic_object_arena();
+
+  basic_object_arena(const basic_object_arena&) = delete;
+  basic_object_arena& operator=(const basic_object_arena&) = delete;
+
+  /**
+   * Returns an uninitialized slot.
+   *
+   * @return The allocated slot
+   */
+  void* allocate();
+
+  /**
+   * Returns a slot allocated by allocate()
+   * to its arena.
+   *
+   * @param p The slot to release
+   */
+  static void deallocate(void *p);
+
+  /**
+   * Releases all chunks at once if no
+   * slot is in use anymore.
+   *
+   * @return True if the chunks were released
+   */
+  bool clear();
+
+  /**
+   * Returns the number of slots in use.
+   *
+   * @return Number of slots in use
+   */
+  std::size_t size() const;
+
+  /**
+   * Returns the number of slots of all chunks.
+   *
+   * @return Number of available slots
+   */
+  std::size_t capacity() const;
+
+  /**
+   * Returns the number of allocated chunks.
+   *
+   * @return Number of chunks
+   */
+  std::size_t chunk_count() const;
+
+  /**
+   * Returns the size of one slot including
+   * its header in bytes.
+   *
+   * @return The size of one slot
+   */
+  std::size_t slot_size() const;
+
+private:
+  struct slot_header
+  {
+    basic_object_arena *arena;
+  };
+
+  struct free_slot
+  {
+    free_slot *next;
+  };
+
+  void release(void *p);
+  void add_chunk();
+
+private:
+  std::size_t header_size_;
+  std::size_t slot_size_;
+  std::size_t chunk_size_;
+  std::size_t size_ = 0;
+
+  std::vector<std::unique_ptr<char[]>> chunks_;
+
+  char *cursor_ = nullptr;
+  char *cursor_end_ = nullptr;
+  free_slot *free_list_ = nullptr;
+};
+
+/**
+ * @class object_arena
+ * @brief Chunked arena of objects of type T
+ *
+ * @tparam T The type of the objects
+ */
+template < class T >
+class object_arena : public basic_object_arena
+{
+public:
+  static_assert(alignof(T) <= alignof(std::max_align_t), "over aligned types can't be pooled");
+
+  /**
+   * Creates an empty arena
+   *
+   * @param chunk_size Number of objects per chunk
+   */
+  explicit object_arena(std::size_t chunk_size)
+    : basic_object_arena(sizeof(T), alignof(T), chunk_size)
+  {}
+
+  /**
+   * Constructs a new object in place
+   *
+   * @tparam Args Types of the constructor arguments
+   * @param args The constructor arguments
+   * @return The new object
+   */
+  template < typename ... Args >
+  T* create(Args&&... args)
+  {
+    void *p = allocate();
+    try {
+      return new (p) T(std::forward<Args>(args)...);
+    } catch (...) {
+      deallocate(p);
+      throw;
+    }
+  }
+
+  /**
+   * Destroys an object created by create()
+   * and returns its slot to the arena. The
+   * signature matches the object deleter of
+   * object_proxy.
+   *
+   * @param p The object to destroy
+   */
+  static void destroy(void *p)
+  {
+    static_cast<T*>(p)->~T();
+    deallocate(p);
+  }
+};
+
+/// @endcond
+
+}
+}
+
+#endif //OOS_OBJECT_ARENA_HPP
@@ -31,8 +31,12 @@
 #endif
 
 #include "object/object_ptr.hpp"
+#include "object/attribute_index.hpp"
 
+#include <functional>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 namespace oos {
 
@@ -51,6 +55,16 @@ public:
     return constant_;
   }
 
+  const T& evaluate(const void *) const
+  {
+    return constant_;
+  }
+
+  const T& value() const
+  {
+    return constant_;
+  }
+
 private:
   T constant_;
 };
@@ -64,6 +78,10 @@ public:
   virtual ~variable_impl() {}
   
   virtual return_type operator()(const object_holder &optr) const = 0;
+
+  virtual return_type evaluate(const void *obj) const = 0;
+
+  virtual const char* attribute() const { return nullptr; }
 };
 
 template < class R, class O, class V >
@@ -86,6 +104,11 @@ public:
     return (static_cast<const object_type*>(v_(optr).ptr())->*m_)();
   }
 
+  virtual return_type evaluate(const void *obj) const
+  {
+    return (static_cast<const object_type*>(v_.evaluate(obj).ptr())->*m_)();
+  }
+
 private:
   var_type v_;
   memfunc_type m_;
@@ -108,15 +131,133 @@ public:
 
   virtual return_type operator()(const object_holder &optr) const
   {
-    return (static_cast<const object_type*>(optr.ptr())->*m_)();
+    return evaluate(optr.ptr());
+  }
+
+  virtual return_type evaluate(const void *obj) const
+  {
+    return (static_cast<const object_type*>(obj)->*m_)();
   }
 
 private:
   memfunc_type m_;
 };
 
+template < class R, class O >
+class attribute_variable_impl : public variable_impl<R>
+{
+public:
+  typedef O object_type;
+  typedef R return_type;
+
+  explicit attribute_variable_impl(const char *attribute)
+    : attribute_(attribute)
+  {}
+  virtual ~attribute_variable_impl() {}
+
+  virtual return_type operator()(const object_holder &optr) const
+  {
+    return evaluate(optr.ptr());
+  }
+
+  virtual return_type evaluate(const void *obj) const
+  {
+    return_type value = return_type();
+    detail::index_value_reader<return_type> reader(attribute_.c_str(), value);
+    oos::access::serialize(reader, *static_cast<object_type*>(const_cast<void*>(obj)));
+    return value;
+  }
+
+  virtual const char* attribute() const
+  {
+    return attribute_.c_str();
+  }
+
+private:
+  std::string attribute_;
+};
+
 /// @endcond OOS_DEV
 
+/**
+ * @tparam R Type of the variable
+ * @tparam O Type of the object
+ * @class member_variable
+ * @brief Calls a member function of the object
+ *
+ * Unlike variable the member_variable isn't type
+ * erased. Expressions built from it are one concrete
+ * type and the call of the member function inlines
+ * into the loop evaluating the expression. It converts
+ * to a variable when it must be stored.
+ */
+template < class R, class O >
+class member_variable
+{
+public:
+  typedef R return_type;                                /**< Shortcut for return type. */
+  typedef O object_type;                                /**< Shortcut for object type. */
+  typedef return_type (object_type::*memfunc_type)() const; /**< Shortcut for member function type. */
+
+  /**
+   * Creates a member_variable for
+   * the given member function.
+   *
+   * @param m The member function to call.
+   */
+  explicit member_variable(memfunc_type m)
+    : m_(m)
+  {}
+
+  /**
+   * Calls the member function of the
+   * object and returns the result.
+   *
+   * @param optr The serializable to apply the variable to.
+   * @return The value of the variable.
+   */
+  return_type operator()(const object_holder &optr) const
+  {
+    return evaluate(optr.ptr());
+  }
+
+  /**
+   * Calls the member function of the
+   * given object and returns the result.
+   *
+   * @param obj The object to apply the variable to.
+   * @return The value of the variable.
+   */
+  return_type evaluate(const void *obj) const
+  {
+    return (static_cast<const object_type*>(obj)->*m_)();
+  }
+
+  /**
+   * Returns the member function.
+   *
+   * @return The member function.
+   */
+  memfunc_type member() const
+  {
+    return m_;
+  }
+
+  /**
+   * A member_variable never refers
+   * to an attribute by name.
+   *
+   * @return Always nullptr
+   */
+  const char* attribute() const
+  {
+    return nullptr;
+  }
+
+private:
+  memfunc_type m_;
+};
+
 /**
  * @tparam R Type of the variable
  * @class variable
@@ -142,6 +283,18 @@ public:
     : impl_(impl)
   {}
 
+  /**
+   * Initializes a variable from the given
+   * member_variable to store it type erased.
+   *
+   * @tparam O The type of the object.
+   * @param x The member_variable to wrap.
+   */
+  template < class O >
+  variable(const member_variable<R, O> &x)
+    : impl_(new object_variable_impl<R, O, null_var>(x.member()))
+  {}
+
   /**
    * Copies from the given variable.
    * 
@@ -175,6 +328,30 @@ public:
   {
     return impl_->operator()(optr);
   }
+
+  /**
+   * Applies the variable to the given
+   * object and returns the result.
+   *
+   * @param obj The object to apply the variable to.
+   * @return The value of the variable.
+   */
+  return_type evaluate(const void *obj) const
+  {
+    return impl_->evaluate(obj);
+  }
+
+  /**
+   * Returns the name of the attribute if the
+   * variable was created from an attribute name,
+   * otherwise nullptr is returned.
+   *
+   * @return The name of the attribute or nullptr
+   */
+  const char* attribute() const
+  {
+    return impl_->attribute();
+  }
   
 private:
   std::shared_ptr<variable_impl<R> > impl_;
@@ -196,16 +373,18 @@ private:
   * @brief Create a variable with depth zero
   * 
   * Creates a variable with depth zero. That means that the
-  * value is inside the serializable itself.
+  * value is inside the serializable itself. The returned
+  * member_variable isn't type erased, it converts to
+  * variable<R> when it must be stored.
   * 
   * @param mem_func A member function of the object_type.
-  * @return A variable with return type R.
+  * @return A member_variable with return type R.
   */
 template < class R, class O >
-variable<R>
+member_variable<R, O>
 make_var(R (O::*mem_func)() const)
 {
-  return variable<R>(new object_variable_impl<R, O, null_var>(mem_func));
+  return member_variable<R, O>(mem_func);
 }
 
  /**
@@ -225,7 +404,7 @@ template < class R, class O, class O1 >
 variable<R>
 make_var(O1 (O::*mem_func)() const, R (O1::object_type::*mem_func_1)() const)
 {
-  return variable<R>(new object_variable_impl<R, typename O1::object_type, variable<O1> >(mem_func_1, make_var(mem_func)));
+  return variable<R>(new object_variable_impl<R, typename O1::object_type, variable<O1> >(mem_func_1, variable<O1>(make_var(mem_func))));
 }
 
  /**
@@ -274,6 +453,26 @@ make_var(O1 (O::*mem_func)() const, O2 (O1::object_type::*mem_func_1)() const, O
   return variable<R>(new object_variable_impl<R, typename O3::object_type, variable<O3> >(mem_func_3, make_var(mem_func, mem_func_1, mem_func_2)));
 }
 
+ /**
+  * @tparam R The attribute value type
+  * @tparam O The serializable type
+  * @brief Create a variable from an attribute name
+  *
+  * Creates a variable reading the attribute with the
+  * given name. Expressions on such a variable can be
+  * answered by an index on the attribute (see
+  * object_store::create_index).
+  *
+  * @param attribute The name of the attribute.
+  * @return A variable with return type R.
+  */
+template < class R, class O >
+variable<R>
+make_var(const char *attribute)
+{
+  return variable<R>(new attribute_variable_impl<R, O>(attribute));
+}
+
 /// @cond OOS_DEV
 
 template < class E >
@@ -319,16 +518,50 @@ struct expression_traits<oos::object_ptr<T> >
   typedef constant<optr_type> expression_type;
 };
 
+/*
+ * type erased expression, only used when an
+ * expression must be stored (see make_expression)
+ */
 class expression
 {
 public:
   virtual ~expression() {}
 
   virtual bool operator()(const object_holder &optr) const = 0;
+
+  virtual bool evaluate(const void *obj) const = 0;
 };
 
+template < class E >
+class stored_expression : public expression
+{
+public:
+  explicit stored_expression(const E &e)
+    : expr_(e)
+  {}
+
+  virtual bool operator()(const object_holder &optr) const
+  {
+    return expr_(optr);
+  }
+
+  virtual bool evaluate(const void *obj) const
+  {
+    return expr_.evaluate(obj);
+  }
+
+private:
+  E expr_;
+};
+
+/*
+ * The expression classes below aren't virtual,
+ * an expression tree is one concrete type. The
+ * object is looked up once per evaluation and
+ * passed down the tree.
+ */
 template < class L, class OP >
-class unary_expression : public expression
+class unary_expression
 {
 public:
   unary_expression(const L &l, OP op = OP())
@@ -337,9 +570,14 @@ public:
   {}
 
 
-  virtual bool operator()(const object_holder &optr) const
+  bool operator()(const object_holder &optr) const
+  {
+    return evaluate(optr.ptr());
+  }
+
+  bool evaluate(const void *obj) const
   {
-    return op_(left_(optr));
+    return op_(left_.evaluate(obj));
   }
 
 private:
@@ -347,8 +585,43 @@ private:
   OP op_;
 };
 
+/*
+ * applies the operator of a binary expression,
+ * logical operators skip the right operand
+ * like the built in operators
+ */
+template < class OP >
+struct binary_evaluator
+{
+  template < class L, class R >
+  static bool evaluate(const OP &op, const L &l, const R &r, const void *obj)
+  {
+    return op(l.evaluate(obj), r.evaluate(obj));
+  }
+};
+
+template <>
+struct binary_evaluator<std::logical_and<bool> >
+{
+  template < class L, class R >
+  static bool evaluate(const std::logical_and<bool> &, const L &l, const R &r, const void *obj)
+  {
+    return l.evaluate(obj) && r.evaluate(obj);
+  }
+};
+
+template <>
+struct binary_evaluator<std::logical_or<bool> >
+{
+  template < class L, class R >
+  static bool evaluate(const std::logical_or<bool> &, const L &l, const R &r, const void *obj)
+  {
+    return l.evaluate(obj) || r.evaluate(obj);
+  }
+};
+
 template < class L, class R, class OP >
-class binary_expression : public expression
+class binary_expression
 {
 public:
   binary_expression(const L &l, const R &r, OP op = OP())
@@ -357,11 +630,19 @@ public:
     , op_(op)
   {}
 
-  virtual bool operator()(const object_holder &optr) const
+  bool operator()(const object_holder &optr) const
+  {
+    return evaluate(optr.ptr());
+  }
+
+  bool evaluate(const void *obj) const
   {
-    return op_(left_(optr), right_(optr));
+    return binary_evaluator<OP>::evaluate(op_, left_, right_, obj);
   }
 
+  const typename expression_traits<L>::expression_type& left() const { return left_; }
+  const typename expression_traits<R>::expression_type& right() const { return right_; }
+
 private:
   typename expression_traits<L>::expression_type left_;
   typename expression_traits<R>::expression_type right_;
@@ -371,15 +652,44 @@ private:
 template < class L, class OP >
 expression* make_expression(const unary_expression<L, OP> &ue)
 {
-  return new unary_expression<L, OP>(ue);
+  return new stored_expression<unary_expression<L, OP> >(ue);
 }
 
 template < class L, class R, class OP >
 expression* make_expression(const binary_expression<L, R, OP> &be)
 {
-  return new binary_expression<L, R, OP>(be);
+  return new stored_expression<binary_expression<L, R, OP> >(be);
 }
 
+/*
+ * true for the variable types which
+ * can be compared with a value
+ */
+template < class V >
+struct is_variable : std::false_type {};
+
+template < class R >
+struct is_variable<variable<R> > : std::true_type {};
+
+template < class R, class O >
+struct is_variable<member_variable<R, O> > : std::true_type {};
+
+/*
+ * the comparison expression types of a variable,
+ * empty for all other types to take the comparison
+ * operators out of overload resolution
+ */
+template < class V, template < class > class OP, class Enable = void >
+struct variable_expression {};
+
+template < class V, template < class > class OP >
+struct variable_expression<V, OP, typename std::enable_if<is_variable<V>::value>::type>
+{
+  typedef typename V::return_type value_type;
+  typedef binary_expression<V, value_type, OP<value_type> > type;
+  typedef binary_expression<value_type, V, OP<value_type> > mirrored_type;
+};
+
 /**
  * this implements the greater
  * specialization for the binary
@@ -392,16 +702,16 @@ expression* make_expression(const binary_expression<L, R, OP> &be)
  * variable<string> > const char*
  * const char* > variable<string>
  */
-template < class T >
-binary_expression<variable<T>, T, std::greater<T> > operator>(const variable<T> &l, const T &r)
+template < class V >
+typename variable_expression<V, std::greater>::type operator>(const V &l, const typename variable_expression<V, std::greater>::value_type &r)
 {
-  return binary_expression<variable<T>, T, std::greater<T> >(l, r);
+  return typename variable_expression<V, std::greater>::type(l, r);
 }
 
-template < class T >
-binary_expression<T, variable<T>, std::greater<T> > operator>(const T &l, const variable<T> &r)
+template < class V >
+typename variable_expression<V, std::greater>::mirrored_type operator>(const typename variable_expression<V, std::greater>::value_type &l, const V &r)
 {
-  return binary_expression<T, variable<T>, std::greater<T> >(l, r);
+  return typename variable_expression<V, std::greater>::mirrored_type(l, r);
 }
 /*
 binary_expression<variable<std::string>, const char*, std::greater<std::string> > operator>(const variable<std::string> &l, const char *r)
@@ -426,16 +736,16 @@ binary_expression<const char*, variable<std::string>, std::greater<std::string>
  * variable<string> >= const char*
  * const char* >= variable<string>
  */
-template < class T >
-binary_expression<variable<T>, T, std::greater_equal<T> > operator>=(const variable<T> &l, const T &r)
+template < class V >
+typename variable_expression<V, std::greater_equal>::type operator>=(const V &l, const typename variable_expression<V, std::greater_equal>::value_type &r)
 {
-  return binary_expression<variable<T>, T, std::greater_equal<T> >(l, r);
+  return typename variable_expression<V, std::greater_equal>::type(l, r);
 }
 
-template < class T >
-binary_expression<T, variable<T>, std::greater_equal<T> > operator>=(const T &l, const variable<T> &r)
+template < class V >
+typename variable_expression<V, std::greater_equal>::mirrored_type operator>=(const typename variable_expression<V, std::greater_equal>::value_type &l, const V &r)
 {
-  return binary_expression<T, variable<T>, std::greater_equal<T> >(l, r);
+  return typename variable_expression<V, std::greater_equal>::mirrored_type(l, r);
 }
 /*
 binary_expression<variable<std::string>, const char*, std::greater_equal<std::string> > operator>=(const variable<std::string> &l, const char *r)
@@ -460,16 +770,16 @@ binary_expression<const char*, variable<std::string>, std::greater_equal<std::st
  * variable<string> < const char*
  * const char* < variable<string>
  */
-template < class T >
-binary_expression<variable<T>, T, std::less<T> > operator<(const variable<T> &l, const T &r)
+template < class V >
+typename variable_expression<V, std::less>::type operator<(const V &l, const typename variable_expression<V, std::less>::value_type &r)
 {
-  return binary_expression<variable<T>, T, std::less<T> >(l, r);
+  return typename variable_expression<V, std::less>::type(l, r);
 }
 
-template < class T >
-binary_expression<T, variable<T>, std::less<T> > operator<(const T &l, const variable<T> &r)
+template < class V >
+typename variable_expression<V, std::less>::mirrored_type operator<(const typename variable_expression<V, std::less>::value_type &l, const V &r)
 {
-  return binary_expression<T, variable<T>, std::less<T> >(l, r);
+  return typename variable_expression<V, std::less>::mirrored_type(l, r);
 }
 /*
 binary_expression<variable<std::string>, const char*, std::less<std::string> > operator<(const variable<std::string> &l, const char *r)
@@ -494,16 +804,16 @@ binary_expression<const char*, variable<std::string>, std::less<std::string> > o
  * variable<string> <= const char*
  * const char* <= variable<string>
  */
-template < class T >
-binary_expression<variable<T>, T, std::less_equal<T> > operator<=(const variable<T> &l, const T &r)
+template < class V >
+typename variable_expression<V, std::less_equal>::type operator<=(const V &l, const typename variable_expression<V, std::less_equal>::value_type &r)
 {
-  return binary_expression<variable<T>, T, std::less_equal<T> >(l, r);
+  return typename variable_expression<V, std::less_equal>::type(l, r);
 }
 
-template < class T >
-binary_expression<T, variable<T>, std::less_equal<T> > operator<=(const T &l, const variable<T> &r)
+template < class V >
+typename variable_expression<V, std::less_equal>::mirrored_type operator<=(const typename variable_expression<V, std::less_equal>::value_type &l, const V &r)
 {
-  return binary_expression<T, variable<T>, std::less_equal<T> >(l, r);
+  return typename variable_expression<V, std::less_equal>::mirrored_type(l, r);
 }
 /*
 binary_expression<variable<std::string>, const char*, std::less_equal<std::string> > operator<=(const variable<std::string> &l, const char *r)
@@ -528,16 +838,16 @@ binary_expression<const char*, variable<std::string>, std::less_equal<std::strin
  * variable<string> == const char*
  * const char* == variable<string>
  */
-template < class T >
-binary_expression<variable<T>, T, std::equal_to<T> > operator==(const variable<T> &l, const T &r)
+template < class V >
+typename variable_expression<V, std::equal_to>::type operator==(const V &l, const typename variable_expression<V, std::equal_to>::value_type &r)
 {
-  return binary_expression<variable<T>, T, std::equal_to<T> >(l, r);
+  return typename variable_expression<V, std::equal_to>::type(l, r);
 }
 
-template < class T >
-binary_expression<T, variable<T>, std::equal_to<T> > operator==(const T &l, const variable<T> &r)
+template < class V >
+typename variable_expression<V, std::equal_to>::mirrored_type operator==(const typename variable_expression<V, std::equal_to>::value_type &l, const V &r)
 {
-  return binary_expression<T, variable<T>, std::equal_to<T> >(l, r);
+  return typename variable_expression<V, std::equal_to>::mirrored_type(l, r);
 }
 /*
 binary_expression<variable<std::string>, const char*, std::equal_to<std::string> > operator==(const variable<std::string> &l, const char *r)
@@ -563,16 +873,16 @@ binary_expression<const char*, variable<std::string>, std::equal_to<std::string>
  * variable<string> != const char*
  * const char* != variable<string>
  */
-template < class T >
-binary_expression<variable<T>, T, std::not_equal_to<T> > operator!=(const variable<T> &l, const T &r)
+template < class V >
+typename variable_expression<V, std::not_equal_to>::type operator!=(const V &l, const typename variable_expression<V, std::not_equal_to>::value_type &r)
 {
-  return binary_expression<variable<T>, T, std::not_equal_to<T> >(l, r);
+  return typename variable_expression<V, std::not_equal_to>::type(l, r);
 }
 
-template < class T >
-binary_expression<T, variable<T>, std::not_equal_to<T> > operator!=(const T &l, const variable<T> &r)
+template < class V >
+typename variable_expression<V, std::not_equal_to>::mirrored_type operator!=(const typename variable_expression<V, std::not_equal_to>::value_type &l, const V &r)
 {
-  return binary_expression<T, variable<T>, std::not_equal_to<T> >(l, r);
+  return typename variable_expression<V, std::not_equal_to>::mirrored_type(l, r);
 }
 /*
 binary_expression<variable<std::string>, const char*, std::not_equal_to<std::string> > operator!=(const variable<std::string> &l, const char *r)
@@ -611,6 +921,131 @@ unary_expression<binary_expression<L, R, OP>, std::logical_not<bool> > operator!
   return unary_expression<binary_expression<L, R, OP>, std::logical_not<bool> >(l);
 }
 
+namespace detail {
+
+/*
+ * index lookups for comparisons of an
+ * attribute variable with a constant
+ * "attribute OP value"
+ */
+template < class OP >
+struct index_bound
+{
+  template < class T >
+  static bool lookup(object_index<T> &, const T &, std::vector<object_proxy*> &) { return false; }
+};
+
+template < class T >
+struct index_bound<std::equal_to<T> >
+{
+  static bool lookup(object_index<T> &index, const T &value, std::vector<object_proxy*> &result)
+  {
+    index.find(value, result);
+    return true;
+  }
+};
+
+template < class T >
+struct index_bound<std::less<T> >
+{
+  static bool lookup(object_index<T> &index, const T &value, std::vector<object_proxy*> &result)
+  {
+    return index.find_range(nullptr, false, &value, false, result);
+  }
+};
+
+template < class T >
+struct index_bound<std::less_equal<T> >
+{
+  static bool lookup(object_index<T> &index, const T &value, std::vector<object_proxy*> &result)
+  {
+    return index.find_range(nullptr, false, &value, true, result);
+  }
+};
+
+template < class T >
+struct index_bound<std::greater<T> >
+{
+  static bool lookup(object_index<T> &index, const T &value, std::vector<object_proxy*> &result)
+  {
+    return index.find_range(&value, false, nullptr, false, result);
+  }
+};
+
+template < class T >
+struct index_bound<std::greater_equal<T> >
+{
+  static bool lookup(object_index<T> &index, const T &value, std::vector<object_proxy*> &result)
+  {
+    return index.find_range(&value, true, nullptr, false, result);
+  }
+};
+
+/*
+ * turns "value OP attribute"
+ * into "attribute OP value"
+ */
+template < class OP > struct mirrored_operator { typedef OP type; };
+template < class T > struct mirrored_operator<std::less<T> > { typedef std::greater<T> type; };
+template < class T > struct mirrored_operator<std::less_equal<T> > { typedef std::greater_equal<T> type; };
+template < class T > struct mirrored_operator<std::greater<T> > { typedef std::less<T> type; };
+template < class T > struct mirrored_operator<std::greater_equal<T> > { typedef std::less_equal<T> type; };
+
+template < class OP, class T >
+bool lookup_attribute(const prototype_node *node, const variable<T> &var, const T &value, std::vector<object_proxy*> &result)
+{
+  if (var.attribute() == nullptr) {
+    return false;
+  }
+  object_index<T> *index = dynamic_cast<object_index<T>*>(node->find_index(var.attribute()));
+  if (index == nullptr) {
+    return false;
+  }
+  return index_bound<OP>::lookup(*index, value, result);
+}
+
+/**
+ * Tries to answer the given expression by an attribute
+ * index of the given node. On success the candidate
+ * proxies are appended to result and true is returned.
+ * The candidates must still be checked against the
+ * expression. If the expression can't be answered by
+ * an index false is returned.
+ *
+ * @param node The prototype node of the objects
+ * @param expr The expression to answer
+ * @param result The candidate proxies
+ * @return True if an index was used
+ */
+template < class E >
+bool index_lookup(const prototype_node *, const E &, std::vector<object_proxy*> &)
+{
+  return false;
+}
+
+template < class T, class OP >
+bool index_lookup(const prototype_node *node, const binary_expression<variable<T>, T, OP> &expr, std::vector<object_proxy*> &result)
+{
+  return lookup_attribute<OP>(node, expr.left(), expr.right().value(), result);
+}
+
+template < class T, class OP >
+bool index_lookup(const prototype_node *node, const binary_expression<T, variable<T>, OP> &expr, std::vector<object_proxy*> &result)
+{
+  return lookup_attribute<typename mirrored_operator<OP>::type>(node, expr.right(), expr.left().value(), result);
+}
+
+template < class L1, class R1, class OP1, class L2, class R2, class OP2 >
+bool index_lookup(const prototype_node *node,
+                  const binary_expression<binary_expression<L1, R1, OP1>, binary_expression<L2, R2, OP2>, std::logical_and<bool> > &expr,
+                  std::vector<object_proxy*> &result)
+{
+  // one indexed operand is enough to narrow the candidates
+  return index_lookup(node, expr.left(), result) || index_lookup(node, expr.right(), result);
+}
+
+}
+
 /// @endcond
 
 }
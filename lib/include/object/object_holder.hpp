@@ -262,6 +262,10 @@ private:
   bool is_internal_ = false;
   bool is_inserted_ = false;
   unsigned long oid_ = 0;
+
+  // links of the intrusive holder list owned by the proxy
+  object_holder *prev_holder_ = nullptr;
+  object_holder *next_holder_ = nullptr;
 };
 
 }
@@ -0,0 +1,390 @@
+#ifndef OOS_OBJECT_INDEX_HPP
+#define OOS_OBJECT_INDEX_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace oos {
+
+class object_proxy;
+
+/**
+ * @brief Kind of a secondary attribute index
+ *
+ * A hash index answers equality lookups, an ordered
+ * index answers equality and range lookups.
+ */
+enum class index_type
+{
+  HASH,   /**< Index backed by a hash map */
+  ORDERED /**< Index backed by an ordered map */
+};
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * @class basic_object_index
+ * @brief Untyped secondary index over one attribute
+ *
+ * The index is owned by a prototype_node and covers
+ * all objects of the node and its child nodes. Inserted
+ * and modified proxies are only marked and reindexed
+ * on the next lookup, so an object may still be changed
+ * (i.e. deserialized on restore) after it was marked.
+ *
+ * Reader threads may mark and look up proxies at the
+ * same time, so all public operations are serialized
+ * by a mutex.
+ *
+ * While the store allows concurrent reads a writer may
+ * change a marked object at any time, so lookups can't
+ * read it. The reindexing is deferred then and the
+ * store calls sync() while it holds its lock exclusively.
+ */
+class OOS_API basic_object_index
+{
+public:
+  basic_object_index(const char *attribute, index_type type);
+  virtual ~basic_object_index();
+
+  basic_object_index(const basic_object_index&) = delete;
+  basic_object_index& operator=(const basic_object_index&) = delete;
+
+  /**
+   * Returns the name of the indexed attribute.
+   *
+   * @return The name of the indexed attribute
+   */
+  const char* attribute() const;
+
+  /**
+   * Returns the kind of the index.
+   *
+   * @return The kind of the index
+   */
+  index_type type() const;
+
+  /**
+   * Adds a proxy to the index.
+   *
+   * @param proxy The proxy to add
+   */
+  void insert(object_proxy *proxy);
+
+  /**
+   * Removes a proxy from the index.
+   *
+   * @param proxy The proxy to remove
+   */
+  void remove(object_proxy *proxy);
+
+  /**
+   * Marks the attribute value of the
+   * given proxy as possibly changed.
+   *
+   * @param proxy The modified proxy
+   */
+  void mark_modified(object_proxy *proxy);
+
+  /**
+   * Returns true if the given proxy is marked
+   * and wasn't reindexed yet.
+   *
+   * @param proxy The proxy to check
+   * @return True if the proxy is marked
+   */
+  bool is_marked(object_proxy *proxy);
+
+  /**
+   * Removes all proxies from the index.
+   */
+  void clear();
+
+  /**
+   * Returns the number of indexed proxies.
+   *
+   * @return The number of indexed proxies
+   */
+  std::size_t size();
+
+  /**
+   * Defers the reindexing of marked proxies. If
+   * set lookups only see the state of the last
+   * call to sync().
+   *
+   * @param defer True to defer the reindexing
+   */
+  void defer(bool defer);
+
+  /**
+   * Fetches and reindexes all marked proxies,
+   * even if the reindexing is deferred. No object
+   * of the index may be modified meanwhile.
+   */
+  void sync();
+
+protected:
+  /**
+   * Fetches the objects of all marked proxies
+   * which aren't loaded yet (i.e. keys only proxies
+   * of a lazy session) through their loader. The
+   * caller must not hold the index mutex because
+   * loading an object marks its proxy again.
+   * Does nothing if the reindexing is deferred.
+   */
+  void fetch_marked();
+
+  /**
+   * Reindexes all marked proxies unless the
+   * reindexing is deferred. The caller must
+   * hold the index mutex.
+   */
+  void refresh();
+
+  /**
+   * Returns the object of the given proxy.
+   *
+   * @param proxy The proxy
+   * @return The object or nullptr
+   */
+  static void* object(object_proxy *proxy);
+
+  /**
+   * Inserts the entry of the given proxy or moves
+   * it if the attribute value changed. An entry with
+   * an unchanged value is kept in place, so iterators
+   * of the index stay valid.
+   *
+   * @param proxy The proxy to update
+   */
+  virtual void update_entry(object_proxy *proxy) = 0;
+  virtual void erase_entry(object_proxy *proxy) = 0;
+  virtual void clear_entries() = 0;
+  virtual std::size_t entry_count() const = 0;
+
+protected:
+  std::mutex mutex_;
+
+private:
+  void fetch_unloaded();
+  void reindex();
+
+private:
+  std::string attribute_;
+  index_type type_;
+
+  std::unordered_set<object_proxy*> dirty_;
+  std::atomic<bool> deferred_{false};
+};
+
+/**
+ * @class object_index
+ * @brief Secondary index for attribute values of type V
+ *
+ * Depending on the index_type the values are kept
+ * in a hash map or in an ordered map. The value of
+ * each proxy is remembered to be able to remove the
+ * entry once the proxy is removed or modified.
+ *
+ * @tparam V The type of the attribute value
+ */
+template < class V >
+class object_index : public basic_object_index
+{
+public:
+  typedef std::unordered_multimap<V, object_proxy*> t_hash_map;   /**< Shortcut for the hash map */
+  typedef std::multimap<V, object_proxy*> t_ordered_map;          /**< Shortcut for the ordered map */
+  typedef std::unordered_map<object_proxy*, V> t_value_map;       /**< Shortcut for the proxy value map */
+  typedef std::shared_ptr<const t_ordered_map> t_ordered_map_ptr; /**< Shortcut for a shared copy of the ordered map */
+
+  object_index(const char *attribute, index_type type)
+    : basic_object_index(attribute, type)
+  {}
+
+  /**
+   * Appends all proxies with the
+   * given attribute value to result.
+   *
+   * @param value The value to look for
+   * @param result The resulting proxies
+   */
+  void find(const V &value, std::vector<object_proxy*> &result)
+  {
+    fetch_marked();
+    std::lock_guard<std::mutex> guard(mutex_);
+    refresh();
+    if (type() == index_type::HASH) {
+      auto range = hash_map_.equal_range(value);
+      for (auto i = range.first; i != range.second; ++i) {
+        result.push_back(i->second);
+      }
+    } else {
+      auto range = ordered_map_.equal_range(value);
+      for (auto i = range.first; i != range.second; ++i) {
+        result.push_back(i->second);
+      }
+    }
+  }
+
+  /**
+   * Appends all proxies with an attribute value
+   * within the given bounds to result in ascending
+   * order. A missing bound is passed as nullptr.
+   * Ranges can only be answered by an ordered index.
+   *
+   * @param lower The lower bound or nullptr
+   * @param lower_inclusive True if the lower bound is part of the range
+   * @param upper The upper bound or nullptr
+   * @param upper_inclusive True if the upper bound is part of the range
+   * @param result The resulting proxies
+   * @return False if the index is a hash index
+   */
+  bool find_range(const V *lower, bool lower_inclusive, const V *upper, bool upper_inclusive, std::vector<object_proxy*> &result)
+  {
+    if (type() != index_type::ORDERED) {
+      return false;
+    }
+    fetch_marked();
+    std::lock_guard<std::mutex> guard(mutex_);
+    refresh();
+    typename t_ordered_map::const_iterator first = ordered_map_.begin();
+    if (lower) {
+      first = lower_inclusive ? ordered_map_.lower_bound(*lower) : ordered_map_.upper_bound(*lower);
+    }
+    for (; first != ordered_map_.end(); ++first) {
+      if (upper && (upper_inclusive ? *upper < first->first : !(first->first < *upper))) {
+        break;
+      }
+      result.push_back(first->second);
+    }
+    return true;
+  }
+
+  /**
+   * Applies pending modifications and returns a
+   * copy of the ordered map of the index. The map is
+   * only filled for an ordered index. The copy is
+   * shared until the index changes, so it stays valid
+   * while the index is modified by other threads.
+   *
+   * @return A copy of the ordered map of the index
+   */
+  t_ordered_map_ptr ordered_map()
+  {
+    fetch_marked();
+    std::lock_guard<std::mutex> guard(mutex_);
+    refresh();
+    if (!ordered_copy_) {
+      ordered_copy_ = std::make_shared<const t_ordered_map>(ordered_map_);
+    }
+    return ordered_copy_;
+  }
+
+protected:
+  /**
+   * Reads the attribute value of the given proxy.
+   *
+   * @param proxy The proxy to read from
+   * @param value The read value
+   * @return True if the attribute could be read
+   */
+  virtual bool read(object_proxy *proxy, V &value) const = 0;
+
+  virtual void update_entry(object_proxy *proxy)
+  {
+    V value;
+    if (!read(proxy, value)) {
+      erase_entry(proxy);
+      return;
+    }
+    typename t_value_map::iterator i = values_.find(proxy);
+    if (i != values_.end()) {
+      if (i->second == value) {
+        return;
+      }
+      erase_entry(proxy);
+    }
+    if (type() == index_type::HASH) {
+      hash_map_.insert(std::make_pair(value, proxy));
+    } else {
+      ordered_map_.insert(std::make_pair(value, proxy));
+      ordered_copy_.reset();
+    }
+    values_.insert(std::make_pair(proxy, value));
+  }
+
+  virtual void erase_entry(object_proxy *proxy)
+  {
+    typename t_value_map::iterator i = values_.find(proxy);
+    if (i == values_.end()) {
+      return;
+    }
+    if (type() == index_type::HASH) {
+      erase_from(hash_map_, i->second, proxy);
+    } else {
+      erase_from(ordered_map_, i->second, proxy);
+      ordered_copy_.reset();
+    }
+    values_.erase(i);
+  }
+
+  virtual void clear_entries()
+  {
+    hash_map_.clear();
+    ordered_map_.clear();
+    ordered_copy_.reset();
+    values_.clear();
+  }
+
+  virtual std::size_t entry_count() const
+  {
+    return values_.size();
+  }
+
+private:
+  template < class M >
+  static void erase_from(M &map, const V &value, object_proxy *proxy)
+  {
+    auto range = map.equal_range(value);
+    for (auto i = range.first; i != range.second; ++i) {
+      if (i->second == proxy) {
+        map.erase(i);
+        return;
+      }
+    }
+  }
+
+private:
+  t_hash_map hash_map_;
+  t_ordered_map ordered_map_;
+  t_ordered_map_ptr ordered_copy_;
+  t_value_map values_;
+};
+
+/// @endcond
+
+}
+}
+
+#endif //OOS_OBJECT_INDEX_HPP
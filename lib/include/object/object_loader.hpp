@@ -0,0 +1,55 @@
+#ifndef OOS_OBJECT_LOADER_HPP
+#define OOS_OBJECT_LOADER_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
+namespace oos {
+
+class object_proxy;
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * @class object_loader
+ * @brief Fetches objects which aren't loaded yet
+ *
+ * A loader can be set for a prototype_node. When an
+ * object_ptr or has_one is dereferenced and its proxy
+ * holds only a primary key, the loader of the proxies
+ * node is asked to fetch the object (i.e. from a
+ * database table).
+ */
+class OOS_API object_loader
+{
+public:
+  virtual ~object_loader() {}
+
+  /**
+   * Fetches the object of the given proxy and
+   * hands it to the object_store (see object_store::load).
+   *
+   * @param proxy The proxy without an object
+   * @return True if the object could be fetched
+   */
+  virtual bool fetch(object_proxy *proxy) = 0;
+};
+
+/// @endcond
+
+}
+}
+
+#endif //OOS_OBJECT_LOADER_HPP
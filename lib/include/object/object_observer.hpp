@@ -18,6 +18,8 @@
 #ifndef OBJECT_OBSERVER_HPP
 #define OBJECT_OBSERVER_HPP
 
+#include <cstddef>
+
 namespace oos {
 
 class serializer;
@@ -68,6 +70,49 @@ public:
   virtual void on_delete(object_proxy *proxy) = 0;
 };
 
+/**
+ * @class object_batch_observer
+ * @brief Base class for observers receiving batches
+ *
+ * A batch observer is notified with contiguous spans
+ * of proxies. Within a transaction all changes are
+ * reported at commit, a bulk insert is reported with
+ * one span. Single changes outside of a transaction
+ * are reported as spans of one proxy.
+ *
+ * The spans are only valid during the call. Deleted
+ * proxies are reported before they are destroyed.
+ */
+class OOS_API object_batch_observer
+{
+public:
+  virtual ~object_batch_observer() {}
+
+  /**
+   * @brief Called on insertion of objects.
+   *
+   * @param proxies The proxies of the inserted objects.
+   * @param count The number of proxies.
+   */
+  virtual void on_insert(object_proxy *const *proxies, std::size_t count) = 0;
+
+  /**
+   * @brief Called on update of objects.
+   *
+   * @param proxies The proxies of the updated objects.
+   * @param count The number of proxies.
+   */
+  virtual void on_update(object_proxy *const *proxies, std::size_t count) = 0;
+
+  /**
+   * @brief Called on deletion of objects.
+   *
+   * @param proxies The proxies of the deleted objects.
+   * @param count The number of proxies.
+   */
+  virtual void on_delete(object_proxy *const *proxies, std::size_t count) = 0;
+};
+
 }
 
 #endif /* OBJECT_OBSERVER_HPP */
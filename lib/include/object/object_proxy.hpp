@@ -35,8 +35,8 @@
 
 #include "object/prototype_node.hpp"
 
+#include <atomic>
 #include <ostream>
-#include <set>
 #include <list>
 
 #include <map>
@@ -50,6 +50,12 @@ class prototype_node;
 class basic_identifier;
 class transaction;
 
+namespace detail {
+class object_proxy_pool;
+class snapshot_data;
+class snapshot_registry;
+}
+
 /**
  * @cond OOS_DEV
  * @class object_proxy
@@ -145,7 +151,7 @@ public:
   template < typename T = void >
   T* obj()
   {
-    return static_cast<T*>(obj_);
+    return static_cast<T*>(obj_.load(std::memory_order_acquire));
   }
 
   /**
@@ -157,9 +163,66 @@ public:
   template < typename T = void >
   const T* obj() const
   {
-    return static_cast<const T*>(obj_);
+    return static_cast<const T*>(obj_.load(std::memory_order_acquire));
   }
 
+  /**
+   * Returns the underlaying object. If the object
+   * isn't loaded yet but the proxy holds a primary
+   * key, the object is fetched through the loader of
+   * the prototype node first (see prototype_node::loader).
+   *
+   * Fetches of reader threads are serialized by the
+   * loader, so an object is fetched once. It is
+   * published to other threads after it was completely
+   * initialized. If the prototype node records accesses
+   * for an eviction policy, each call marks the object
+   * as accessed (see accessed()).
+   *
+   * @return The underlaying object or nullptr
+   */
+  void* fetch();
+
+  /**
+   * Returns true if the object was accessed through
+   * fetch() since the flag was last cleared.
+   *
+   * @return True if the object was accessed
+   */
+  bool accessed() const;
+
+  /**
+   * Sets or clears the access flag.
+   *
+   * @param a The new value of the access flag
+   */
+  void accessed(bool a);
+
+  /**
+   * Counts a change of the object which
+   * isn't written to the database yet.
+   */
+  void mark_changed();
+
+  /**
+   * Returns the number of changes of the object
+   * which weren't written to the database yet.
+   * Zero means the object equals its database row.
+   *
+   * @return The number of unwritten changes
+   */
+  unsigned long changes() const;
+
+  /**
+   * Marks the changes of the object as written once
+   * they are durable. If the object was changed again
+   * meanwhile (i.e. the given count of changes doesn't
+   * match anymore), the object stays changed.
+   *
+   * @param changes The count of changes when the object was written
+   */
+  void mark_written(unsigned long changes);
+
   /**
    * Return the underlaying object store
    *
@@ -343,15 +406,19 @@ public:
 private:
   transaction current_transaction();
   bool has_transaction() const;
+  detail::snapshot_registry* snapshots() const;
 
 private:
   friend class object_store;
+  friend class transaction;
   friend class prototype_node;
   friend class prototype_tree;
   template < class T > friend class result;
   friend class table_reader;
   friend class restore_visitor;
   friend class object_holder;
+  friend class detail::object_proxy_pool;
+  friend class detail::snapshot_data;
   template < class T > friend class object_ptr;
   template < class T > friend class has_one;
 
@@ -373,19 +440,23 @@ private:
   object_proxy *prev_ = nullptr;      /**< The previous object_proxy in the list. */
   object_proxy *next_ = nullptr;      /**< The next object_proxy in the list. */
 
-  void *obj_ = nullptr;         /**< The concrete object. */
+  std::atomic<void*> obj_{nullptr}; /**< The concrete object, published to reader threads once it is complete. */
   deleter deleter_;             /**< The object deleter function */
   namer namer_;                 /**< The object classname function */
   unsigned long oid = 0;        /**< The id of the concrete or expected object. */
 
 
   unsigned long reference_counter_ = 0;
+  unsigned long version_ = 0;   /**< The insert version of the store when the proxy was inserted. */
 
   object_store *ostore_ = nullptr;    /**< The object_store to which the object_proxy belongs. */
   prototype_node *node_ = nullptr;    /**< The prototype_node containing the type of the object. */
 
-  typedef std::set<object_holder *> ptr_set_t; /**< Shortcut to the object_base_ptr_set. */
-  ptr_set_t ptr_set_;      /**< This set contains every object_holder pointing to this object_proxy. */
+  object_holder *holders_ = nullptr; /**< Head of the intrusive list of every object_holder pointing to this object_proxy. */
+  std::atomic_flag holders_lock_ = ATOMIC_FLAG_INIT; /**< Guards the holder list against concurrent readers. */
+  std::atomic<bool> accessed_{false};                 /**< Set on each access of the object through fetch(). */
+  std::atomic<unsigned long> changes_{0};             /**< The count of changes not written to the database. */
+  bool pooled_ = false;                               /**< True if the proxy lives in an object_proxy_pool. */
   
   std::shared_ptr<basic_identifier> primary_key_ = nullptr;
 };
@@ -0,0 +1,194 @@
+#ifndef OOS_OBJECT_PROXY_POOL_HPP
+#define OOS_OBJECT_PROXY_POOL_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
+#include "object/object_proxy.hpp"
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace oos {
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * @class object_proxy_pool
+ * @brief Slab allocator for object_proxy instances
+ *
+ * The pool hands out object_proxy sized slots from
+ * contiguous slabs. Freed slots are recycled through
+ * a free list.
+ *
+ * A slab consists of pages aligned to their size. Each
+ * page starts with a header holding the owning pool, so
+ * the pool of a slot is found by masking its address and
+ * the slots themselves carry no header. Proxies created
+ * outside of an object_store are allocated with plain new.
+ * A proxy remembers if it was taken from a pool, so
+ * destroy() hands it back to the right allocator.
+ */
+class OOS_API object_proxy_pool
+{
+public:
+  static const std::size_t default_slab_size = 1024; /**< Default number of slots per slab */
+
+  /**
+   * Creates an empty pool. No slab is allocated
+   * until the first slot is requested. The slab
+   * size is rounded up to whole pages.
+   *
+   * @param slab_size Minimum number of slots per slab
+   */
+  explicit object_proxy_pool(std::size_t slab_size = default_slab_size);
+  ~object_proxy_pool();
+
+  object_proxy_pool(const object_proxy_pool&) = delete;
+  object_proxy_pool& operator=(const object_proxy_pool&) = delete;
+
+  /**
+   * Constructs an object_proxy in a slot of the pool.
+   *
+   * @tparam Args The types of the constructor arguments
+   * @param args The constructor arguments
+   * @return The new object_proxy
+   */
+  template < typename ... Args >
+  object_proxy* create(Args&&... args)
+  {
+    void *slot = allocate();
+    object_proxy *proxy = nullptr;
+    try {
+      proxy = ::new (slot) object_proxy(std::forward<Args>(args)...);
+    } catch (...) {
+      release(slot);
+      throw;
+    }
+    proxy->pooled_ = true;
+    return proxy;
+  }
+
+  /**
+   * Destroys the given object_proxy and returns
+   * its slot to its pool. Proxies which weren't
+   * taken from a pool are deleted.
+   *
+   * @param proxy The object_proxy to destroy
+   */
+  static void destroy(object_proxy *proxy);
+
+  /**
+   * Destroys the given object_proxy but keeps the
+   * slot of a pooled proxy in use. The slots are
+   * dropped with clear() once all proxies of the
+   * pool are disposed. Proxies which weren't taken
+   * from a pool are deleted.
+   *
+   * @param proxy The object_proxy to dispose
+   */
+  static void dispose(object_proxy *proxy);
+
+  /**
+   * Releases all slabs at once. All proxies of
+   * the pool must be disposed before, their slots
+   * aren't returned one by one.
+   */
+  void clear();
+
+  /**
+   * Returns the number of slots in use.
+   *
+   * @return Number of slots in use
+   */
+  std::size_t size() const;
+
+  /**
+   * Returns the number of slots of all slabs.
+   *
+   * @return Number of available slots
+   */
+  std::size_t capacity() const;
+
+  /**
+   * Returns the number of allocated slabs.
+   *
+   * @return Number of slabs
+   */
+  std::size_t slab_count() const;
+
+  /**
+   * Returns the number of slots per slab.
+   *
+   * @return Number of slots per slab
+   */
+  std::size_t slab_size() const;
+
+  /**
+   * Size and alignment of a page in bytes.
+   */
+  static const std::size_t page_size = 64 * 1024;
+
+private:
+  struct page_header
+  {
+    object_proxy_pool *pool;
+  };
+
+  struct free_slot
+  {
+    free_slot *next;
+  };
+
+  static page_header* header(void *p);
+
+  void* allocate();
+  void release(void *p);
+  void next_page();
+  void add_slab();
+
+private:
+  std::size_t pages_per_slab_;
+  std::size_t slab_size_;
+  std::size_t size_ = 0;
+
+  std::vector<char*> slabs_;
+
+  char *cursor_ = nullptr;
+  char *cursor_end_ = nullptr;
+  char *next_page_ = nullptr;
+  char *slab_end_ = nullptr;
+  free_slot *free_list_ = nullptr;
+};
+
+/**
+ * @brief Deleter for object_proxy instances of a pool
+ */
+struct object_proxy_deleter
+{
+  void operator()(object_proxy *proxy) const
+  {
+    object_proxy_pool::destroy(proxy);
+  }
+};
+
+/// @endcond
+
+}
+}
+
+#endif //OOS_OBJECT_PROXY_POOL_HPP
@@ -79,12 +79,12 @@ public:
 
   T* get()
   {
-    return static_cast<T*>(proxy_->obj());
+    return static_cast<T*>(proxy_->fetch());
   }
 
   const T* get() const
   {
-    return static_cast<T*>(proxy_->obj());
+    return static_cast<T*>(proxy_->fetch());
   }
 
   /**
@@ -283,7 +283,7 @@ public:
    * @return The pointer to the serializable of type T.
    */
   T* get() {
-    if (proxy_ && proxy_->obj()) {
+    if (proxy_ && proxy_->fetch()) {
       if (proxy_->ostore_ && proxy_->has_transaction()) {
         proxy_->current_transaction().on_update<T>(proxy_);
       }
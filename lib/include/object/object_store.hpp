@@ -21,12 +21,18 @@
 #include "object/prototype_iterator.hpp"
 #include "object/object_exception.hpp"
 #include "object/object_observer.hpp"
+#include "object/object_proxy_pool.hpp"
+#include "object/attribute_index.hpp"
 #include "object/has_one.hpp"
 #include "object/object_serializer.hpp"
 #include "object/basic_has_many.hpp"
 #include "object/transaction.hpp"
+#include "object/snapshot.hpp"
+#include "object/store_stats.hpp"
 
 #include "tools/sequencer.hpp"
+#include "tools/flat_hash_map.hpp"
+#include "tools/rw_lock.hpp"
 #include "tools/identifier_setter.hpp"
 
 #include <memory>
@@ -37,6 +43,7 @@
 #include <string>
 #include <ostream>
 #include <list>
+#include <vector>
 #include <iostream>
 
 #ifdef _MSC_VER
@@ -61,6 +68,32 @@ class prototype_node;
 
 namespace detail {
 
+/**
+ * Returns the next free type slot.
+ *
+ * @return The next free type slot
+ */
+OOS_API std::size_t next_type_slot();
+
+/**
+ * @brief Process wide integer slot of a type
+ *
+ * Every type gets its slot on first use. An object_store
+ * keeps its prototype nodes in a vector indexed by the
+ * slot, so a node is found without hashing the typeid name.
+ *
+ * @tparam T The type
+ */
+template < class T >
+struct type_slot
+{
+  static std::size_t index()
+  {
+    static const std::size_t slot = next_type_slot();
+    return slot;
+  }
+};
+
 class OOS_API modified_marker
 {
 public:
@@ -176,6 +209,8 @@ private:
     object_proxy *proxy;
     unsigned long reference_counter;
     bool ignore;
+    // the relations of the object were already collected
+    bool traversed = false;
 
     t_remove_func remove_func;
   };
@@ -204,6 +239,20 @@ public:
   template<class T>
   bool is_deletable(object_proxy *proxy, T *o);
 
+  /**
+   * Checks wether all objects of the given proxies
+   * are deletable at once. The reference counts and
+   * cascades of all objects are collected in one pass,
+   * so references between the given objects don't
+   * prevent their deletion. Objects which can't be
+   * fetched aren't deletable.
+   *
+   * @param proxies The proxies to be checked.
+   * @return True if all objects could be deleted.
+   */
+  template<class T>
+  bool is_deletable(const std::vector<object_proxy*> &proxies);
+
   /**
    * Checks wether the given object_container is deletable.
    *
@@ -356,6 +405,22 @@ public:
   template<class T, class S, template < class ... > class ON_ATTACH = detail::null_on_attach, typename = typename std::enable_if<std::is_base_of<detail::basic_on_attach, ON_ATTACH<T>>::value>::type >
   prototype_iterator attach(const char *type, bool abstract = false, const ON_ATTACH<T> &on_attach = ON_ATTACH<T>());
 
+  /**
+   * Inserts a new object prototype into the prototype tree
+   * with pooled storage. The prototype_node owns a chunked
+   * arena in which all objects created with emplace()
+   * are constructed in place.
+   *
+   * @tparam T       The type of the prototype node
+   * @param type     The unique name of the type.
+   * @param storage  The pooled storage policy.
+   * @param abstract Indicates if the producers serializable is treated as an abstract node.
+   * @param parent   The name of the parent type.
+   * @return         Returns new inserted prototype iterator.
+   */
+  template< class T, template < class ... > class ON_ATTACH = detail::null_on_attach, typename = typename std::enable_if<std::is_base_of<detail::basic_on_attach, ON_ATTACH<T>>::value>::type >
+  prototype_iterator attach(const char *type, const pooled_storage &storage, bool abstract = false, const char *parent = nullptr, const ON_ATTACH<T> &on_attach = ON_ATTACH<T>());
+
   /**
    * Inserts a new object prototype into the prototype tree. The prototype
    * constist of a unique type name (generated from typeid). To know where the new
@@ -458,7 +523,8 @@ public:
   template<class T>
   iterator find()
   {
-    return find(typeid(T).name());
+    prototype_node *node = find_prototype_node<T>();
+    return node ? iterator(node) : end();
   }
 
   /**
@@ -474,7 +540,8 @@ public:
   template<class T>
   const_iterator find() const
   {
-    return find(typeid(T).name());
+    prototype_node *node = find_prototype_node<T>();
+    return node ? const_iterator(node) : end();
   }
 
   /**
@@ -544,6 +611,78 @@ public:
    */
   bool empty() const;
 
+  /**
+   * Reserves room for count objects in addition
+   * to the objects already in the store. Inserting
+   * these objects won't rehash the id lookup map.
+   *
+   * @param count Number of objects to reserve room for
+   */
+  void reserve(std::size_t count);
+
+  /**
+   * Creates a secondary index on the given attribute
+   * of type T. The index covers all objects of type T
+   * and its child types and is kept up to date on
+   * insert, modification, removal and rollback.
+   * Expressions on the attribute passed to
+   * object_view::select are answered by the index.
+   *
+   * A hash index answers equality lookups, an ordered
+   * index answers equality and range lookups.
+   *
+   * @tparam T The object type
+   * @param attribute The name of the attribute
+   * @param type The kind of the index
+   * @throws oos::object_exception if the type is unknown, the index
+   *         already exists or the attribute can't be indexed
+   */
+  template < class T >
+  void create_index(const char *attribute, index_type type = index_type::HASH)
+  {
+    prototype_node *node = find_prototype_node<T>();
+    if (node == nullptr) {
+      throw object_exception("unknown object type");
+    }
+    for (auto &index : node->indexes_) {
+      if (index->attribute() == std::string(attribute)) {
+        throw object_exception("index already exists");
+      }
+    }
+    std::unique_ptr<detail::basic_object_index> index(detail::index_builder<T>(attribute, type).build());
+    detail::write_guard guard(*this);
+    index->defer(concurrent_reads_);
+    // add all existing objects of the node and its children
+    for (object_proxy *proxy = node->op_first->next(); proxy != node->op_last; proxy = proxy->next()) {
+      index->insert(proxy);
+    }
+    node->indexes_.push_back(std::move(index));
+  }
+
+  /**
+   * Removes the index on the given attribute of type T.
+   *
+   * @tparam T The object type
+   * @param attribute The name of the attribute
+   * @return True if an index was removed
+   */
+  template < class T >
+  bool drop_index(const char *attribute)
+  {
+    prototype_node *node = find_prototype_node<T>();
+    if (node == nullptr) {
+      return false;
+    }
+    detail::write_guard guard(*this);
+    for (prototype_node::t_index_vector::iterator i = node->indexes_.begin(); i != node->indexes_.end(); ++i) {
+      if ((*i)->attribute() == std::string(attribute)) {
+        node->indexes_.erase(i);
+        return true;
+      }
+    }
+    return false;
+  }
+
   size_t depth(const prototype_node *node) const;
 
   void dump(std::ostream &out) const;
@@ -590,6 +729,11 @@ public:
   /**
    * @brief Inserts a new proxy into the object store
    *
+   * A proxy holding only a primary key may be inserted
+   * without its object. The object is fetched on first
+   * access through the loader of the prototype node
+   * (see prototype_node::loader).
+   *
    * @param oproxy Object proxy to insert
    * @param notify Indicates wether all observers should be notified.
    * @param is_new Proxy is a new not inserted proxy, skip object store check
@@ -600,7 +744,7 @@ public:
     if (proxy == nullptr) {
       throw object_exception("proxy is null");
     }
-    if (proxy->obj() == nullptr) {
+    if (proxy->obj() == nullptr && !proxy->has_identifier()) {
       throw object_exception("object is null");
     }
     iterator node = find(proxy->classname());
@@ -616,6 +760,7 @@ public:
       throw object_exception("object has id but doesn't belong to a store");
     }
 
+    detail::write_guard guard(*this);
     proxy->id(seq_.next());
     proxy->ostore_ = this;
 
@@ -627,6 +772,11 @@ public:
       identifier_setter<unsigned long>::assign(proxy->id(), object);
     }
 
+    proxy->version_ = version_;
+    if (notify) {
+      // not loaded from a database
+      proxy->mark_changed();
+    }
     node->insert(proxy);
 
     // initialize object
@@ -637,6 +787,8 @@ public:
     // notify observer
     if (notify && !transactions_.empty()) {
       transactions_.top().on_insert<T>(proxy);
+    } else if (notify && has_observers()) {
+      notify_insert(&proxy, 1);
     }
 
     // insert element into hash map for fast lookup
@@ -659,7 +811,7 @@ public:
       throw object_exception("object is null");
     }
     object_inserter_.reset();
-    std::unique_ptr<object_proxy> proxy(new object_proxy(o));
+    std::unique_ptr<object_proxy, detail::object_proxy_deleter> proxy(proxy_pool_.create(o));
     try {
       insert<T>(proxy.get(), true);
     } catch (object_exception &ex) {
@@ -670,6 +822,120 @@ public:
     return object_ptr<T>(proxy.release());
   }
 
+  /**
+   * Constructs an object of a specific type in place
+   * and inserts it. If the type was attached with
+   * pooled storage the object is created within the
+   * arena of its prototype node, otherwise it is
+   * allocated on the heap.
+   *
+   * @tparam T The type of the object
+   * @tparam Args The types of the constructor arguments
+   * @param args The constructor arguments
+   * @return Inserted object contained by an object_ptr on success.
+   */
+  template < class T, typename ... Args >
+  object_ptr<T> emplace(Args&&... args)
+  {
+    prototype_node *node = find_prototype_node<T>();
+    if (node == nullptr) {
+      throw object_exception("unknown object type");
+    }
+    if (!node->arena_) {
+      return insert(new T(std::forward<Args>(args)...));
+    }
+    detail::object_arena<T> *arena = static_cast<detail::object_arena<T>*>(node->arena_.get());
+    T *o = arena->create(std::forward<Args>(args)...);
+    std::unique_ptr<object_proxy, detail::object_proxy_deleter> proxy;
+    try {
+      proxy.reset(proxy_pool_.create(o));
+    } catch (...) {
+      detail::object_arena<T>::destroy(o);
+      throw;
+    }
+    // the object is owned by the arena
+    proxy->deleter_ = &detail::object_arena<T>::destroy;
+    object_inserter_.reset();
+    insert<T>(proxy.get(), true);
+
+    return object_ptr<T>(proxy.release());
+  }
+
+  /**
+   * Inserts all objects of the given range at once. The
+   * store takes the ownership of the objects. The ids
+   * are reserved in one step, the proxies are spliced
+   * into the prototype node as one run and the lookup
+   * maps are grown once. A current transaction is
+   * notified once for the whole range.
+   *
+   * @tparam T The type of the objects
+   * @tparam Iterator Forward iterator type over pointers to T
+   * @param first The first object of the range
+   * @param last The end of the range
+   * @return The number of inserted objects
+   * @throws oos::object_exception if the type is unknown or an object is null
+   */
+  template < class T, class Iterator >
+  std::size_t insert_range(Iterator first, Iterator last)
+  {
+    prototype_node *node = find_prototype_node<T>();
+    if (node == nullptr) {
+      throw object_exception("unknown object type");
+    }
+    std::vector<object_proxy*> proxies;
+    proxies.reserve(static_cast<std::size_t>(std::distance(first, last)));
+    try {
+      for (; first != last; ++first) {
+        T *o = *first;
+        if (o == nullptr) {
+          throw object_exception("object is null");
+        }
+        proxies.push_back(proxy_pool_.create(o));
+      }
+    } catch (...) {
+      // hand the objects back to the caller
+      for (object_proxy *proxy : proxies) {
+        proxy->release<T>();
+        detail::object_proxy_pool::destroy(proxy);
+      }
+      throw;
+    }
+    if (proxies.empty()) {
+      return 0;
+    }
+
+    detail::write_guard guard(*this);
+    // reserve the ids in one step
+    unsigned long id = seq_.reserve(proxies.size());
+    reserve(proxies.size());
+
+    for (object_proxy *proxy : proxies) {
+      proxy->id(id++);
+      proxy->ostore_ = this;
+      proxy->version_ = version_;
+      proxy->mark_changed();
+      if (proxy->has_identifier() && !proxy->pk()->is_valid()) {
+        identifier_setter<unsigned long>::assign(proxy->id(), static_cast<T*>(proxy->obj()));
+      }
+    }
+
+    node->insert(proxies);
+
+    object_inserter_.reset();
+    for (object_proxy *proxy : proxies) {
+      object_inserter_.insert(proxy, static_cast<T*>(proxy->obj()), true);
+      object_map_.insert(std::make_pair(proxy->id(), proxy));
+    }
+
+    if (!transactions_.empty()) {
+      transactions_.top().on_insert<T>(proxies);
+    } else if (has_observers()) {
+      notify_insert(proxies.data(), proxies.size());
+    }
+    return proxies.size();
+  }
+
   /**
    * Inserts a given object_ptr of specific type.
    * On successfull insertion an object_ptr element
@@ -684,6 +950,131 @@ public:
     return insert(o, true);
   }
 
+  /**
+   * Hands a fetched object to the proxy waiting for it.
+   * Called by the loader of a prototype node (see
+   * prototype_node::loader). If the proxy was inserted
+   * with its primary key only the object is initialized
+   * in place, otherwise the proxy is inserted into the
+   * store. Observers aren't notified.
+   *
+   * @tparam T The type of the object
+   * @param proxy The proxy without an object
+   * @param obj The fetched object
+   * @return The proxy of the object
+   * @throws oos::object_exception if the proxy already holds an object
+   */
+  template < class T >
+  object_proxy* load(object_proxy *proxy, T *obj)
+  {
+    return load(proxy, obj, [](T*) {});
+  }
+
+  /**
+   * Hands a fetched object to the proxy waiting for it
+   * like load(proxy, obj). The given resolver completes
+   * the object (i.e. its relations) before the object
+   * is published.
+   *
+   * A proxy inserted with its primary key only is
+   * already part of the store, so the object is
+   * initialized in place without the store lock: reader
+   * threads holding the lock shared may fetch objects.
+   * The caller must make sure that the object is only
+   * fetched once. The object is published to other
+   * threads after the resolver was called and mustn't
+   * insert other objects (i.e. items of a has many
+   * relation).
+   *
+   * @tparam T The type of the object
+   * @tparam R The type of the resolver
+   * @param proxy The proxy without an object
+   * @param obj The fetched object
+   * @param resolve Called with the object before it is published
+   * @return The proxy of the object
+   * @throws oos::object_exception if the proxy already holds an object
+   */
+  template < class T, class R >
+  object_proxy* load(object_proxy *proxy, T *obj, R resolve)
+  {
+    if (proxy->obj() != nullptr) {
+      throw object_exception("object already loaded");
+    }
+    if (proxy->id() == 0) {
+      detail::write_guard guard(*this);
+      proxy->obj_.store(obj, std::memory_order_release);
+      proxy->deleter_ = &object_proxy::destroy<T>;
+      proxy->namer_ = &object_proxy::type_id<T>;
+      insert<T>(proxy, false);
+      resolve(obj);
+      return proxy;
+    }
+    // keys only proxies are created for type T, so
+    // the deleter and namer of the proxy are kept
+    detail::object_inserter inserter(*this);
+    inserter.insert(proxy, obj, false);
+    resolve(obj);
+    proxy->obj_.store(obj, std::memory_order_release);
+    proxy->node()->unloaded_.fetch_sub(1, std::memory_order_relaxed);
+    // the indexes skipped the proxy while it had no object
+    proxy->node()->mark_modified(proxy);
+    return proxy;
+  }
+
+  /**
+   * Releases the object of the given proxy while keeping
+   * the proxy and its primary key. The object is fetched
+   * again through the loader of its prototype node on next
+   * access (see prototype_node::loader). Only objects of
+   * nodes with a loader, without pooled storage and
+   * without has many relations are evicted. Objects with
+   * changes which weren't written to the database yet
+   * are kept (see object_proxy::changes).
+   *
+   * Objects are only evicted at a safe point (see
+   * may_evict) while the lock of the store can be
+   * acquired exclusively without waiting. Pointers to
+   * the object itself become invalid.
+   *
+   * @param proxy The proxy of the object to evict
+   * @return True if the object was evicted
+   */
+  bool evict(object_proxy *proxy);
+
+  /**
+   * Returns true if objects may be evicted: no
+   * transaction is active, no snapshot is open and
+   * the calling thread isn't in the middle of a
+   * modification of the store (i.e. fetching the
+   * objects of a removed range).
+   *
+   * @return True if objects may be evicted
+   */
+  bool may_evict() const;
+
+  /**
+   * Returns the object of type T with the given raw
+   * primary key value (integral or string). The lookup
+   * creates no identifier. If there is no such object
+   * an empty object_ptr is returned.
+   *
+   * @tparam T The type of the object
+   * @tparam V The type of the primary key value
+   * @param pk The primary key value
+   * @return The object or an empty object_ptr
+   * @throws oos::object_exception if the type is unknown
+   */
+  template < class T, class V >
+  object_ptr<T> get(const V &pk)
+  {
+    prototype_node *node = find_prototype_node<T>();
+    if (node == nullptr) {
+      throw object_exception("unknown object type");
+    }
+    object_proxy *proxy = node->find_proxy(pk);
+    return proxy ? object_ptr<T>(proxy) : object_ptr<T>();
+  }
+
   /**
    * Returns true if the underlaying
    * serializable is removable.
@@ -707,6 +1098,7 @@ public:
     if (proxy->node() == nullptr) {
       throw object_exception("prototype node is nullptr");
     }
+    detail::write_guard guard(*this);
     // check if object tree is deletable
     if (check_if_deletable && !object_deleter_.is_deletable<T>(proxy, (T*)proxy->obj())) {
       throw object_exception("object is not removable");
@@ -737,7 +1129,16 @@ public:
         // notify transaction
         transactions_.top().on_delete<T>(proxy);
       } else {
-        delete proxy;
+        snapshots_.freeze(proxy);
+        if (deferred_deletes_) {
+          // batch removal notifies and deletes at once
+          deferred_deletes_->push_back(proxy);
+        } else {
+          if (notify && has_observers()) {
+            notify_delete(&proxy, 1);
+          }
+          detail::object_proxy_pool::destroy(proxy);
+        }
       }
     }
   }
@@ -758,6 +1159,92 @@ public:
     remove<T>(o.proxy_, true, true);
   }
 
+  /**
+   * Marks an object as modified. Changes made
+   * through an object_ptr are only tracked within
+   * a transaction. Objects changed outside of a
+   * transaction must be marked to keep indexes,
+   * snapshots and observers up to date.
+   *
+   * @tparam T The type of the object
+   * @param o The modified object
+   */
+  template < class T >
+  void mark_modified(const object_ptr<T> &o)
+  {
+    if (o.proxy_ && o.proxy_->ostore() == this) {
+      mark_modified<T>(o.proxy_);
+    }
+  }
+
+  /**
+   * Removes all objects of the given range of
+   * object_ptr at once. Objects which aren't loaded
+   * yet are fetched first. The deletability of all
+   * objects and their cascades is checked in a
+   * single pass. If one object isn't removable
+   * no object is removed.
+   *
+   * If the removal itself fails afterwards the
+   * objects removed so far stay removed. Run the
+   * removal within a transaction to be able to
+   * roll it back completely.
+   *
+   * @tparam T The type of the objects
+   * @tparam InputIterator The iterator type of the object_ptr range
+   * @param first The first object_ptr of the range
+   * @param last The end of the range
+   * @return The number of removed objects including cascades
+   * @throws oos::object_exception if the objects aren't loadable or removable
+   */
+  template < class T, class InputIterator >
+  std::size_t remove_range(InputIterator first, InputIterator last)
+  {
+    std::vector<object_proxy*> proxies;
+    for (; first != last; ++first) {
+      const object_ptr<T> &optr = *first;
+      if (optr.proxy_ == nullptr || optr.proxy_->ostore() != this) {
+        throw object_exception("object is not part of the store");
+      }
+      proxies.push_back(optr.proxy_);
+    }
+    return remove_proxies<T>(proxies);
+  }
+
+  /**
+   * Removes all objects of type T (and its
+   * derived types) matching the given predicate
+   * like remove_range. The predicate is called
+   * with an object_ptr<T> and may be an expression
+   * created with make_var.
+   *
+   * Only loaded objects are evaluated, objects which
+   * are known by their id only aren't fetched and
+   * stay in the store. Fetch them before through
+   * their object_ptr to include them.
+   *
+   * @tparam T The type of the objects
+   * @tparam P The type of the predicate
+   * @param pred The predicate to match
+   * @return The number of removed objects including cascades
+   * @throws oos::object_exception if the objects aren't removable
+   */
+  template < class T, class P >
+  std::size_t remove_if(P pred)
+  {
+    prototype_node *node = find_prototype_node<T>();
+    if (node == nullptr) {
+      throw object_exception("unknown object type");
+    }
+    std::vector<object_proxy*> proxies;
+    for (object_proxy *proxy = node->op_first->next(); proxy != node->op_last; proxy = proxy->next()) {
+      if (proxy->obj() != nullptr && pred(object_ptr<T>(proxy))) {
+        proxies.push_back(proxy);
+      }
+    }
+    return remove_proxies<T>(proxies);
+  }
+
   /**
    * @brief Creates and inserts an serializable proxy serializable.
    * 
@@ -779,14 +1266,15 @@ public:
   template<class T>
   object_proxy *create_proxy(T *o)
   {
-    std::unique_ptr<object_proxy> proxy(new object_proxy(o, seq_.next(), this));
-    return object_map_.insert(std::make_pair(seq_.current(), proxy.release())).first->second;
+    std::unique_ptr<object_proxy, detail::object_proxy_deleter> proxy(proxy_pool_.create(o, seq_.next(), this));
+    unsigned long id = proxy->id();
+    return object_map_.insert(std::make_pair(id, proxy.release())).first->second;
   }
 
   template<class T>
   object_proxy *create_proxy(T *o, unsigned long oid)
   {
-    std::unique_ptr<object_proxy> proxy(new object_proxy(o, oid, this));
+    std::unique_ptr<object_proxy, detail::object_proxy_deleter> proxy(proxy_pool_.create(o, oid, this));
     return object_map_.insert(std::make_pair(oid, proxy.release())).first->second;
   }
 
@@ -850,6 +1338,125 @@ public:
    */
   sequencer_impl_ptr exchange_sequencer(const sequencer_impl_ptr &seq);
 
+  /**
+   * Returns the slab allocator from which
+   * the object_proxy instances of this store
+   * are allocated.
+   *
+   * @return The object_proxy pool
+   */
+  const detail::object_proxy_pool& proxy_pool() const;
+
+  /**
+   * Returns memory and operation statistics of the
+   * store and of each prototype node in tree order.
+   * All counters are maintained by the prototype
+   * nodes, collecting the statistics takes time
+   * linear in the number of nodes only.
+   *
+   * @return The statistics of the store
+   */
+  store_stats stats() const;
+
+  /**
+   * Enables or disables concurrent read access.
+   *
+   * When enabled each modification of the store holds
+   * the store lock exclusively only while the store
+   * itself is changed, a transaction doesn't block the
+   * readers. Modified and removed objects are copied
+   * before their first change (see oos::snapshot), so
+   * the types must be copy constructible. At the end of
+   * each outermost transaction and after each modification
+   * outside of a transaction the store publishes its
+   * state as the committed snapshot. Attribute indexes
+   * are reindexed at the same time.
+   *
+   * Reader threads hold the lock shared and read the
+   * objects through committed(). Objects accessed through
+   * object_ptr or object_view show the live state, which
+   * may be changed by the writer at any time. Objects
+   * changed outside of a transaction must be changed
+   * while the lock is held exclusively and be marked
+   * with mark_modified afterwards.
+   *
+   * Must not be changed while a transaction is active.
+   *
+   * @param enable True to enable concurrent reads
+   */
+  void concurrent_reads(bool enable);
+
+  /**
+   * Returns true if concurrent read access is enabled.
+   *
+   * @return True if concurrent read access is enabled
+   */
+  bool concurrent_reads() const;
+
+  /**
+   * Returns the reader writer lock of the store.
+   * Reader threads should use it with shared_guard,
+   * writers outside of a transaction with std::lock_guard.
+   *
+   * @return The reader writer lock of the store
+   */
+  rw_lock& lock();
+
+  /**
+   * Returns the last committed state of the store
+   * while concurrent reads are enabled, otherwise an
+   * empty snapshot. The caller must hold the lock shared
+   * while calling and while reading the snapshot.
+   *
+   * @return The committed state of the store
+   */
+  oos::snapshot committed() const;
+
+  /**
+   * Takes a read only snapshot of the current
+   * state of the store in constant time. Objects
+   * are shared with the store until they are
+   * modified or removed (see oos::snapshot).
+   *
+   * @return The snapshot of the store
+   * @throws oos::object_exception if a transaction is active
+   */
+  oos::snapshot snapshot();
+
+  /**
+   * Registers an observer which is notified
+   * once for every inserted, updated or
+   * deleted object. The observer isn't owned
+   * by the store.
+   *
+   * @param observer The observer to register
+   */
+  void register_observer(object_observer *observer);
+
+  /**
+   * Registers an observer which is notified
+   * with batches of inserted, updated or
+   * deleted objects (see object_batch_observer).
+   * The observer isn't owned by the store.
+   *
+   * @param observer The observer to register
+   */
+  void register_observer(object_batch_observer *observer);
+
+  /**
+   * Unregisters the given observer.
+   *
+   * @param observer The observer to unregister
+   */
+  void unregister_observer(object_observer *observer);
+
+  /**
+   * Unregisters the given batch observer.
+   *
+   * @param observer The observer to unregister
+   */
+  void unregister_observer(object_batch_observer *observer);
+
   transaction current_transaction();
   bool has_transaction() const;
 
@@ -866,6 +1473,7 @@ private:
   template < class T, template < class ... > class ON_ATTACH >
   friend class detail::node_analyzer;
   friend class transaction;
+  friend class detail::write_guard;
   template < class T, template <class ...> class C >
   friend class has_many;
 
@@ -891,11 +1499,78 @@ private:
    */
   prototype_node* clear(prototype_node *node);
 
+  /**
+   * @internal
+   *
+   * Reindexes all attribute indexes and replaces
+   * the committed snapshot. Called by the outermost
+   * write_guard outside of a transaction.
+   */
+  void publish();
+
+  template < class T >
+  std::size_t remove_proxies(const std::vector<object_proxy*> &proxies)
+  {
+    if (proxies.empty()) {
+      return 0;
+    }
+    detail::write_guard guard(*this);
+    for (object_proxy *proxy : proxies) {
+      if (proxy->fetch() == nullptr) {
+        throw object_exception("object is not loaded");
+      }
+    }
+    if (!object_deleter_.is_deletable<T>(proxies)) {
+      throw object_exception("object is not removable");
+    }
+
+    std::vector<object_proxy*> deleted;
+    deferred_deletes_ = &deleted;
+    std::size_t count = 0;
+    try {
+      for (detail::object_deleter::iterator i = object_deleter_.begin(); i != object_deleter_.end(); ++i) {
+        if (!i->second.ignore) {
+          i->second.remove(true);
+          ++count;
+        }
+      }
+    } catch (...) {
+      // the objects removed so far are gone
+      deferred_deletes_ = nullptr;
+      if (has_observers()) {
+        notify_delete(deleted.data(), deleted.size());
+      }
+      for (object_proxy *proxy : deleted) {
+        detail::object_proxy_pool::destroy(proxy);
+      }
+      throw;
+    }
+    deferred_deletes_ = nullptr;
+
+    if (has_observers()) {
+      notify_delete(deleted.data(), deleted.size());
+    }
+    for (object_proxy *proxy : deleted) {
+      detail::object_proxy_pool::destroy(proxy);
+    }
+    return count;
+  }
+
   template < class T >
   void mark_modified(object_proxy *proxy)
   {
+    detail::write_guard guard(*this);
+    proxy->mark_changed();
     if (!transactions_.empty()) {
       transactions_.top().on_update<T>(proxy);
+    } else {
+      snapshots_.freeze(proxy);
+      if (has_observers()) {
+        notify_update(&proxy, 1);
+      }
+    }
+    if (proxy->node()) {
+      proxy->node()->mark_modified(proxy);
     }
   }
 
@@ -925,6 +1600,36 @@ private:
    */
   prototype_node *find_prototype_node(const char *type) const;
 
+  /**
+   * Finds the prototype node of type T through
+   * the type slot cache. Falls back to the typeid
+   * lookup if the node isn't cached (i.e. the
+   * typeid is attached more than once).
+   *
+   * @tparam T The type of the node
+   * @return The prototype node or nullptr
+   */
+  template < class T >
+  prototype_node* find_prototype_node() const
+  {
+    std::size_t slot = detail::type_slot<T>::index();
+    if (slot < type_slots_.size() && type_slots_[slot] != nullptr) {
+      return type_slots_[slot];
+    }
+    return find_prototype_node(typeid(T).name());
+  }
+
+  template < class T >
+  void update_type_slot(prototype_node *node)
+  {
+    std::size_t slot = detail::type_slot<T>::index();
+    if (slot >= type_slots_.size()) {
+      type_slots_.resize(slot + 1, nullptr);
+    }
+    // a typeid attached more than once isn't unique
+    type_slots_[slot] = typeid_prototype_map_[typeid(T).name()].size() == 1 ? node : nullptr;
+  }
+
   /**
    * @internal
    *
@@ -966,6 +1671,11 @@ private:
   void push_transaction(const transaction &tr);
   void pop_transaction();
 
+  bool has_observers() const;
+  void notify_insert(object_proxy *const *proxies, std::size_t count);
+  void notify_update(object_proxy *const *proxies, std::size_t count);
+  void notify_delete(object_proxy *const *proxies, std::size_t count);
+
 private:
   typedef std::unordered_map<std::string, prototype_node *> t_prototype_map;
   // typeid -> [name -> prototype]
@@ -983,7 +1693,13 @@ private:
   // prepared prototype nodes
   t_prototype_map prepared_prototype_map_;
 
-  typedef std::unordered_map<long, object_proxy *> t_object_proxy_map;
+  // type slot to prototype node, see detail::type_slot
+  std::vector<prototype_node *> type_slots_;
+
+  // slab allocator for all object proxies of this store
+  detail::object_proxy_pool proxy_pool_;
+
+  typedef flat_hash_map<unsigned long, object_proxy *> t_object_proxy_map;
   t_object_proxy_map object_map_;
 
   sequencer seq_;
@@ -991,6 +1707,9 @@ private:
   typedef std::list<object_observer *> t_observer_list;
   t_observer_list observer_list_;
 
+  typedef std::list<object_batch_observer *> t_batch_observer_list;
+  t_batch_observer_list batch_observer_list_;
+
   detail::object_deleter object_deleter_;
   detail::object_inserter object_inserter_;
 
@@ -998,6 +1717,23 @@ private:
   abstract_has_many *temp_container_ = nullptr;
 
   std::stack<transaction> transactions_;
+
+  rw_lock lock_;
+  bool concurrent_reads_ = false;
+  // the number of nested write guards, written by
+  // the thread holding the lock exclusively
+  unsigned long write_depth_ = 0;
+  // the state readers see while concurrent reads are enabled
+  std::shared_ptr<detail::snapshot_data> committed_;
+
+  detail::snapshot_registry snapshots_;
+  // stamped on each inserted proxy, incremented
+  // by each snapshot to tell the objects apart
+  // which were inserted after the snapshot
+  unsigned long version_ = 0;
+
+  // collects the proxies of a batch removal outside of a transaction
+  std::vector<object_proxy*> *deferred_deletes_ = nullptr;
 };
 
 template<class T, template < class ... > class ON_ATTACH, typename Enabled >
@@ -1036,6 +1772,9 @@ object_store::iterator object_store::attach(const char *type, bool abstract, con
   // Todo: check return value
   prototype_map_.insert(std::make_pair(node->type_, node))/*.first*/;
   typeid_prototype_map_[typeid(T).name()].insert(std::make_pair(node->type_, node));
+  update_type_slot<T>(node);
+  node->object_size_ = sizeof(T);
+  node->clone_func_ = &detail::object_cloner<T>::clone;
 
   on_attach(node);
 
@@ -1048,6 +1787,14 @@ object_store::iterator object_store::attach(const char *type, bool abstract, con
   return attach<T, ON_ATTACH>(type, abstract, typeid(S).name(), on_attach);
 }
 
+template<class T, template < class ... > class ON_ATTACH, typename Enabled >
+object_store::iterator object_store::attach(const char *type, const pooled_storage &storage, bool abstract, const char *parent, const ON_ATTACH<T> &on_attach)
+{
+  iterator node = attach<T, ON_ATTACH>(type, abstract, parent, on_attach);
+  node->arena_.reset(new detail::object_arena<T>(storage.chunk_size));
+  return node;
+}
+
 template<class T>
 prototype_iterator object_store::prepare_attach(bool abstract, const char *parent)
 {
@@ -1184,6 +1931,7 @@ template<class T, template < class ... > class ON_ATTACH>
 template<class V, template<class ...> class C>
 void node_analyzer<T, ON_ATTACH>::serialize(const char *id, has_many<V, C> &x, const char *owner_field, const char *item_field)
 {
+  node_.register_has_many();
   // item column column names
   x.owner_field(owner_field);
   x.item_field(item_field);
@@ -1218,7 +1966,7 @@ void object_inserter::insert(object_proxy *proxy, T *o, bool notify)
     store.mark_modified<T>(oproxy);
   };
 
-  if (proxy->obj()) {
+  if (o) {
     oos::access::serialize(*this, *o);
   }
   object_proxy_stack_.pop();
@@ -1300,7 +2048,7 @@ void object_deleter::t_object_count::remove_object(object_proxy *proxy, bool not
 template<class T>
 bool object_deleter::is_deletable(object_proxy *proxy, T *o) {
   object_count_map.clear();
-  object_count_map.insert(std::make_pair(proxy->id(), t_object_count(proxy, false, (T*)proxy->obj())));
+  object_count_map.insert(std::make_pair(proxy->id(), t_object_count(proxy, false, (T*)proxy->obj()))).first->second.traversed = true;
 
   // start collecting information
   oos::access::serialize(*this, *o);
@@ -1308,6 +2056,28 @@ bool object_deleter::is_deletable(object_proxy *proxy, T *o) {
   return check_object_count_map();
 }
 
+template<class T>
+bool object_deleter::is_deletable(const std::vector<object_proxy*> &proxies) {
+  object_count_map.clear();
+  for (object_proxy *proxy : proxies) {
+    T *o = (T*)proxy->fetch();
+    if (o == nullptr) {
+      // object isn't loaded and can't be fetched
+      return false;
+    }
+    std::pair<t_object_count_map::iterator, bool> ret = object_count_map.insert(
+      std::make_pair(proxy->id(), t_object_count(proxy, false, o))
+    );
+    // the object may already be reached by a relation
+    ret.first->second.ignore = false;
+    if (!ret.first->second.traversed) {
+      ret.first->second.traversed = true;
+      oos::access::serialize(*this, *o);
+    }
+  }
+  return check_object_count_map();
+}
+
 template<class T>
 void object_deleter::serialize(const char *, has_one<T> &x, cascade_type cascade) {
   if (!x.ptr()) {
@@ -1319,7 +2089,10 @@ void object_deleter::serialize(const char *, has_one<T> &x, cascade_type cascade
   --ret.first->second.reference_counter;
   if (cascade & cascade_type::REMOVE) {
     ret.first->second.ignore = false;
-    oos::access::serialize(*this, *(T*)x.ptr());
+    if (!ret.first->second.traversed) {
+      ret.first->second.traversed = true;
+      oos::access::serialize(*this, *(T*)x.ptr());
+    }
   }
 }
 
@@ -1348,7 +2121,10 @@ void object_deleter::serialize(const char *, basic_has_many<T, C> &x, const char
       ret.first->second.ignore = false;
     }
 
-    oos::access::serialize(*this, *iptr);
+    if (!ret.first->second.traversed) {
+      ret.first->second.traversed = true;
+      oos::access::serialize(*this, *iptr);
+    }
   }
 }
 
@@ -21,11 +21,16 @@
 #include "object/object_store.hpp"
 #include "object/object_proxy.hpp"
 #include "object/object_ptr.hpp"
+#include "object/object_expression.hpp"
 #include "object/object_exception.hpp"
 #include "object/prototype_node.hpp"
+#include "object/ordered_view.hpp"
+
+#include "tools/worker_pool.hpp"
 
 #include <sstream>
 #include <algorithm>
+#include <vector>
 
 namespace oos {
 
@@ -196,7 +201,8 @@ public:
    */
   value_type optr() const
   {
-    if (current_->obj())
+    // proxies holding only a primary key fetch their object on access
+    if (current_->obj() || current_->has_identifier())
       return value_type(current_);
     else
       return value_type();
@@ -407,7 +413,8 @@ public:
    * @return The iterators underlaying node as object_ptr.
    */
   value_type optr() const {
-    if (current_->obj())
+    // proxies holding only a primary key fetch their object on access
+    if (current_->obj() || current_->has_identifier())
       return value_type(current_);
     else
       return value_type();
@@ -476,7 +483,7 @@ public:
   object_view(object_store &ostore, bool skip_siblings = false)
     : skip_siblings_(skip_siblings)
   {
-    node_ = ostore.find(typeid(T).name());
+    node_ = ostore.find<T>();
 		if (node_ == ostore.end()) {
       std::stringstream str;
       str << "couldn't find serializable type [" << typeid(T).name() << "]";
@@ -573,7 +580,7 @@ public:
    * @return The size of the object_view.
    */
   size_t size() const {
-    return static_cast<size_t>(std::distance(begin(), end()));
+    return static_cast<size_t>(node_->size(skip_siblings_));
   }
   
   /**
@@ -614,6 +621,168 @@ public:
     return std::find_if(begin(), end(), pred);
   }
 
+  /**
+   * Returns all objects matching the given expression.
+   * If the expression compares an indexed attribute
+   * (see make_var and object_store::create_index) with a
+   * value, the objects are taken from the index instead
+   * of scanning the view. Otherwise the view is scanned.
+   *
+   * @tparam E The type of the expression
+   * @param expr The expression to match
+   * @return All matching objects
+   */
+  template < class E >
+  std::vector<object_pointer> select(const E &expr) const
+  {
+    std::vector<object_pointer> result;
+    std::vector<object_proxy*> candidates;
+    if (detail::index_lookup(node_.get(), expr, candidates)) {
+      for (object_proxy *proxy : candidates) {
+        // the index may belong to a parent node
+        if (proxy->node() != node_.get() && (skip_siblings_ || !proxy->node()->is_child_of(node_.get()))) {
+          continue;
+        }
+        const void *obj = proxy->fetch();
+        if (obj != nullptr && expr.evaluate(obj)) {
+          result.push_back(object_pointer(proxy));
+        }
+      }
+    } else {
+      // evaluate on the raw objects, object pointers
+      // are only created for the matching objects
+      object_proxy *last = skip_siblings_ ? node_->op_marker : node_->op_last;
+      for (object_proxy *proxy = node_->op_first->next(); proxy != last; proxy = proxy->next()) {
+        const void *obj = proxy->fetch();
+        if (obj != nullptr && expr.evaluate(obj)) {
+          result.push_back(object_pointer(proxy));
+        }
+      }
+    }
+    return result;
+  }
+
+  /**
+   * Returns the objects of the view in ascending
+   * order of the given attribute. The attribute
+   * must have an ordered index of value type V
+   * (see object_store::create_index). String like
+   * attributes are indexed as std::string.
+   *
+   * @tparam V The type of the attribute value
+   * @param attribute The name of the attribute
+   * @return The ordered view of the objects
+   * @throws oos::object_exception if there is no ordered index of type V on the attribute
+   */
+  template < class V >
+  ordered_view<T, V> ordered_by(const char *attribute) const
+  {
+    detail::basic_object_index *index = node_->find_index(attribute);
+    if (index == nullptr || index->type() != index_type::ORDERED) {
+      throw object_exception("no ordered index on attribute");
+    }
+    detail::object_index<V> *typed_index = dynamic_cast<detail::object_index<V>*>(index);
+    if (typed_index == nullptr) {
+      throw object_exception("attribute index is of a different type");
+    }
+    return ordered_view<T, V>(node_.get(), skip_siblings_, typed_index);
+  }
+
+  /**
+   * Returns all objects matching the given expression
+   * or predicate. Unlike select() the view is always
+   * scanned: the objects are split into the given number
+   * of chunks which are evaluated by the threads of the
+   * worker_pool and the calling thread. The result keeps
+   * the order of the view.
+   *
+   * Objects holding only a primary key are fetched
+   * before the scan starts. The threads evaluate the
+   * expression on the raw objects, a predicate is called
+   * with a const reference to the object and must not
+   * modify it. If concurrent reads are enabled the
+   * caller holds the store lock shared.
+   *
+   * @tparam E The type of the expression or predicate
+   * @param expr The expression to match
+   * @param threads The number of chunks, 0 for one per core
+   * @return All matching objects in view order
+   */
+  template < class E >
+  std::vector<object_pointer> filter(const E &expr, std::size_t threads = 0) const
+  {
+    std::vector<object_proxy*> proxies(collect());
+    std::vector<std::vector<object_proxy*>> chunks;
+    run_chunks(proxies, threads, chunks, [&expr](object_proxy **first, object_proxy **last, std::vector<object_proxy*> &result) {
+      for (; first != last; ++first) {
+        if (matches(expr, object(*first), 0)) {
+          result.push_back(*first);
+        }
+      }
+    });
+    // the object pointers are created by the calling thread
+    std::vector<object_pointer> result;
+    for (std::vector<object_proxy*> &chunk : chunks) {
+      for (object_proxy *proxy : chunk) {
+        result.push_back(object_pointer(proxy));
+      }
+    }
+    return result;
+  }
+
+  /**
+   * Counts the objects matching the given expression
+   * or predicate. The view is scanned in parallel like
+   * in filter().
+   *
+   * @tparam E The type of the expression or predicate
+   * @param expr The expression to match
+   * @param threads The number of chunks, 0 for one per core
+   * @return The number of matching objects
+   */
+  template < class E >
+  std::size_t count_if(const E &expr, std::size_t threads = 0) const
+  {
+    std::vector<object_proxy*> proxies(collect());
+    std::vector<std::size_t> chunks;
+    run_chunks(proxies, threads, chunks, [&expr](object_proxy **first, object_proxy **last, std::size_t &result) {
+      for (; first != last; ++first) {
+        if (matches(expr, object(*first), 0)) {
+          ++result;
+        }
+      }
+    });
+    std::size_t count = 0;
+    for (std::size_t chunk : chunks) {
+      count += chunk;
+    }
+    return count;
+  }
+
+  /**
+   * Calls the given function for every object of the
+   * view. The objects are split into chunks like in
+   * filter() and the chunks are processed in parallel,
+   * so the function must be safe to call from several
+   * threads at once. Within a chunk the objects are
+   * visited in view order.
+   *
+   * @tparam F The function type, called with (const T&)
+   * @param f The function to call
+   * @param threads The number of chunks, 0 for one per core
+   */
+  template < class F >
+  void for_each(F f, std::size_t threads = 0) const
+  {
+    std::vector<object_proxy*> proxies(collect());
+    std::vector<char> chunks;
+    run_chunks(proxies, threads, chunks, [&f](object_proxy **first, object_proxy **last, char&) {
+      for (; first != last; ++first) {
+        f(*object(*first));
+      }
+    });
+  }
+
   /**
    * Return the underlaying prototype node
    *
@@ -624,6 +793,78 @@ public:
     return node_.get();
   }
 
+private:
+  /*
+   * Collects the proxies of the view in view order.
+   * Lazy loaded objects are fetched here, because
+   * the workers only read the loaded objects.
+   */
+  std::vector<object_proxy*> collect() const
+  {
+    std::vector<object_proxy*> proxies;
+    proxies.reserve(size());
+    object_proxy *last = skip_siblings_ ? node_->op_marker : node_->op_last;
+    for (object_proxy *proxy = node_->op_first->next(); proxy != last; proxy = proxy->next()) {
+      if (proxy->obj() == nullptr && proxy->has_identifier()) {
+        proxy->fetch();
+      }
+      if (proxy->obj() != nullptr) {
+        proxies.push_back(proxy);
+      }
+    }
+    return proxies;
+  }
+
+  /*
+   * Returns the loaded object of the given proxy
+   * without touching the proxy or its holders.
+   */
+  static const T* object(object_proxy *proxy)
+  {
+    return static_cast<const T*>(proxy->obj());
+  }
+
+  /*
+   * Expressions are evaluated on the raw object,
+   * other predicates are called with the object.
+   */
+  template < class E >
+  static auto matches(const E &expr, const T *obj, int) -> decltype(expr.evaluate(obj))
+  {
+    return expr.evaluate(obj);
+  }
+
+  template < class E >
+  static bool matches(const E &expr, const T *obj, long)
+  {
+    return expr(*obj);
+  }
+
+  /*
+   * Splits the proxies into the given number of chunks
+   * and calls f(first, last, result) for each chunk on
+   * the threads of the worker_pool and the calling thread.
+   * Exceptions of a worker are rethrown here.
+   */
+  template < class R, class F >
+  static void run_chunks(std::vector<object_proxy*> &proxies, std::size_t threads, std::vector<R> &results, F f)
+  {
+    if (threads == 0) {
+      threads = worker_pool::instance().size() + 1;
+    }
+    std::size_t chunks = std::max<std::size_t>(std::min(threads, proxies.size()), 1);
+    std::size_t chunk_size = proxies.size() / chunks;
+    std::size_t remainder = proxies.size() % chunks;
+
+    results.assign(chunks, R());
+    object_proxy **data = proxies.data();
+    worker_pool::instance().run(chunks, [&](std::size_t i) {
+      object_proxy **first = data + i * chunk_size + std::min(i, remainder);
+      object_proxy **last = first + chunk_size + (i < remainder ? 1 : 0);
+      f(first, last, results[i]);
+    });
+  }
+
 private:
     bool skip_siblings_;
     prototype_iterator node_;
@@ -0,0 +1,327 @@
+#ifndef OOS_ORDERED_VIEW_HPP
+#define OOS_ORDERED_VIEW_HPP
+
+#include "object/object_ptr.hpp"
+#include "object/object_index.hpp"
+#include "object/prototype_node.hpp"
+
+#include <iterator>
+
+namespace oos {
+
+/// @cond OOS_DEV
+
+/**
+ * @class ordered_view_iterator
+ * @brief Iterator class for an ordered_view
+ *
+ * The iterator walks a copy of the ordered map of an
+ * attribute index and skips all objects which aren't
+ * part of the view (i.e. objects of a parent type if
+ * the index belongs to the parent node). The iterator
+ * shares the copy, so it stays valid after the view
+ * is gone.
+ *
+ * @tparam T Object type of the iterator
+ * @tparam V Type of the attribute value
+ */
+template < class T, class V >
+class ordered_view_iterator : public std::iterator<std::bidirectional_iterator_tag, object_ptr<T>, std::ptrdiff_t, object_ptr<T>*, object_ptr<T>>
+{
+public:
+  typedef ordered_view_iterator<T, V> self;                                          /**< Shortcut for this class. */
+  typedef object_ptr<T> value_type;                                                  /**< Shortcut for the value type. */
+  typedef typename detail::object_index<V>::t_ordered_map::const_iterator map_iterator; /**< Shortcut for the map iterator. */
+  typedef typename detail::object_index<V>::t_ordered_map_ptr map_ptr;                 /**< Shortcut for the shared map copy. */
+
+  /**
+   * Creates an empty iterator
+   */
+  ordered_view_iterator() {}
+
+  /**
+   * Creates an iterator for the given position of
+   * the ordered map. If the position doesn't belong
+   * to the view the iterator moves forward to the
+   * next position of the view.
+   *
+   * @param node The prototype_node of the view
+   * @param skip_siblings True if only objects of node are part of the view
+   * @param map The iterated copy of the ordered map
+   * @param current The current position
+   */
+  ordered_view_iterator(const prototype_node *node, bool skip_siblings, const map_ptr &map, map_iterator current)
+    : node_(node)
+    , skip_siblings_(skip_siblings)
+    , map_(map)
+    , first_(map->begin())
+    , current_(current)
+    , last_(map->end())
+  {
+    skip_forward();
+  }
+
+  /**
+   * @brief Compares this with another iterators.
+   *
+   * @param i The iterator to compare with.
+   * @return True if the iterators are the same.
+   */
+  bool operator==(const self &i) const
+  {
+    return current_ == i.current_;
+  }
+
+  /**
+   * @brief Compares this with another iterators.
+   *
+   * @param i The iterator to compare with.
+   * @return True if the iterators are not the same.
+   */
+  bool operator!=(const self &i) const
+  {
+    return current_ != i.current_;
+  }
+
+  /**
+   * Pre increments the iterator
+   *
+   * @return Returns iterators successor.
+   */
+  self& operator++()
+  {
+    ++current_;
+    skip_forward();
+    return *this;
+  }
+
+  /**
+   * Post increments the iterator
+   *
+   * @return Returns iterator before incrementing.
+   */
+  self operator++(int)
+  {
+    self tmp(*this);
+    ++(*this);
+    return tmp;
+  }
+
+  /**
+   * Pre decrements the iterator
+   *
+   * @return Returns iterators predecessor.
+   */
+  self& operator--()
+  {
+    while (current_ != first_) {
+      --current_;
+      if (is_part_of_view()) {
+        break;
+      }
+    }
+    return *this;
+  }
+
+  /**
+   * Post decrements the iterator
+   *
+   * @return Returns iterator before decrementing.
+   */
+  self operator--(int)
+  {
+    self tmp(*this);
+    --(*this);
+    return tmp;
+  }
+
+  /**
+   * Returns the object as object_ptr.
+   *
+   * @return The object as object_ptr.
+   */
+  value_type operator*() const
+  {
+    return optr();
+  }
+
+  /**
+   * Returns the object as object_ptr.
+   *
+   * @return The object as object_ptr.
+   */
+  value_type optr() const
+  {
+    return value_type(current_->second);
+  }
+
+  /**
+   * Returns the attribute value
+   * of the current object.
+   *
+   * @return The attribute value.
+   */
+  const V& key() const
+  {
+    return current_->first;
+  }
+
+private:
+  bool is_part_of_view() const
+  {
+    const prototype_node *node = current_->second->node();
+    return node == node_ || (!skip_siblings_ && node->is_child_of(node_));
+  }
+
+  void skip_forward()
+  {
+    while (current_ != last_ && !is_part_of_view()) {
+      ++current_;
+    }
+  }
+
+private:
+  const prototype_node *node_ = nullptr;
+  bool skip_siblings_ = false;
+  map_ptr map_;
+  map_iterator first_;
+  map_iterator current_;
+  map_iterator last_;
+};
+
+/// @endcond
+
+/**
+ * @class ordered_view
+ * @brief Objects of an object_view in attribute order
+ *
+ * An ordered_view is created by object_view::ordered_by
+ * and iterates the ordered index of an attribute. The
+ * objects are visited in ascending order of the attribute
+ * (use reverse iterators for descending order) without
+ * copying or sorting them. Iterators returned by
+ * lower_bound and upper_bound restrict the iteration
+ * to a range of values.
+ *
+ * The view works on the state of the index at its
+ * creation: pending modifications are applied and
+ * the ordered map is copied (the copy is shared with
+ * other views until the index changes). Later changes
+ * of the attribute or inserted objects aren't reflected,
+ * create a new view to see them. Objects removed from
+ * the store must not be accessed through the view.
+ *
+ * @tparam T The type of the objects
+ * @tparam V The type of the attribute value
+ */
+template < class T, class V >
+class ordered_view
+{
+public:
+  typedef ordered_view_iterator<T, V> iterator;                 /**< Shortcut to the iterator type */
+  typedef std::reverse_iterator<iterator> reverse_iterator;     /**< Shortcut to the reverse iterator type */
+
+  /**
+   * Creates an ordered_view over the given index.
+   *
+   * @param node The prototype_node of the viewed type
+   * @param skip_siblings If true only objects of concrete type T are part of the view
+   * @param index The ordered index of the attribute
+   */
+  ordered_view(const prototype_node *node, bool skip_siblings, detail::object_index<V> *index)
+    : node_(node)
+    , skip_siblings_(skip_siblings)
+    , map_(index->ordered_map())
+  {}
+
+  /**
+   * Returns the iterator to the object
+   * with the lowest attribute value.
+   *
+   * @return The begin iterator.
+   */
+  iterator begin() const
+  {
+    return make_iterator(map_->begin());
+  }
+
+  /**
+   * Returns the end of the view.
+   *
+   * @return The end iterator.
+   */
+  iterator end() const
+  {
+    return make_iterator(map_->end());
+  }
+
+  /**
+   * Returns the reverse iterator to the object
+   * with the highest attribute value.
+   *
+   * @return The reverse begin iterator.
+   */
+  reverse_iterator rbegin() const
+  {
+    return reverse_iterator(end());
+  }
+
+  /**
+   * Returns the reverse end of the view.
+   *
+   * @return The reverse end iterator.
+   */
+  reverse_iterator rend() const
+  {
+    return reverse_iterator(begin());
+  }
+
+  /**
+   * Returns the iterator to the first object
+   * with an attribute value not less than value.
+   *
+   * @param value The value to look for
+   * @return The iterator to the first object not less than value.
+   */
+  iterator lower_bound(const V &value) const
+  {
+    return make_iterator(map_->lower_bound(value));
+  }
+
+  /**
+   * Returns the iterator to the first object
+   * with an attribute value greater than value.
+   *
+   * @param value The value to look for
+   * @return The iterator to the first object greater than value.
+   */
+  iterator upper_bound(const V &value) const
+  {
+    return make_iterator(map_->upper_bound(value));
+  }
+
+  /**
+   * Returns true if the view is empty.
+   *
+   * @return True if the view is empty.
+   */
+  bool empty() const
+  {
+    return begin() == end();
+  }
+
+private:
+  iterator make_iterator(typename iterator::map_iterator current) const
+  {
+    return iterator(node_, skip_siblings_, map_, current);
+  }
+
+private:
+  const prototype_node *node_;
+  bool skip_siblings_;
+  typename iterator::map_ptr map_;
+};
+
+}
+
+#endif //OOS_ORDERED_VIEW_HPP
@@ -35,17 +35,58 @@
 #include "tools/identifier.hpp"
 
 #include "object/identifier_proxy_map.hpp"
+#include "object/object_arena.hpp"
+#include "object/object_index.hpp"
+#include "object/object_loader.hpp"
 
+#include <atomic>
 #include <map>
 #include <list>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 namespace oos {
 
 class object_store;
 class object_proxy;
+class snapshot;
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * @brief Copies an object of the concrete type T
+ *
+ * Types which aren't copy constructible
+ * return an empty pointer.
+ *
+ * @tparam T The type of the object
+ */
+template < class T, class Enabled = void >
+struct object_cloner
+{
+  static std::shared_ptr<void> clone(const void *)
+  {
+    return std::shared_ptr<void>();
+  }
+};
+
+template < class T >
+struct object_cloner<T, typename std::enable_if<std::is_copy_constructible<T>::value>::type>
+{
+  static std::shared_ptr<void> clone(const void *obj)
+  {
+    return std::make_shared<T>(*static_cast<const T*>(obj));
+  }
+};
+
+/// @endcond
+
+}
 
 /**
  * @class prototype_node
@@ -127,6 +168,17 @@ public:
    */
   unsigned long size() const;
 
+  /**
+   * Returns the number of objects of this node. If self
+   * is false the objects of all child nodes are
+   * included. The count is kept up to date on insert
+   * and remove, so the call takes constant time.
+   *
+   * @param self If true only elements inside this node are considered.
+   * @return The number of objects.
+   */
+  unsigned long size(bool self) const;
+
   /**
    * Return the type name of this node.
    *
@@ -160,6 +212,16 @@ public:
    */
   void insert(object_proxy *proxy);
 
+  /**
+   * Inserts a run of serializable proxies at once. The
+   * proxies are chained and spliced into the list of
+   * the node in one step. The order of the proxies
+   * is kept.
+   *
+   * @param proxies The proxies to insert
+   */
+  void insert(const std::vector<object_proxy*> &proxies);
+
   /**
    * @brief Removes an serializable proxy from prototype node
    *
@@ -300,8 +362,103 @@ public:
   void register_relation(const char *type, prototype_node *node, const char *id);
   void prepare_foreign_key(prototype_node *master_node, const char *id);
 
+  /**
+   * Returns the object arena of the node if the
+   * type was attached with pooled storage,
+   * otherwise nullptr is returned.
+   *
+   * @return The object arena or nullptr
+   */
+  const detail::basic_object_arena* arena() const;
+
+  /**
+   * Returns the index on the given attribute. The
+   * indexes of all parent nodes are considered
+   * as well. If there is no index nullptr is returned.
+   *
+   * @param attribute The name of the indexed attribute
+   * @return The index or nullptr
+   */
+  detail::basic_object_index* find_index(const char *attribute) const;
+
+  /**
+   * Marks the given proxy as modified in all indexes
+   * of this node and its parent nodes.
+   *
+   * @param proxy The modified proxy
+   */
+  void mark_modified(object_proxy *proxy);
+
+  /**
+   * Returns a copy of the given object of this
+   * node. The object is copied as the type the
+   * node was attached with. If the type isn't copy
+   * constructible an empty pointer is returned.
+   *
+   * @param obj The object to copy
+   * @return The copy of the object
+   */
+  std::shared_ptr<void> clone(const void *obj) const;
+
   /// @endcond
 
+  /**
+   * Sets the loader fetching objects of this node
+   * which were inserted with their primary key only.
+   * The node doesn't take ownership of the loader.
+   *
+   * @param loader The loader or nullptr
+   */
+  void loader(detail::object_loader *loader);
+
+  /**
+   * Returns the loader of this node.
+   *
+   * @return The loader or nullptr
+   */
+  detail::object_loader* loader() const;
+
+  /**
+   * Marks the type of this node as the owner
+   * of a has many relation.
+   */
+  void register_has_many();
+
+  /**
+   * Returns true if the type of this node
+   * owns at least one has many relation.
+   *
+   * @return True if the type owns a has many relation
+   */
+  bool has_many() const;
+
+  /**
+   * Enables or disables recording accesses of the
+   * objects of this node (see object_proxy::accessed).
+   * Accesses are only recorded for an eviction policy.
+   *
+   * @param track True to record accesses
+   */
+  void track_access(bool track);
+
+  /**
+   * Returns true if accesses of the objects
+   * of this node are recorded.
+   *
+   * @return True if accesses are recorded
+   */
+  bool track_access() const;
+
+  /**
+   * Returns true if the given proxy is marked as
+   * modified in an index of this node or of one
+   * of its parent nodes.
+   *
+   * @param proxy The proxy to check
+   * @return True if the proxy is marked as modified
+   */
+  bool is_marked(object_proxy *proxy) const;
+
   /**
    * Prints the node in graphviz layout to the stream.
    *
@@ -320,6 +477,23 @@ public:
    */
   object_proxy* find_proxy(const std::shared_ptr<basic_identifier> &pk);
 
+  /**
+   * Find the underlying proxy of the given raw primary
+   * key value (integral or string). No identifier is
+   * created for the lookup. If no proxy is found nullptr
+   * is returned.
+   *
+   * @tparam V The type of the primary key value
+   * @param pk The primary key value
+   * @return The corresponding object_proxy or nullptr
+   */
+  template < class V >
+  object_proxy* find_proxy(const V &pk)
+  {
+    lookups_.fetch_add(1, std::memory_order_relaxed);
+    return id_map_.find(pk);
+  }
+
 private:
 
   /**
@@ -343,9 +517,30 @@ private:
    */
   void adjust_left_marker(prototype_node *root, object_proxy *old_proxy, object_proxy *new_proxy);
 
+  /**
+   * @internal
+   *
+   * Adjusts the total count of this node
+   * and all its parent nodes.
+   *
+   * @param n Number of objects added (positive) or removed (negative).
+   */
+  void adjust_total_count(long n);
+
+  /**
+   * @internal
+   *
+   * Resets the node to an empty state without
+   * touching its proxies. Used by object_store::clear()
+   * after all proxies of the store were disposed, the
+   * markers are reset to the sentinels of the root node.
+   */
+  void forget_objects();
+
 private:
   friend class prototype_tree;
   friend class object_store;
+  friend class snapshot;
   template < class T >
   friend class object_view;
   template < class T >
@@ -384,7 +579,8 @@ private:
   object_proxy *op_last = nullptr;   /**< The marker of the last list node of all elements. */
   
   unsigned int depth = 0;  /**< The depth of the node inside of the tree. */
-  unsigned long count = 0; /**< The total count of elements. */
+  unsigned long count = 0; /**< The count of elements of this node. */
+  unsigned long total_count = 0; /**< The count of elements of this node and all child nodes. */
 
   std::string type_;	       /**< The type name of the prototype node */
   std::string typeid_;	   /**< The type id of the prototype node */
@@ -394,7 +590,7 @@ private:
   /**
    * Holds the primary keys of all proxies in this node
    */
-  detail::t_identifier_map id_map_; /**< The identifier to object_proxy map */
+  detail::identifier_proxy_map id_map_; /**< The identifier to object_proxy map */
 
   /**
    * a primary key prototype to clone from
@@ -415,6 +611,37 @@ private:
    */
   typedef std::unordered_map<std::string, std::shared_ptr<basic_identifier> > t_foreign_key_map;
   t_foreign_key_map foreign_keys; /**< The foreign key map */
+
+  /**
+   * the arena holding the objects of this
+   * node if the type uses pooled storage
+   */
+  std::unique_ptr<detail::basic_object_arena> arena_;
+
+  /**
+   * the secondary attribute indexes covering
+   * the objects of this node and all child nodes
+   */
+  typedef std::vector<std::unique_ptr<detail::basic_object_index> > t_index_vector;
+  t_index_vector indexes_; /**< The attribute indexes */
+
+  std::size_t object_size_ = 0; /**< The size of one object of this node */
+
+  std::shared_ptr<void> (*clone_func_)(const void*) = nullptr; /**< Copies an object of this node */
+
+  detail::object_loader *loader_ = nullptr; /**< The loader of unloaded objects */
+  bool has_many_ = false;                   /**< True if the type owns a has many relation */
+  std::atomic<bool> track_access_{false};   /**< True if object accesses are recorded */
+
+  /*
+   * operation counters for object_store::stats(),
+   * updated with relaxed ordering because reader
+   * threads may look up proxies concurrently
+   */
+  std::atomic<unsigned long> inserts_{0}; /**< The count of inserted objects */
+  std::atomic<unsigned long> removes_{0}; /**< The count of removed objects */
+  std::atomic<unsigned long> lookups_{0}; /**< The count of proxy lookups */
+  std::atomic<unsigned long> unloaded_{0}; /**< The count of own proxies without a loaded object */
 };
 
 }
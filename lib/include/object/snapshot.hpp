@@ -0,0 +1,269 @@
+#ifndef OOS_SNAPSHOT_HPP
+#define OOS_SNAPSHOT_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
+#include "object/object_proxy.hpp"
+#include "object/prototype_node.hpp"
+
+#include <list>
+#include <memory>
+#include <typeinfo>
+#include <unordered_map>
+
+namespace oos {
+
+class object_store;
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * @class snapshot_data
+ * @brief The shared state of a snapshot
+ *
+ * Holds the highest object id at the time the
+ * snapshot was taken and a copy of every object
+ * which was modified or removed since then.
+ */
+class OOS_API snapshot_data
+{
+public:
+  struct frozen_object
+  {
+    std::shared_ptr<void> object;  /**< Copy of the object at snapshot time */
+    prototype_node *node;          /**< The node of the object */
+  };
+
+  typedef std::unordered_map<unsigned long, frozen_object> t_frozen_map; /**< Shortcut for the frozen object map */
+
+  snapshot_data(object_store *store, unsigned long version);
+
+  /**
+   * Returns true if the object of the given proxy
+   * was inserted before the snapshot was taken.
+   *
+   * @param proxy The proxy to check
+   * @return True if the object is part of the snapshot
+   */
+  bool contains(const object_proxy *proxy) const
+  {
+    return proxy->version_ <= version_;
+  }
+
+  /**
+   * Returns the live proxy for the given id if
+   * the object existed when the snapshot was taken.
+   *
+   * @param id The id of the object
+   * @return The live proxy or nullptr
+   */
+  object_proxy* find_live(unsigned long id) const;
+
+  /**
+   * Returns the prototype node of the given type.
+   *
+   * @param type The type name or typeid name
+   * @return The prototype node or nullptr
+   */
+  prototype_node* find_node(const char *type) const;
+
+  object_store *store_;
+  unsigned long version_;
+  t_frozen_map frozen_;
+};
+
+/**
+ * @class snapshot_registry
+ * @brief Keeps track of the snapshots of an object_store
+ *
+ * The object_store asks the registry to freeze an
+ * object before it is modified or removed. One copy
+ * of the object is shared by all open snapshots
+ * which don't hold a copy of the object yet.
+ */
+class OOS_API snapshot_registry
+{
+public:
+  /**
+   * Creates the data of a new snapshot.
+   *
+   * @param store The object_store of the snapshot
+   * @param version The insert version of the store
+   * @return The new snapshot data
+   */
+  std::shared_ptr<snapshot_data> create(object_store *store, unsigned long version);
+
+  /**
+   * Returns true if no snapshot was taken
+   * or all snapshots were released.
+   *
+   * @return True if there is no open snapshot
+   */
+  bool empty() const;
+
+  /**
+   * Detaches all open snapshots from their
+   * store. Called when the objects of the
+   * store are cleared.
+   */
+  void detach();
+
+  /**
+   * Copies the object of the given proxy into
+   * all open snapshots which don't hold a copy
+   * of it yet. The object is copied through the
+   * prototype node of the proxy, so it keeps its
+   * concrete type.
+   *
+   * @param proxy The proxy of the object to freeze
+   * @throws oos::object_exception if the type of the object isn't copy constructible
+   */
+  void freeze(object_proxy *proxy);
+
+private:
+  typedef std::list<std::weak_ptr<snapshot_data>> t_snapshot_list;
+
+  void purge();
+
+  t_snapshot_list snapshots_;
+};
+
+/// @endcond
+
+}
+
+/**
+ * @class snapshot
+ * @brief Read only point in time view of an object_store
+ *
+ * A snapshot is taken with object_store::snapshot() in
+ * constant time. It shares all objects with the store
+ * until a transaction modifies or removes one of them.
+ * Then a copy of the object is kept for the snapshot, so
+ * memory only grows with the write set. Objects inserted
+ * after the snapshot was taken aren't visible.
+ *
+ * Modifications must go through a transaction or
+ * be marked with object_store::mark_modified to be
+ * tracked. Reader
+ * threads hold the store lock shared while accessing
+ * the snapshot (see object_store::concurrent_reads).
+ *
+ * Objects are copied as the type their prototype
+ * node was attached with. Types which aren't copy
+ * constructible can't be modified or removed while
+ * a snapshot is open. Relations of copied objects
+ * still point to the live objects of the store.
+ */
+class OOS_API snapshot
+{
+public:
+  /**
+   * Creates an empty snapshot.
+   */
+  snapshot();
+
+  /**
+   * Creates a snapshot for the given data.
+   *
+   * @param data The data of the snapshot
+   */
+  explicit snapshot(const std::shared_ptr<detail::snapshot_data> &data);
+
+  /**
+   * Returns true if the snapshot is bound
+   * to a store and the objects of the store
+   * weren't cleared since.
+   *
+   * @return True if the snapshot is valid
+   */
+  bool valid() const;
+
+  /**
+   * Returns the number of objects
+   * copied for this snapshot.
+   *
+   * @return The number of copied objects
+   */
+  std::size_t copied_objects() const;
+
+  /**
+   * Returns the object of type T with the given
+   * id as it was when the snapshot was taken.
+   *
+   * @tparam T The type of the object
+   * @param id The id of the object
+   * @return The object or nullptr if it didn't exist
+   */
+  template < class T >
+  const T* get(unsigned long id) const
+  {
+    if (!valid()) {
+      return nullptr;
+    }
+    detail::snapshot_data::t_frozen_map::const_iterator i = data_->frozen_.find(id);
+    if (i != data_->frozen_.end()) {
+      return static_cast<const T*>(i->second.object.get());
+    }
+    object_proxy *proxy = data_->find_live(id);
+    return proxy ? static_cast<const T*>(proxy->obj()) : nullptr;
+  }
+
+  /**
+   * Calls the given function for every object of
+   * type T (and its derived types) as it was when
+   * the snapshot was taken.
+   *
+   * @tparam T The type of the objects
+   * @tparam F The function type, called with (const T&)
+   * @param f The function to call
+   */
+  template < class T, class F >
+  void for_each(F f) const
+  {
+    if (!valid()) {
+      return;
+    }
+    prototype_node *node = data_->find_node(typeid(T).name());
+    if (!node) {
+      return;
+    }
+    for (object_proxy *proxy = node->op_first->next(); proxy != node->op_last; proxy = proxy->next()) {
+      if (proxy->obj() == nullptr || !data_->contains(proxy)) {
+        continue;
+      }
+      detail::snapshot_data::t_frozen_map::const_iterator i = data_->frozen_.find(proxy->id());
+      if (i != data_->frozen_.end()) {
+        f(*static_cast<const T*>(i->second.object.get()));
+      } else {
+        f(*static_cast<const T*>(proxy->obj()));
+      }
+    }
+    // objects removed since the snapshot was taken
+    for (const auto &frozen : data_->frozen_) {
+      if (frozen.second.node->is_child_of(node) && data_->find_live(frozen.first) == nullptr) {
+        f(*static_cast<const T*>(frozen.second.object.get()));
+      }
+    }
+  }
+
+private:
+  std::shared_ptr<detail::snapshot_data> data_;
+};
+
+}
+
+#endif //OOS_SNAPSHOT_HPP
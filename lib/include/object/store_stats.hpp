@@ -0,0 +1,48 @@
+#ifndef OOS_STORE_STATS_HPP
+#define OOS_STORE_STATS_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace oos {
+
+/**
+ * @brief Statistics of one prototype_node
+ *
+ * Counts and sizes cover the own objects of the
+ * node only, child nodes are reported separately.
+ * Object bytes are the shallow size of the objects,
+ * memory owned by their members isn't included.
+ */
+struct node_stats
+{
+  std::string type;               /**< The type name of the node */
+  std::size_t proxy_count = 0;    /**< Number of object proxies */
+  std::size_t object_count = 0;   /**< Number of proxies holding a loaded object */
+  std::size_t object_bytes = 0;   /**< Bytes held by the loaded objects */
+  std::size_t proxy_bytes = 0;    /**< Bytes held by the object proxies */
+  std::size_t id_map_size = 0;    /**< Number of entries in the primary key map */
+  std::size_t id_map_buckets = 0; /**< Number of buckets of the primary key map */
+  unsigned long inserts = 0;      /**< Number of inserted objects since attach */
+  unsigned long removes = 0;      /**< Number of removed objects since attach */
+  unsigned long lookups = 0;      /**< Number of proxy lookups by id or primary key since attach */
+};
+
+/**
+ * @brief Statistics of an object_store
+ *
+ * Returned by object_store::stats().
+ */
+struct store_stats
+{
+  std::size_t object_map_size = 0;     /**< Number of entries in the id to proxy map */
+  std::size_t object_map_capacity = 0; /**< Number of slots of the id to proxy map */
+  std::size_t proxy_pool_size = 0;     /**< Number of proxy slots in use */
+  std::size_t proxy_pool_capacity = 0; /**< Number of allocated proxy slots */
+  std::vector<node_stats> nodes;       /**< The statistics of all prototype nodes */
+};
+
+}
+
+#endif //OOS_STORE_STATS_HPP
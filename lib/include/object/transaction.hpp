@@ -12,6 +12,8 @@
 #include "object/update_action.hpp"
 #include "object/delete_action.hpp"
 #include "object/object_proxy.hpp"
+#include "object/snapshot.hpp"
+#include "object/write_guard.hpp"
 
 #include "tools/byte_buffer.hpp"
 #include "tools/sequencer.hpp"
@@ -60,6 +62,8 @@ public:
   typedef std::shared_ptr<action> action_ptr;      /**< Shortcut to an action shared pointer */
   typedef std::vector<action_ptr> t_action_vector; /**< Shortcut to a vector of action shared pointer */
 
+  class undo_log;
+
 public:
   /**
    * @brief Interface to an transaction observer
@@ -81,7 +85,10 @@ public:
      * @brief Interface for the commit transaction event
      *
      * The interface for the commit transaction event takes
-     * a vector of all actions to be commited.
+     * a vector of all actions to be commited. The actions
+     * are reduced to their net effect, i.e. an object
+     * inserted and deleted within the transaction doesn't
+     * appear at all (see action_coalescer).
      *
      * @param actions Actions to be commited.
      */
@@ -91,6 +98,64 @@ public:
      * @brief Interface for the rollback transaction event
      */
     virtual void on_rollback() = 0;
+
+    /**
+     * @brief Interface for the savepoint event
+     *
+     * Called when a savepoint is created. The observer
+     * may write the given actions, i.e. all actions made
+     * since the last written savepoint, and mark the
+     * savepoint on its own side. Written actions aren't
+     * passed to on_commit again. By default nothing is
+     * written and the savepoint only exists in the
+     * object store.
+     *
+     * @param sp The savepoint
+     * @param actions Actions made since the last written savepoint
+     * @return True if the actions were written
+     */
+    virtual bool on_savepoint(std::size_t, transaction::t_action_vector&) { return false; }
+
+    /**
+     * @brief Interface for the rollback to savepoint event
+     *
+     * Called for savepoints the observer has written only.
+     *
+     * @param sp The savepoint to roll back to
+     */
+    virtual void on_rollback_to(std::size_t) {}
+
+    /**
+     * @brief Interface for the release savepoint event
+     *
+     * Called for savepoints the observer has written only.
+     *
+     * @param sp The savepoint to release
+     */
+    virtual void on_release(std::size_t) {}
+
+    /**
+     * @brief Returns true if the last commit is durable
+     *
+     * Called after on_commit. If the committed changes
+     * aren't durable yet the observer is passed the undo
+     * log of the transaction (see on_pending).
+     *
+     * @return True if the changes of the last commit are durable
+     */
+    virtual bool durable() const { return true; }
+
+    /**
+     * @brief Interface for the pending commit event
+     *
+     * Called after on_commit if the committed changes
+     * aren't durable yet. The observer keeps the undo
+     * log until they are and rolls the changes back in
+     * the object store if they never become durable.
+     *
+     * @param log The undo log of the committed transaction
+     */
+    virtual void on_pending(const std::shared_ptr<undo_log>&) {}
   };
 
 public:
@@ -178,10 +243,64 @@ public:
    */
   void rollback();
 
+  /**
+   * @brief Marks the current state of the transaction
+   *
+   * Returns a savepoint which can be passed to
+   * rollback_to to revert all changes made after
+   * this call while keeping the changes made before.
+   * Savepoints are numbered in the order they are
+   * created, starting with zero.
+   *
+   * The observer is notified with the changes made
+   * since its last savepoint (see observer::on_savepoint),
+   * a session writes them to the database and creates a
+   * savepoint on its connection.
+   *
+   * @return The savepoint
+   */
+  std::size_t savepoint();
+
+  /**
+   * @brief Reverts all changes made after the savepoint
+   *
+   * Reverts all changes made after the given savepoint
+   * was created. The savepoint stays valid, all later
+   * savepoints are removed.
+   *
+   * @throw object_exception if the savepoint doesn't exist
+   * @param sp The savepoint to roll back to
+   */
+  void rollback_to(std::size_t sp);
+
+  /**
+   * @brief Releases the savepoint
+   *
+   * Releases the given savepoint and all later
+   * savepoints. The changes made after them are
+   * kept and can't be rolled back to them anymore.
+   *
+   * @throw object_exception if the savepoint doesn't exist
+   * @param sp The savepoint to release
+   */
+  void release(std::size_t sp);
+
   template < class T >
   void on_insert(object_proxy *proxy);
   template < class T >
+  void on_insert(const std::vector<object_proxy*> &proxies);
+  template < class T >
   void on_update(object_proxy *proxy);
+  /**
+   * Registers an object which was modified before
+   * it was passed to the transaction. The changed
+   * fields are unknown, so all of them are written.
+   *
+   * @tparam T The type of the object
+   * @param proxy The proxy of the modified object
+   */
+  template < class T >
+  void on_modified(object_proxy *proxy);
   template < class T >
   void on_delete(object_proxy *proxy);
 
@@ -189,10 +308,27 @@ private:
   typedef t_action_vector::iterator action_iterator;
   typedef std::unordered_map<unsigned long, t_action_vector::size_type> t_id_action_index_map;
 
+  struct transaction_data;
+
   void backup(const action_ptr &a, const object_proxy *proxy);
-  void restore(const action_ptr &a);
+  static void restore_all(transaction_data &data);
+  static void restore_from(transaction_data &data, t_action_vector::size_type first, byte_buffer::size_type offset);
 
   void cleanup();
+  void notify_observers(const t_action_vector &write_set);
+  void check_savepoint(std::size_t sp) const;
+  void mark_modified(object_proxy *proxy);
+
+  // index of the first action after the last savepoint
+  t_action_vector::size_type first_action() const;
+
+  void freeze(object_proxy *proxy)
+  {
+    detail::snapshot_registry *snapshots = proxy->snapshots();
+    if (snapshots && !snapshots->empty()) {
+      snapshots->freeze(proxy);
+    }
+  }
 
 private:
   struct null_observer : public observer, public action_visitor
@@ -206,6 +342,20 @@ private:
     virtual void visit(delete_action *act);
   };
 
+  /*
+   * A savepoint remembers the size of the action log
+   * and of the backup buffer. Objects are backed up
+   * again after a savepoint, so the id index map only
+   * holds the actions after the last savepoint.
+   */
+  struct savepoint_mark
+  {
+    t_action_vector::size_type actions;
+    byte_buffer::size_type bytes;
+    bool written;  // the observer wrote the actions before
+    bool released;
+  };
+
   struct transaction_data
   {
     transaction_data(object_store &store, std::shared_ptr<observer> obsrvr)
@@ -219,6 +369,9 @@ private:
 
     t_action_vector actions_;
     t_id_action_index_map id_action_index_map_;
+    std::vector<savepoint_mark> savepoints_;
+    // the actions before were written by the observer
+    t_action_vector::size_type written_ = 0;
 
     action_inserter inserter_;
     byte_buffer object_buffer_;
@@ -235,6 +388,40 @@ private:
   bool commiting_ = false;
 };
 
+/**
+ * @brief The undo log of a committed transaction
+ *
+ * The undo log takes the actions and the object backups
+ * of a committed transaction whose changes aren't durable
+ * yet. As long as it is kept the changes can be reverted
+ * in the object store.
+ */
+class OOS_API transaction::undo_log
+{
+public:
+  undo_log(const undo_log&) = delete;
+  undo_log& operator=(const undo_log&) = delete;
+
+  /**
+   * @brief Reverts the changes of the transaction
+   *
+   * Restores the objects of the object store to their
+   * state before the transaction. The undo logs of
+   * several transactions must be rolled back in the
+   * reverse order of their commits. No transaction
+   * may be active.
+   */
+  void rollback();
+
+private:
+  friend class transaction;
+
+  explicit undo_log(transaction_data &data);
+
+private:
+  transaction_data data_;
+};
+
 template < class T >
 void transaction::on_insert(object_proxy *proxy)
 {
@@ -248,7 +435,7 @@ void transaction::on_insert(object_proxy *proxy)
   t_id_action_index_map::iterator i = transaction_data_->id_action_index_map_.find(proxy->id());
   if (i == transaction_data_->id_action_index_map_.end()) {
     // create insert action and insert serializable
-    t_action_vector::size_type index = transaction_data_->inserter_.insert<T>(proxy);
+    t_action_vector::size_type index = transaction_data_->inserter_.insert<T>(proxy, first_action());
     if (index == transaction_data_->actions_.size()) {
       throw_object_exception("transaction: action for object with id " << proxy->id() << " couldn't be inserted");
     } else {
@@ -260,6 +447,31 @@ void transaction::on_insert(object_proxy *proxy)
   }
 }
 
+template < class T >
+void transaction::on_insert(const std::vector<object_proxy*> &proxies)
+{
+  /*****************
+   *
+   * backup a run of inserted objects
+   * of one type with one insert action
+   *
+   *****************/
+  if (proxies.empty()) {
+    return;
+  }
+  t_action_vector::size_type index = transaction_data_->inserter_.insert<T>(proxies, first_action());
+  if (index == transaction_data_->actions_.size()) {
+    throw_object_exception("transaction: action for object with id " << proxies.front()->id() << " couldn't be inserted");
+  }
+  transaction_data_->id_action_index_map_.reserve(transaction_data_->id_action_index_map_.size() + proxies.size());
+  for (object_proxy *proxy : proxies) {
+    if (!transaction_data_->id_action_index_map_.insert(std::make_pair(proxy->id(), index)).second) {
+      // ERROR: an serializable with that id already exists
+      throw_object_exception("transaction: an object with id " << proxy->id() << " already exists");
+    }
+  }
+}
+
 template < class T >
 void transaction::on_update(object_proxy *proxy)
 {
@@ -271,8 +483,12 @@ void transaction::on_update(object_proxy *proxy)
    *
    *****************/
   if (transaction_data_->id_action_index_map_.find(proxy->id()) == transaction_data_->id_action_index_map_.end()) {
+    detail::write_guard guard(transaction_data_->store_.get());
+    // keep the committed state for open snapshots
+    freeze(proxy);
     std::shared_ptr<update_action> ua(new update_action(proxy, (T*)proxy->obj()));
     backup(ua, proxy);
+    mark_modified(proxy);
   } else {
     // An serializable with that id already exists
     // do nothing because the serializable is already
@@ -280,6 +496,20 @@ void transaction::on_update(object_proxy *proxy)
   }
 }
 
+template < class T >
+void transaction::on_modified(object_proxy *proxy)
+{
+  if (transaction_data_->id_action_index_map_.find(proxy->id()) == transaction_data_->id_action_index_map_.end()) {
+    detail::write_guard guard(transaction_data_->store_.get());
+    proxy->mark_changed();
+    freeze(proxy);
+    std::shared_ptr<update_action> ua(new update_action(proxy, (T*)proxy->obj()));
+    ua->mark_all_modified();
+    backup(ua, proxy);
+    mark_modified(proxy);
+  }
+}
+
 template < class T >
 void transaction::on_delete(object_proxy *proxy)
 {
@@ -293,6 +523,7 @@ void transaction::on_delete(object_proxy *proxy)
    *****************/
   t_id_action_index_map::iterator i = transaction_data_->id_action_index_map_.find(proxy->id());
   if (i == transaction_data_->id_action_index_map_.end()) {
+    freeze(proxy);
     backup(std::make_shared<delete_action>(proxy, (T*)proxy->obj()), proxy);
   } else {
     action_remover ar(transaction_data_->actions_);
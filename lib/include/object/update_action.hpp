@@ -7,6 +7,7 @@
 
 #include "object/action.hpp"
 #include "object/delete_action.hpp"
+#include "object/field_recorder.hpp"
 
 namespace oos {
 
@@ -28,6 +29,7 @@ class OOS_API update_action : public action
 private:
   typedef void (*t_backup_func)(byte_buffer&, update_action*, object_serializer &serializer);
   typedef void (*t_restore_func)(byte_buffer&, update_action*, object_store*, object_serializer &serializer);
+  typedef void (*t_record_func)(update_action*, detail::t_field_values&);
 
 public:
   /**
@@ -41,7 +43,11 @@ public:
     , delete_action_(new delete_action(proxy, obj))
     , backup_func_(&backup_update<T, object_serializer>)
     , restore_func_(&restore_update<T, object_serializer>)
-  {}
+    , record_func_(&record_fields<T>)
+  {
+    // remember the values before the update to find the modified fields
+    record_func_(this, fields_);
+  }
 
   virtual void accept(action_visitor *av);
 
@@ -61,6 +67,22 @@ public:
 
   delete_action* release_delete_action();
 
+  /**
+   * Returns the names of the fields whose values
+   * changed since the update action was created.
+   * Has many relations aren't taken into account.
+   *
+   * @return The names of the modified fields
+   */
+  std::vector<std::string> modified_fields();
+
+  /**
+   * Marks all fields as modified. Used if the
+   * object was already modified when the action
+   * was created.
+   */
+  void mark_all_modified();
+
 private:
   template < class T, class S >
   static void backup_update(byte_buffer &buffer, update_action *act, S &serializer)
@@ -76,12 +98,23 @@ private:
     serializer.deserialize(obj, &buffer, store);
   }
 
+  template < class T >
+  static void record_fields(update_action *act, detail::t_field_values &values)
+  {
+    detail::field_recorder recorder;
+    recorder.record(*(T*)(act->proxy()->obj()), values);
+  }
+
 private:
   object_proxy *proxy_;
   std::unique_ptr<delete_action> delete_action_;
 
   t_backup_func backup_func_;
   t_restore_func restore_func_;
+  t_record_func record_func_;
+
+  detail::t_field_values fields_;
+  bool all_modified_ = false;
 };
 
 /// @endcond
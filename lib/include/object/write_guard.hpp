@@ -0,0 +1,63 @@
+#ifndef OOS_WRITE_GUARD_HPP
+#define OOS_WRITE_GUARD_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
+namespace oos {
+
+class object_store;
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * @class write_guard
+ * @brief Holds the store lock exclusively for one modification
+ *
+ * If concurrent reads are enabled the guard acquires
+ * the lock of the store exclusively for its lifetime.
+ * Guards nest and the store counts them, so it knows
+ * when it is in the middle of a modification (see
+ * object_store::may_evict). Once the outermost guard
+ * outside of a transaction is released the store
+ * publishes its new committed state to the readers
+ * (see object_store::committed).
+ */
+class OOS_API write_guard
+{
+public:
+  /**
+   * Acquires the lock of the given store
+   * if concurrent reads are enabled.
+   *
+   * @param store The store to modify
+   */
+  explicit write_guard(object_store &store);
+  ~write_guard();
+
+  write_guard(const write_guard&) = delete;
+  write_guard& operator=(const write_guard&) = delete;
+
+private:
+  object_store &store_;
+  bool locked_;
+};
+
+/// @endcond
+
+}
+}
+
+#endif //OOS_WRITE_GUARD_HPP
@@ -19,9 +19,12 @@
 #endif
 
 #include "object/identifier_proxy_map.hpp"
+#include "object/object_loader.hpp"
 
 #include <string>
 #include <functional>
+#include <mutex>
+#include <vector>
 
 namespace oos {
 
@@ -46,8 +49,12 @@ class persistence;
  *
  * This class acts as a base class for all kind
  * of tables (common table and relation table)
+ *
+ * A table can act as the loader of its prototype_node
+ * to fetch single objects on first access when the
+ * session was loaded lazily (see session::load).
  */
-class OOS_API basic_table
+class OOS_API basic_table : public detail::object_loader
 {
 public:
   typedef std::shared_ptr<basic_table> table_ptr;                                             /**< Shortcut to table shared pointer */
@@ -105,6 +112,30 @@ public:
    */
   virtual void load(object_store &p) = 0;
 
+  /**
+   * @brief Loads the primary keys of a table
+   *
+   * Inserts a proxy holding only the primary key
+   * for each row of the table into the given
+   * object_store. The objects are fetched on first
+   * access. Tables without primary keys load nothing.
+   *
+   * @param p The object_store to load the keys into
+   */
+  virtual void load_identifiers(object_store &p);
+
+  /**
+   * @brief Fetches the object of a proxy
+   *
+   * Fetches the row of the primary key of the given
+   * proxy and hands the object to the object_store.
+   * Tables without primary keys fetch nothing.
+   *
+   * @param proxy The proxy without an object
+   * @return True if the object was fetched
+   */
+  virtual bool fetch(object_proxy *proxy) override;
+
   /**
    * @brief Interface for inserting an object
    *
@@ -125,6 +156,18 @@ public:
    */
   virtual void update(object_proxy *proxy) = 0;
 
+  /**
+   * @brief Interface for updating some columns of an object
+   *
+   * Updates only the given columns of the object
+   * represented by the given object_proxy. The
+   * default implementation updates all columns.
+   *
+   * @param proxy The proxy representing the object to be updated
+   * @param columns The names of the modified columns
+   */
+  virtual void update(object_proxy *proxy, const std::vector<std::string> &columns);
+
   /**
    * @brief Interface for deleting an object
    *
@@ -156,6 +199,21 @@ protected:
   t_table_map::iterator begin_table();
   t_table_map::iterator end_table();
 
+  prototype_node* node() const;
+
+  /**
+   * Hands a lazily fetched object to the
+   * eviction policy of the persistence.
+   *
+   * @param proxy The proxy of the fetched object
+   * @param bytes The size of the object
+   */
+  void fetched(object_proxy *proxy, std::size_t bytes);
+
+  connection& conn();
+
+  std::recursive_mutex& connection_mutex();
+
   virtual void prepare(connection &conn) = 0;
 
   virtual void append_relation_items(const std::string &id, detail::t_identifier_map &identifier_proxy_map, basic_table::t_relation_item_map &has_many_relations);
@@ -0,0 +1,162 @@
+#ifndef OOS_COMMIT_GROUP_HPP
+#define OOS_COMMIT_GROUP_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+#define OOS_API __declspec(dllexport)
+#define EXPIMP_TEMPLATE
+#else
+#define OOS_API __declspec(dllimport)
+#define EXPIMP_TEMPLATE extern
+#endif
+#pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace oos {
+
+class connection;
+
+/**
+ * @brief Commits several transactions in one database transaction
+ *
+ * By default every committed transaction of a session is
+ * written within its own database transaction. Once group
+ * commit is enabled the first commit opens a database
+ * transaction which is shared by all following commits. It
+ * is committed when it holds the given number of transactions
+ * or when the given time window since it was opened elapsed,
+ * so the cost of making the changes durable is paid once
+ * per group.
+ *
+ * The statements of each transaction are still executed
+ * when it is committed, enclosed by a savepoint. If one of
+ * them fails only the changes of this transaction are
+ * rolled back and the other transactions of the group are
+ * kept. The future returned for a transaction becomes ready
+ * once the group was committed and holds the exception if
+ * the database commit failed. In that case the database
+ * transaction is rolled back and the changes of the whole
+ * group are lost in the database, while the object store
+ * already committed them.
+ *
+ * The time window is watched by a background thread which
+ * commits the database connection. It takes the given
+ * connection mutex like every other user of the connection
+ * (see persistence::connection_mutex).
+ */
+class OOS_API commit_group
+{
+public:
+  /**
+   * Creates a disabled commit group for
+   * the given database connection.
+   *
+   * @param conn The database connection
+   * @param conn_mutex The mutex guarding the connection
+   */
+  commit_group(connection &conn, std::recursive_mutex &conn_mutex);
+  ~commit_group();
+
+  commit_group(const commit_group&) = delete;
+  commit_group& operator=(const commit_group&) = delete;
+
+  /**
+   * Enables group commit. A group is committed once
+   * it holds batch_size transactions or once the time
+   * window elapsed. A batch size of zero doesn't limit
+   * the number of transactions, a window of zero doesn't
+   * limit the time.
+   *
+   * @param batch_size The maximum number of transactions of a group
+   * @param window The maximum time a group is kept open
+   */
+  void enable(std::size_t batch_size, std::chrono::milliseconds window);
+
+  /**
+   * Commits the open group and disables group commit.
+   */
+  void disable();
+
+  /**
+   * Returns true if group commit is enabled.
+   *
+   * @return True if group commit is enabled
+   */
+  bool enabled() const;
+
+  /**
+   * Executes the given function writing the changes
+   * of one transaction to the database. The function
+   * is called within a database transaction. If it
+   * throws, its changes are rolled back and the
+   * exception is passed on.
+   *
+   * @param write The function writing the changes
+   * @return A future ready once the changes are durable
+   */
+  std::shared_future<void> execute(const std::function<void()> &write);
+
+  /**
+   * Commits the open group immediately.
+   */
+  void flush();
+
+  /**
+   * Returns the number of transactions
+   * written to the open group.
+   *
+   * @return The number of pending transactions
+   */
+  std::size_t pending() const;
+
+  /**
+   * Returns the number of database commits
+   * issued since the group was created.
+   *
+   * @return The number of database commits
+   */
+  std::size_t commits() const;
+
+private:
+  void open_group();
+  void commit_group_locked();
+  void run();
+  void stop();
+
+private:
+  connection &connection_;
+  std::recursive_mutex &connection_mutex_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+  std::thread flusher_;
+  bool stop_ = false;
+
+  bool enabled_ = false;
+  std::size_t batch_size_ = 0;
+  std::chrono::milliseconds window_{0};
+
+  bool open_ = false;
+  std::chrono::steady_clock::time_point opened_;
+  std::size_t pending_ = 0;
+  std::size_t commits_ = 0;
+  unsigned long savepoints_ = 0;
+
+  std::shared_ptr<std::promise<void>> promise_;
+  std::shared_future<void> future_;
+};
+
+}
+
+#endif //OOS_COMMIT_GROUP_HPP
@@ -0,0 +1,154 @@
+#ifndef OOS_EVICTION_POLICY_HPP
+#define OOS_EVICTION_POLICY_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+#define OOS_API __declspec(dllexport)
+#define EXPIMP_TEMPLATE
+#else
+#define OOS_API __declspec(dllimport)
+#define EXPIMP_TEMPLATE extern
+#endif
+#pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
+#include <cstddef>
+#include <future>
+#include <list>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace oos {
+
+class object_proxy;
+class object_store;
+
+/**
+ * @brief Keeps the fetched objects within a memory budget
+ *
+ * The policy tracks all objects fetched lazily from
+ * their tables (see session::load). Once the tracked
+ * objects exceed the budget, the bodies of objects
+ * which weren't accessed since the last sweep are
+ * evicted (see object_store::evict) following the
+ * clock algorithm. The proxies and primary keys stay
+ * in the store and the objects are fetched again on
+ * next access.
+ *
+ * Objects are only evicted at a safe point of the
+ * store (see object_store::evict): while no transaction
+ * is active and the store lock can be acquired without
+ * waiting. A reader thread fetching an object leaves
+ * the eviction to the next safe point (see sweep).
+ * Changed objects are kept until their changes are
+ * durable in the database (see written), so objects
+ * modified outside of a transaction are never evicted.
+ */
+class OOS_API eviction_policy
+{
+public:
+  eviction_policy() {}
+
+  eviction_policy(const eviction_policy&) = delete;
+  eviction_policy& operator=(const eviction_policy&) = delete;
+
+  /**
+   * Sets the memory budget in bytes.
+   * A budget of zero disables eviction.
+   *
+   * @param bytes The memory budget
+   */
+  void budget(std::size_t bytes);
+
+  /**
+   * Returns the memory budget in bytes.
+   *
+   * @return The memory budget
+   */
+  std::size_t budget() const;
+
+  /**
+   * Returns the size of all tracked objects in bytes.
+   *
+   * @return The size of all tracked objects
+   */
+  std::size_t size() const;
+
+  /**
+   * Returns the number of evicted objects.
+   *
+   * @return The number of evicted objects
+   */
+  std::size_t evicted() const;
+
+  /**
+   * Tracks the freshly fetched object of the given
+   * proxy and evicts objects if the budget is exceeded.
+   *
+   * @param proxy The proxy of the fetched object
+   * @param bytes The size of the object
+   */
+  void loaded(object_proxy *proxy, std::size_t bytes);
+
+  /**
+   * Records the changes of a committed transaction.
+   * Once the given future is ready without an exception
+   * the changes are durable and the objects may be
+   * evicted again.
+   *
+   * @param done Ready once the changes are durable
+   * @param changes The ids of the written objects and their counts of changes
+   */
+  void written(const std::shared_future<void> &done, std::vector<std::pair<unsigned long, unsigned long>> changes);
+
+  /**
+   * Marks durable changes as written and evicts
+   * objects if the budget is exceeded. Does nothing
+   * if the calling thread isn't at a safe point.
+   *
+   * @param store The store of the tracked objects
+   */
+  void sweep(object_store &store);
+
+  /**
+   * Forgets all tracked objects.
+   */
+  void clear();
+
+private:
+  void sweep_locked(object_store &store);
+  void evict(object_store &store);
+
+private:
+  struct entry
+  {
+    unsigned long id;
+    std::size_t bytes;
+  };
+  typedef std::list<entry> t_entry_list;
+
+  t_entry_list clock_;
+  t_entry_list::iterator hand_ = clock_.end();
+
+  struct write
+  {
+    std::shared_future<void> done;
+    std::vector<std::pair<unsigned long, unsigned long>> changes;
+  };
+  std::list<write> writes_;
+
+  // objects are fetched by reader threads
+  // and swept by the writer concurrently
+  mutable std::mutex mutex_;
+
+  std::size_t budget_ = 0;
+  std::size_t size_ = 0;
+  std::size_t evicted_ = 0;
+};
+
+}
+
+#endif //OOS_EVICTION_POLICY_HPP
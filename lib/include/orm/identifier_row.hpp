@@ -0,0 +1,75 @@
+#ifndef OOS_IDENTIFIER_ROW_HPP
+#define OOS_IDENTIFIER_ROW_HPP
+
+#include "tools/access.hpp"
+#include "tools/basic_identifier.hpp"
+#include "tools/identifier_resolver.hpp"
+
+#include "orm/identifier_column_resolver.hpp"
+
+#include <memory>
+#include <string>
+
+namespace oos {
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * @class identifier_row
+ * @brief Holds the primary key column of a row of type T
+ *
+ * Used to select the primary keys of a table
+ * only. The identifier is of the same type as
+ * the identifier of T. If T has no primary key
+ * the row is empty.
+ *
+ * @tparam T The type of the table
+ */
+template < class T >
+class identifier_row
+{
+public:
+  identifier_row()
+  {
+    if (prototype()) {
+      id_.reset(prototype()->clone());
+    }
+  }
+
+  template < class S >
+  void serialize(S &serializer)
+  {
+    if (id_) {
+      serializer.serialize(column_name().c_str(), *id_);
+    }
+  }
+
+  /**
+   * Returns the name of the primary key column of T.
+   *
+   * @return The name of the primary key column
+   */
+  static const std::string& column_name()
+  {
+    static const std::string name(identifier_column_resolver::resolve<T>().name);
+    return name;
+  }
+
+  std::shared_ptr<basic_identifier> id_;
+
+private:
+  static const basic_identifier* prototype()
+  {
+    static const std::unique_ptr<basic_identifier> id(identifier_resolver<T>::resolve());
+    return id.get();
+  }
+};
+
+/// @endcond
+
+}
+}
+
+#endif //OOS_IDENTIFIER_ROW_HPP
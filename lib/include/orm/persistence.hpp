@@ -24,8 +24,11 @@
 
 #include "orm/table.hpp"
 #include "orm/relation_table.hpp"
+#include "orm/eviction_policy.hpp"
+#include "orm/commit_group.hpp"
 
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 
 namespace oos {
@@ -193,15 +196,66 @@ public:
    */
   const connection& conn() const;
 
+  /**
+   * @brief Return the mutex guarding the database connection
+   *
+   * Lazy fetches, the commit group and its flusher
+   * thread take this mutex while they use the database
+   * connection. Queries executed on the connection
+   * while other threads may use it must take it too.
+   *
+   * @return The mutex guarding the database connection.
+   */
+  std::recursive_mutex& connection_mutex();
+
+  /**
+   * @brief Return a reference to the eviction policy
+   *
+   * The policy keeps the objects fetched lazily
+   * within a memory budget (see eviction_policy).
+   *
+   * @return A reference to the eviction policy.
+   */
+  eviction_policy& eviction();
+
+  /**
+   * @brief Return a const reference to the eviction policy
+   *
+   * @return A const reference to the eviction policy.
+   */
+  const eviction_policy& eviction() const;
+
+  /**
+   * @brief Return a reference to the commit group
+   *
+   * Once enabled the commits of all sessions are
+   * grouped into shared database transactions
+   * (see commit_group).
+   *
+   * @return A reference to the commit group.
+   */
+  commit_group& group_commit();
+
+  /**
+   * @brief Return a const reference to the commit group
+   *
+   * @return A const reference to the commit group.
+   */
+  const commit_group& group_commit() const;
+
 private:
   template < class T >
   friend struct detail::persistence_on_attach;
 
 private:
   connection connection_;
+  std::recursive_mutex connection_mutex_;
+  commit_group group_commit_;
   object_store store_;
 
   t_table_map tables_;
+
+  eviction_policy eviction_;
 };
 
 namespace detail {
@@ -30,11 +30,20 @@ public:
   {}
 
   void resolve(object_proxy *proxy, object_store *store)
+  {
+    resolve(proxy, proxy->obj<T>(), store);
+  }
+
+  /*
+   * resolves the relations of an object which
+   * isn't published by its proxy yet
+   */
+  void resolve(object_proxy *proxy, T *obj, object_store *store)
   {
     store_ = store;
     id_ = proxy->pk();
     proxy_ = proxy;
-    oos::access::serialize(*this, *proxy->obj<T>());
+    oos::access::serialize(*this, *obj);
     proxy_ = nullptr;
     id_.reset();
     store_ = nullptr;
@@ -77,13 +86,19 @@ public:
        * proxy map. it will be used when
        * table is read.
        */
-      proxy = new object_proxy(pk, (T*)nullptr, node.get());
       basic_table::t_table_map::iterator j = table_.find_table(node->type());
 
       if (j == table_.end_table()) {
         throw_object_exception("unknown table " << node->type());
       }
-      j->second->identifier_proxy_map_.insert(std::make_pair(pk, proxy));
+      // an evicted object may be resolved again
+      detail::t_identifier_map::iterator k = j->second->identifier_proxy_map_.find(pk);
+      if (k != j->second->identifier_proxy_map_.end()) {
+        proxy = k->second;
+      } else {
+        proxy = new object_proxy(pk, (T*)nullptr, node.get());
+        j->second->identifier_proxy_map_.insert(std::make_pair(pk, proxy));
+      }
       x.reset(proxy, cascade);
     }
   }
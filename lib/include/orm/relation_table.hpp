@@ -91,6 +91,8 @@ public:
     };
     res.creator(func);
 
+    store.reserve(res.size());
+
     auto first = res.begin();
     auto last = res.end();
 
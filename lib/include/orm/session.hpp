@@ -23,8 +23,24 @@
 
 #include "orm/persistence.hpp"
 
+#include <deque>
+
 namespace oos {
 
+/**
+ * @brief Defines how a session loads the database
+ *
+ * When loaded lazily the objects are fetched one by one
+ * through the prepared statements of their tables on
+ * first access of an object_ptr or has_one.
+ */
+enum class load_mode
+{
+  EAGER, /**< Load all objects */
+  KEYS,  /**< Load the primary keys only */
+  NONE   /**< Load nothing */
+};
+
 /**
  * @brief Represents a session to a database
  *
@@ -50,7 +66,8 @@ namespace oos {
  * @endcode
  *
  * This session can also load the whole database into
- * the underlying object_store.
+ * the underlying object_store or load it lazily
+ * (see load_mode).
  */
 class OOS_API session
 {
@@ -100,11 +117,11 @@ public:
   object_ptr<T> update(const object_ptr<T> &optr)
   {
     if (store().has_transaction()) {
-      store().current_transaction().on_update<T>(optr.proxy_);
+      store().current_transaction().on_modified<T>(optr.proxy_);
     } else {
       transaction tr(persistence_.store(), observer_);
       tr.begin();
-      tr.on_update<T>(optr.proxy_);
+      tr.on_modified<T>(optr.proxy_);
       tr.commit();
     }
     return optr;
@@ -246,13 +263,62 @@ public:
    * @brief Loads all tables from database.
    *
    * Loads all tables from database. All object are inserted
-   * into the underlying object_store.
+   * into the underlying object_store. If the number of objects
+   * to be loaded is known it can be passed as a hint, so the
+   * object_store reserves its id lookup map ahead of time.
+   *
+   * @param expected_objects Number of objects expected to be loaded
+   */
+  void load(std::size_t expected_objects = 0);
+
+  /**
+   * @brief Loads the database in the given mode.
+   *
+   * With load_mode::KEYS a proxy holding only the
+   * primary key is inserted for each row, with
+   * load_mode::NONE nothing is inserted. The tables
+   * become the loaders of their prototype nodes and
+   * fetch an object once its object_ptr is dereferenced,
+   * objects not in the store yet are fetched with get().
+   * Types owning a has many relation can only be
+   * loaded eagerly.
+   *
+   * @param mode The load mode
+   * @param expected_objects Number of objects expected to be loaded
+   * @throws oos::object_exception if a lazily loaded type owns a has many relation
+   */
+  void load(load_mode mode, std::size_t expected_objects = 0);
+
+  /**
+   * @brief Returns the object with the given primary key.
+   *
+   * If the object isn't in the underlying object_store
+   * yet it is fetched from its table.
+   *
+   * @tparam T The type of the object
+   * @tparam V The type of the primary key value
+   * @param pk The primary key value
+   * @return The object or an empty object_ptr
+   * @throws oos::object_exception if there is no table for the type
    */
-  void load();
+  template < class T, class V >
+  object_ptr<T> get(const V &pk)
+  {
+    persistence::t_table_map::iterator i = persistence_.find_table(store().type<T>());
+    if (i == persistence_.end()) {
+      throw object_exception("couldn't find table");
+    }
+    object_proxy *proxy = static_cast<table<T>*>(i->second.get())->find(pk, store());
+    return proxy ? object_ptr<T>(proxy) : object_ptr<T>();
+  }
 
   /**
    * @brief Starts a transaction.
    *
+   * If no other transaction is active the changes of
+   * transactions whose group commit failed are rolled
+   * back in the object_store first (see last_commit).
+   *
    * @return The started transaction object
    */
   transaction begin();
@@ -271,8 +337,32 @@ public:
    */
   const object_store& store() const;
 
+  /**
+   * @brief Returns the future of the last commit
+   *
+   * The future becomes ready once the changes of the
+   * last committed transaction are durable. Without
+   * group commit this is the case as soon as the
+   * commit returns (see persistence::group_commit).
+   *
+   * With group commit the database commit of the group
+   * may fail after the transaction was committed to the
+   * object_store. Then the future holds the exception and
+   * the changes of all transactions of the group aren't
+   * stored in the database. The session keeps the undo logs
+   * of the transactions until their group is committed and
+   * rolls the changes back in the object_store when the next
+   * transaction begins. Changes of later groups to the same
+   * objects are reverted as well, in that case the caller
+   * should reload the session.
+   *
+   * @return The future of the last commit
+   */
+  std::shared_future<void> last_commit() const;
+
 private:
   void load(const persistence::table_ptr &table);
+  void undo_failed_commits();
 
 private:
   class session_observer : public transaction::observer, public action_visitor
@@ -282,12 +372,29 @@ private:
     virtual void on_begin();
     virtual void on_commit(transaction::t_action_vector &actions);
     virtual void on_rollback();
+    virtual bool on_savepoint(std::size_t sp, transaction::t_action_vector &actions);
+    virtual void on_rollback_to(std::size_t sp);
+    virtual void on_release(std::size_t sp);
+    virtual bool durable() const;
+    virtual void on_pending(const std::shared_ptr<transaction::undo_log> &log);
 
     virtual void visit(insert_action *act);
     virtual void visit(update_action *act);
     virtual void visit(delete_action *act);
+  private:
+    static std::string savepoint_name(std::size_t sp);
+    void open();
+    void write(transaction::t_action_vector &actions);
+    void close();
+
   private:
     session &session_;
+    // the written objects and their counts of changes
+    std::vector<std::pair<unsigned long, unsigned long>> changes_;
+    // held while the database transaction of a
+    // session without group commit is open
+    std::unique_lock<std::recursive_mutex> connection_lock_;
+    bool at_savepoint_ = false;
   };
 
 private:
@@ -295,6 +402,15 @@ private:
 
   std::shared_ptr<transaction::observer> observer_;
 
+  std::shared_future<void> last_commit_;
+
+  // the undo logs of the commits which aren't durable yet
+  struct pending_commit
+  {
+    std::shared_future<void> done;
+    std::shared_ptr<transaction::undo_log> log;
+  };
+  std::deque<pending_commit> pending_commits_;
 };
 
 }
@@ -7,15 +7,19 @@
 
 #include "object/object_proxy.hpp"
 #include "object/object_store.hpp"
+#include "object/field_recorder.hpp"
 
 #include "orm/basic_table.hpp"
 #include "orm/identifier_binder.hpp"
 #include "orm/identifier_column_resolver.hpp"
+#include "orm/identifier_row.hpp"
 #include "orm/relation_resolver.hpp"
 #include "orm/relation_item_appender.hpp"
 
 #include "sql/query.hpp"
 
+#include <list>
+
 namespace oos {
 
 class connection;
@@ -65,6 +69,10 @@ public:
   {
     auto result = select_.execute();
 
+    // backends knowing the row count ahead
+    // let the store reserve its id map once
+    store.reserve(result.size());
+
     auto first = result.begin();
     auto last = result.end();
 
@@ -92,6 +100,108 @@ public:
     is_loaded_ = true;
   }
 
+  virtual void load_identifiers(object_store &store) override
+  {
+    if (!has_identifier_) {
+      return;
+    }
+    select_identifiers_.reset();
+    auto result = select_identifiers_.execute();
+
+    store.reserve(result.size());
+
+    auto first = result.begin();
+    auto last = result.end();
+
+    while (first != last) {
+      std::unique_ptr<detail::identifier_row<T>> row(first.release());
+      ++first;
+
+      object_proxy *proxy = nullptr;
+      detail::t_identifier_map::iterator i = identifier_proxy_map_.find(row->id_);
+      if (i != identifier_proxy_map_.end()) {
+        // use proxy created by a relation
+        proxy = i->second;
+        identifier_proxy_map_.erase(i);
+      } else {
+        proxy = new object_proxy(row->id_, (T*)nullptr, node());
+      }
+      store.insert<T>(proxy, false);
+    }
+  }
+
+  virtual bool fetch(object_proxy *proxy) override
+  {
+    std::shared_ptr<basic_identifier> pk(proxy->pk());
+    if (!pk || !has_identifier_) {
+      return false;
+    }
+    // the connection may be used by reader threads
+    // and the commit group flusher at the same time,
+    // holding its mutex also fetches each object once
+    std::lock_guard<std::recursive_mutex> guard(connection_mutex());
+    if (proxy->obj() != nullptr) {
+      // fetched by another thread meanwhile
+      return true;
+    }
+    T *obj = select_identifier(*pk);
+    if (obj == nullptr) {
+      return false;
+    }
+    identifier_proxy_map_.erase(pk);
+
+    object_store *store = node()->tree();
+    store->load(proxy, obj, [&](T *o) { resolver_.resolve(proxy, o, store); });
+    fetched(proxy, sizeof(T));
+    return true;
+  }
+
+  /**
+   * @brief Finds an object by its primary key
+   *
+   * Returns the proxy of the object with the given
+   * primary key value. If the object isn't in the
+   * given object_store yet, its row is fetched and
+   * inserted into the store. The store is locked
+   * exclusively meanwhile, so the calling thread
+   * mustn't hold the store lock shared.
+   *
+   * @tparam V The type of the primary key value
+   * @param pk The primary key value
+   * @param store The object_store of the table
+   * @return The proxy of the object or nullptr
+   */
+  template < class V >
+  object_proxy* find(const V &pk, object_store &store)
+  {
+    // the fetched object may be inserted into the store
+    detail::write_guard store_guard(store);
+    std::lock_guard<std::recursive_mutex> guard(connection_mutex());
+    object_proxy *proxy = node()->find_proxy(pk);
+    if (proxy || !has_identifier_) {
+      return proxy;
+    }
+    V value(pk);
+    T *obj = select_identifier(value);
+    if (obj == nullptr) {
+      return nullptr;
+    }
+    std::unique_ptr<object_proxy> fetched_proxy(new object_proxy(obj));
+    detail::t_identifier_map::iterator i = identifier_proxy_map_.find(fetched_proxy->pk());
+    if (i != identifier_proxy_map_.end()) {
+      // use proxy created by a relation
+      proxy = i->second;
+      identifier_proxy_map_.erase(i);
+      fetched_proxy->reset((T*)nullptr);
+      proxy = store.load(proxy, obj, [&](T *o) { resolver_.resolve(proxy, o, &store); });
+    } else {
+      proxy = store.insert<T>(fetched_proxy.release(), false);
+      resolver_.resolve(proxy, &store);
+    }
+    fetched(proxy, sizeof(T));
+    return proxy;
+  }
+
   virtual void insert(object_proxy *proxy) override
   {
     insert_.bind((T*)proxy->obj(), 0);
@@ -108,6 +218,23 @@ public:
     update_.execute();
   }
 
+  virtual void update(object_proxy *proxy, const std::vector<std::string> &columns) override
+  {
+    if (columns.empty()) {
+      return;
+    }
+    if (columns.size() >= column_count_) {
+      update(proxy);
+      return;
+    }
+    T *obj = (T*)proxy->obj();
+    statement<T> &stmt = partial_update(columns);
+    size_t pos = stmt.bind(obj, 0, columns);
+    binder_.bind(obj, &stmt, pos);
+    // Todo: check result
+    stmt.execute();
+  }
+
   virtual void remove(object_proxy *proxy) override
   {
     binder_.bind((T*)proxy->obj(), &delete_, 0);
@@ -122,6 +249,8 @@ protected:
    * Prepares the table object for the given connection.
    * Subsequently some prepared statements are created:
    * - select
+   * - select by primary key
+   * - select primary keys
    * - insert
    * - update
    * - delete
@@ -137,8 +266,20 @@ protected:
     insert_ = q.insert().prepare(conn);
     column id = detail::identifier_column_resolver::resolve<T>();
     update_ = q.update().where(id == 1).prepare(conn);
+    partial_updates_.clear();
+    T obj;
+    detail::t_field_values fields;
+    detail::field_recorder recorder;
+    recorder.record(obj, fields);
+    column_count_ = fields.size();
     delete_ = q.remove().where(id == 1).prepare(conn);
     select_ = q.select().prepare(conn);
+    has_identifier_ = !id.name.empty();
+    if (has_identifier_) {
+      select_identifier_ = q.select().where(id == 1).prepare(conn);
+      query<detail::identifier_row<T>> iq(name());
+      select_identifiers_ = iq.select({detail::identifier_row<T>::column_name()}).prepare(conn);
+    }
   }
 
   /**
@@ -155,13 +296,62 @@ protected:
     appender_.append(id, identifier_proxy_map, &has_many_relations);
   }
 
+private:
+  /*
+   * Returns the prepared update statement for the
+   * given columns. The statements of the most recently
+   * used column sets are kept, the least recently
+   * used one is dropped once the cache is full.
+   */
+  statement<T>& partial_update(const std::vector<std::string> &columns)
+  {
+    for (auto i = partial_updates_.begin(); i != partial_updates_.end(); ++i) {
+      if (i->first == columns) {
+        partial_updates_.splice(partial_updates_.begin(), partial_updates_, i);
+        return partial_updates_.front().second;
+      }
+    }
+    if (partial_updates_.size() >= max_partial_updates) {
+      partial_updates_.pop_back();
+    }
+    query<T> q(name());
+    column id = detail::identifier_column_resolver::resolve<T>();
+    T obj;
+    partial_updates_.emplace_front(columns, q.update(obj, columns).where(id == 1).prepare(conn()));
+    return partial_updates_.front().second;
+  }
+
+  template < class V >
+  T* select_identifier(V &value)
+  {
+    select_identifier_.reset();
+    select_identifier_.bind(value, 0);
+    T *obj = nullptr;
+    {
+      auto result = select_identifier_.execute();
+      auto first = result.begin();
+      if (first != result.end()) {
+        obj = first.release();
+      }
+    }
+    // don't keep the table locked by the pending statement
+    select_identifier_.reset();
+    return obj;
+  }
+
 private:
   detail::identifier_binder<T> binder_;
 
   statement<T> insert_;
   statement<T> update_;
+  std::list<std::pair<std::vector<std::string>, statement<T>>> partial_updates_;
+  std::size_t column_count_ = 0;
+  static const std::size_t max_partial_updates = 8;
   statement<T> delete_;
   statement<T> select_;
+  statement<T> select_identifier_;
+  statement<detail::identifier_row<T>> select_identifiers_;
+  bool has_identifier_ = false;
 
   detail::relation_resolver<T> resolver_;
   detail::relation_item_appender<T> appender_;
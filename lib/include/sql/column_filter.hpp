@@ -0,0 +1,81 @@
+#ifndef OOS_COLUMN_FILTER_HPP
+#define OOS_COLUMN_FILTER_HPP
+
+#ifdef _MSC_VER
+#ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+#define OOS_API
+#endif
+
+#include "tools/serializer.hpp"
+
+#include <string>
+#include <vector>
+
+namespace oos {
+
+namespace detail {
+
+/// @cond OOS_DEV
+
+/**
+ * @class column_filter
+ * @brief Passes only the given columns to a serializer
+ *
+ * The filter forwards all fields of an object whose
+ * names are in the given list of columns to the
+ * wrapped serializer and skips the others. It is
+ * used to build and bind statements for a subset
+ * of the columns, i.e. updates of modified fields.
+ */
+class OOS_API column_filter : public serializer
+{
+public:
+  /**
+   * Creates a filter for the given serializer.
+   *
+   * @param target The serializer to forward to
+   * @param columns The names of the columns to forward
+   */
+  column_filter(serializer &target, const std::vector<std::string> &columns);
+
+  virtual void serialize(const char *id, char &x) override;
+  virtual void serialize(const char *id, short &x) override;
+  virtual void serialize(const char *id, int &x) override;
+  virtual void serialize(const char *id, long &x) override;
+  virtual void serialize(const char *id, unsigned char &x) override;
+  virtual void serialize(const char *id, unsigned short &x) override;
+  virtual void serialize(const char *id, unsigned int &x) override;
+  virtual void serialize(const char *id, unsigned long &x) override;
+  virtual void serialize(const char *id, bool &x) override;
+  virtual void serialize(const char *id, float &x) override;
+  virtual void serialize(const char *id, double &x) override;
+  virtual void serialize(const char *id, char *x, size_t s) override;
+  virtual void serialize(const char *id, std::string &x) override;
+  virtual void serialize(const char *id, varchar_base &x) override;
+  virtual void serialize(const char *id, time &x) override;
+  virtual void serialize(const char *id, date &x) override;
+  virtual void serialize(const char *id, basic_identifier &x) override;
+  virtual void serialize(const char *id, identifiable_holder &x, cascade_type cascade) override;
+
+private:
+  bool accepts(const char *id) const;
+
+private:
+  serializer &target_;
+  const std::vector<std::string> &columns_;
+};
+
+/// @endcond
+
+}
+}
+
+#endif //OOS_COLUMN_FILTER_HPP
@@ -80,6 +80,27 @@ public:
    */
   void rollback();
 
+  /**
+   * @brief Executes the SAVEPOINT sql command
+   *
+   * @param name The name of the savepoint
+   */
+  void savepoint(const std::string &name);
+
+  /**
+   * @brief Executes the ROLLBACK TO SAVEPOINT sql command
+   *
+   * @param name The name of the savepoint
+   */
+  void rollback_to(const std::string &name);
+
+  /**
+   * @brief Executes the RELEASE SAVEPOINT sql command
+   *
+   * @param name The name of the savepoint
+   */
+  void release(const std::string &name);
+
   /**
    * @brief Return the database type of the connection.
    *
@@ -53,6 +53,10 @@ public:
   virtual void commit() = 0;
   virtual void rollback() = 0;
 
+  virtual void savepoint(const std::string &name) = 0;
+  virtual void rollback_to(const std::string &name) = 0;
+  virtual void release(const std::string &name) = 0;
+
   virtual std::string type() const = 0;
   virtual std::string version() const = 0;
 
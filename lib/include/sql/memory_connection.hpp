@@ -30,6 +30,12 @@ public:
 
   virtual void rollback() override {}
 
+  virtual void savepoint(const std::string &) override {}
+
+  virtual void rollback_to(const std::string &) override {}
+
+  virtual void release(const std::string &) override {}
+
   virtual std::string type() const override { return "memory"; };
   virtual std::string version() const override { return "0.5.0"; };
 
@@ -276,6 +276,34 @@ public:
     return *this;
   }
 
+  /**
+   * Creates an update statement which sets
+   * only the given columns of the object.
+   *
+   * @param obj The object to be updated.
+   * @param columns The names of the columns to update.
+   * @return A reference to the query.
+   */
+  query& update(T &obj, const std::vector<std::string> &columns)
+  {
+    reset(t_query_command::UPDATE);
+
+    sql_.append(new detail::update);
+    sql_.append(new detail::tablename(table_name_));
+    sql_.append(new detail::set);
+    sql_.append(update_columns_);
+
+    state = QUERY_UPDATE;
+
+    detail::value_column_serializer vcserializer;
+
+    vcserializer.append_to(update_columns_, obj, columns);
+
+    state = QUERY_SET;
+
+    return *this;
+  }
+
   query& update(const std::initializer_list<std::pair<std::string, oos::any>> &colvalues)
   {
     reset(t_query_command::UPDATE);
@@ -94,6 +94,11 @@ public:
     return p->bind(o, pos);
   }
 
+  size_t bind(T *o, size_t pos, const std::vector<std::string> &columns)
+  {
+    return p->bind(o, pos, columns);
+  }
+
   template < class V >
   size_t bind(V &val, size_t pos)
   {
@@ -8,6 +8,7 @@
 #include "tools/varchar.hpp"
 
 #include "sql/result.hpp"
+#include "sql/column_filter.hpp"
 
 #ifdef _MSC_VER
 #ifdef oos_EXPORTS
@@ -50,6 +51,16 @@ public:
     return host_index;
   }
 
+  template < class T >
+  size_t bind(T *o, size_t pos, const std::vector<std::string> &columns)
+  {
+    reset();
+    host_index = pos;
+    column_filter filter(*this, columns);
+    oos::access::serialize(static_cast<serializer&>(filter), *o);
+    return host_index;
+  }
+
   template < class T >
   size_t bind(T &val, size_t pos)
   {
@@ -23,6 +23,7 @@
 #include "tools/serializer.hpp"
 
 #include "sql/column.hpp"
+#include "sql/column_filter.hpp"
 
 namespace oos {
 
@@ -43,6 +44,14 @@ public:
     oos::access::serialize(static_cast<serializer&>(*this), x);
   }
 
+  template<class T>
+  void append_to(const std::shared_ptr<columns> cols, T &x, const std::vector<std::string> &names)
+  {
+    cols_ = cols;
+    column_filter filter(*this, names);
+    oos::access::serialize(static_cast<serializer&>(filter), x);
+  }
+
   void serialize(const char *id, char &x);
   void serialize(const char *id, short &x);
   void serialize(const char *id, int &x);
@@ -31,8 +31,8 @@
   #define OOS_API
 #endif
 
-#include <array>
-#include <list>
+#include <cstddef>
+#include <vector>
 
 namespace oos {
 
@@ -47,28 +47,39 @@ namespace oos {
  * The bytes are appended and released from the end
  * of the buffer.
  * It is used by the object_store to serialize objects.
+ *
+ * The chunks are taken from and returned to a pool
+ * of the current thread. A chunk is at least 16 KB
+ * large, bigger appends get one chunk large enough
+ * for all of their bytes. Once the buffers of a thread
+ * reached their steady state size appending and
+ * clearing doesn't allocate memory anymore.
  */
 class OOS_API byte_buffer
 {
-private:
-  enum { BUF_SIZE = 1 << 14 };
-  typedef std::array<char, BUF_SIZE> t_data_array;
-
 public:
   /**
    * The type of the size.
    */
-  typedef t_data_array::size_type size_type;
+  typedef std::size_t size_type;
+
+  /**
+   * The minimal size of a chunk.
+   */
+  static const size_type chunk_size = 1 << 14;
 
   /**
    * @brief Create an empty buffer.
    * 
-   * Create an empty buffer. One empty chunk is
-   * also created.
+   * Create an empty buffer. The first chunk
+   * is taken from the pool on the first append.
    */
   byte_buffer();
   ~byte_buffer();
 
+  byte_buffer(const byte_buffer&) = delete;
+  byte_buffer& operator=(const byte_buffer&) = delete;
+
   /**
    * @brief Append an amount of bytes.
    * 
@@ -90,29 +101,85 @@ public:
    */
   void release(void *bytes, size_type size);
 
+  /**
+   * @brief Reserves space for a number of bytes.
+   *
+   * Makes sure the next size bytes can be appended
+   * without taking another chunk. If the current chunk
+   * is too small its remaining space is left unused.
+   *
+   * @param size The number of bytes to reserve.
+   */
+  void reserve(size_type size);
+
+  /**
+   * @brief Moves the end of the buffer to another buffer.
+   *
+   * All bytes behind the first offset bytes of the
+   * buffer are appended to tail and removed from
+   * this buffer. Afterwards the size of the buffer
+   * is offset. Nothing happens if the buffer isn't
+   * larger than offset.
+   *
+   * @param offset The number of bytes to keep.
+   * @param tail The buffer receiving the remaining bytes.
+   */
+  void split(size_type offset, byte_buffer &tail);
+
   /**
    * Return the size of the buffer.
    */
   size_type size() const;
 
   /**
-   * Clear the buffer.
+   * Clear the buffer. All chunks are
+   * returned to the pool of the thread.
    */
   void clear();
 
+  /**
+   * Returns the number of bytes held by
+   * the chunk pool of the current thread.
+   *
+   * @return The number of pooled bytes
+   */
+  static size_type pooled_bytes();
+
+  /**
+   * Sets the maximum number of bytes the chunk
+   * pool of the current thread keeps for reuse.
+   * Chunks returned to a full pool are freed.
+   *
+   * @param limit The maximum number of pooled bytes
+   */
+  static void pool_limit(size_type limit);
+
 private:
   struct buffer_chunk
   {
-    buffer_chunk() : read_cursor(0), write_cursor(0) {}
-    byte_buffer::size_type available() const { return data.size() - write_cursor; }
+    explicit buffer_chunk(size_type cap) : data(new char[cap]), capacity(cap), read_cursor(0), write_cursor(0) {}
+    ~buffer_chunk() { delete [] data; }
+    byte_buffer::size_type available() const { return capacity - write_cursor; }
     byte_buffer::size_type used() const { return write_cursor - read_cursor; }
-    byte_buffer::size_type released() const { return read_cursor; }
-    t_data_array data;
+    char *data;
+    byte_buffer::size_type capacity;
     byte_buffer::size_type read_cursor;
     byte_buffer::size_type write_cursor;
   };
-  typedef std::list<buffer_chunk> t_chunk_list;
-  t_chunk_list chunk_list_;
+
+  class chunk_pool;
+
+  static chunk_pool& pool();
+
+  void add_chunk(size_type size);
+  static void recycle(buffer_chunk *chunk);
+
+private:
+  typedef std::vector<buffer_chunk*> t_chunk_vector;
+  // chunks before first_ are released and returned to the pool
+  t_chunk_vector chunks_;
+  t_chunk_vector::size_type first_ = 0;
+  size_type size_ = 0;
 };
 /// @endcond
 
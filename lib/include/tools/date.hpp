@@ -14,6 +14,7 @@
 #define OOS_API
 #endif
 
+#include <functional>
 #include <iostream>
 
 namespace oos {
@@ -382,4 +383,20 @@ private:
 
 }
 
+namespace std {
+
+/**
+ * Hashes a date by its julian date
+ */
+template <>
+struct hash<oos::date>
+{
+  size_t operator()(const oos::date &d) const
+  {
+    return hash<int>()(d.julian_date());
+  }
+};
+
+}
+
 #endif /* DATE_HPP */
@@ -0,0 +1,383 @@
+#ifndef OOS_FLAT_HASH_MAP_HPP
+#define OOS_FLAT_HASH_MAP_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace oos {
+
+/**
+ * @class flat_hash_map
+ * @brief Open addressing hash map for integral keys
+ *
+ * The map stores its key value pairs in one contiguous
+ * array and resolves collisions by linear probing with
+ * robin hood displacement, so unsuccessful lookups stop
+ * early. On erase the following entries are shifted
+ * backwards, so no tombstones are left behind.
+ *
+ * One key value (default is zero) marks an empty slot
+ * and can't be inserted. This fits object ids where
+ * zero stands for "no id".
+ *
+ * Ascending ids are placed into consecutive slots, so
+ * lookups of neighbouring ids touch neighbouring memory.
+ *
+ * @tparam K The integral key type
+ * @tparam V The value type
+ */
+template < class K, class V >
+class flat_hash_map
+{
+public:
+  static_assert(std::is_integral<K>::value, "key type must be integral");
+
+  typedef K key_type;                      /**< Shortcut for the key type */
+  typedef V mapped_type;                   /**< Shortcut for the mapped type */
+  typedef std::pair<K, V> value_type;      /**< Shortcut for the value type */
+  typedef std::size_t size_type;           /**< Shortcut for the size type */
+  typedef std::vector<value_type> t_slot_vector; /**< Shortcut for the slot vector */
+
+  /**
+   * @brief Forward iterator over all occupied slots
+   *
+   * @tparam VT Value type (const or non const)
+   */
+  template < class VT >
+  class basic_iterator : public std::iterator<std::forward_iterator_tag, VT>
+  {
+  public:
+    basic_iterator() {}
+    basic_iterator(VT *current, VT *last, K empty)
+      : current_(current), last_(last), empty_(empty)
+    {
+      skip();
+    }
+
+    /**
+     * Converts a non const iterator into a const iterator
+     *
+     * @param x The iterator to convert
+     */
+    template < class OVT, typename = typename std::enable_if<std::is_convertible<OVT*, VT*>::value>::type >
+    basic_iterator(const basic_iterator<OVT> &x)
+      : current_(x.current_), last_(x.last_), empty_(x.empty_)
+    {}
+
+    basic_iterator& operator++()
+    {
+      ++current_;
+      skip();
+      return *this;
+    }
+
+    basic_iterator operator++(int)
+    {
+      basic_iterator tmp(*this);
+      ++(*this);
+      return tmp;
+    }
+
+    VT& operator*() const { return *current_; }
+    VT* operator->() const { return current_; }
+
+    bool operator==(const basic_iterator &x) const { return current_ == x.current_; }
+    bool operator!=(const basic_iterator &x) const { return current_ != x.current_; }
+
+  private:
+    friend class flat_hash_map;
+    template < class OVT > friend class basic_iterator;
+
+    void skip()
+    {
+      while (current_ != last_ && current_->first == empty_) {
+        ++current_;
+      }
+    }
+
+    VT *current_ = nullptr;
+    VT *last_ = nullptr;
+    K empty_ = K();
+  };
+
+  typedef basic_iterator<value_type> iterator;             /**< Shortcut for the iterator */
+  typedef basic_iterator<const value_type> const_iterator; /**< Shortcut for the const iterator */
+
+public:
+  /**
+   * Creates an empty map
+   *
+   * @param empty The key marking an empty slot
+   */
+  explicit flat_hash_map(K empty = K())
+    : empty_(empty)
+  {}
+
+  /**
+   * Returns the number of elements
+   *
+   * @return The number of elements
+   */
+  size_type size() const { return size_; }
+
+  /**
+   * Returns true if the map is empty
+   *
+   * @return True if the map is empty
+   */
+  bool empty() const { return size_ == 0; }
+
+  /**
+   * Returns the number of slots.
+   *
+   * @return The number of slots
+   */
+  size_type capacity() const { return slots_.size(); }
+
+  /**
+   * Makes room for at least n elements
+   * without further rehashing.
+   *
+   * @param n Number of elements to reserve room for
+   */
+  void reserve(size_type n)
+  {
+    size_type required = slot_count(n);
+    if (required > slots_.size()) {
+      rehash(required);
+    }
+  }
+
+  /**
+   * Removes all elements. The slots
+   * are kept for further inserts.
+   */
+  void clear()
+  {
+    if (size_ == 0) {
+      return;
+    }
+    for (value_type &slot : slots_) {
+      slot.first = empty_;
+      slot.second = V();
+    }
+    size_ = 0;
+  }
+
+  iterator begin() { return iterator(first_slot(), last_slot(), empty_); }
+  iterator end() { return iterator(last_slot(), last_slot(), empty_); }
+  const_iterator begin() const { return const_iterator(first_slot(), last_slot(), empty_); }
+  const_iterator end() const { return const_iterator(last_slot(), last_slot(), empty_); }
+
+  /**
+   * Inserts the given key value pair. If the key
+   * already exists the map is left untouched and the
+   * iterator of the existing element is returned.
+   *
+   * @param value The key value pair to insert
+   * @return The iterator of the element and true if it was inserted
+   * @throws std::invalid_argument if the key marks empty slots
+   */
+  std::pair<iterator, bool> insert(const value_type &value)
+  {
+    if (value.first == empty_) {
+      throw std::invalid_argument("flat_hash_map: key is reserved for empty slots");
+    }
+    value_type *slot = lookup(value.first);
+    if (slot != nullptr) {
+      return std::make_pair(make_iterator(slot), false);
+    }
+    if (slot_count(size_ + 1) > slots_.size()) {
+      rehash(slot_count(size_ + 1));
+    }
+    slot = place(value);
+    ++size_;
+    return std::make_pair(make_iterator(slot), true);
+  }
+
+  /**
+   * Finds the element with the given key.
+   *
+   * @param key The key to find
+   * @return The element iterator or end
+   */
+  iterator find(K key)
+  {
+    value_type *slot = lookup(key);
+    return slot ? make_iterator(slot) : end();
+  }
+
+  /**
+   * Finds the element with the given key.
+   *
+   * @param key The key to find
+   * @return The element iterator or end
+   */
+  const_iterator find(K key) const
+  {
+    const value_type *slot = const_cast<flat_hash_map*>(this)->lookup(key);
+    return slot ? const_iterator(slot, last_slot(), empty_) : end();
+  }
+
+  /**
+   * Returns the number of elements
+   * with the given key (0 or 1)
+   *
+   * @param key The key to count
+   * @return The number of elements
+   */
+  size_type count(K key) const
+  {
+    return const_cast<flat_hash_map*>(this)->lookup(key) ? 1 : 0;
+  }
+
+  /**
+   * Erases the element with the given key.
+   *
+   * @param key The key to erase
+   * @return The number of erased elements
+   */
+  size_type erase(K key)
+  {
+    value_type *slot = lookup(key);
+    if (slot == nullptr) {
+      return 0;
+    }
+    erase_slot(static_cast<size_type>(slot - slots_.data()));
+    return 1;
+  }
+
+  /**
+   * Erases the element at the given iterator.
+   * Other iterators may be invalidated because
+   * following elements are shifted backwards.
+   *
+   * @param i The iterator of the element to erase
+   */
+  void erase(const_iterator i)
+  {
+    erase_slot(static_cast<size_type>(i.current_ - slots_.data()));
+  }
+
+private:
+  static const size_type min_slots = 16;
+
+  // keep the load factor below 3/4
+  static size_type slot_count(size_type n)
+  {
+    size_type count = min_slots;
+    while (count - count / 4 < n) {
+      count <<= 1;
+    }
+    return count;
+  }
+
+  size_type index(K key) const
+  {
+    std::size_t h = static_cast<std::size_t>(key);
+    // fold the high bits into the low bits used by the mask
+    h ^= h >> 16;
+    h ^= h >> 16 >> 16;
+    return h & (slots_.size() - 1);
+  }
+
+  // distance of the element in slot i from its home slot
+  size_type distance(size_type i) const
+  {
+    return (i - index(slots_[i].first)) & (slots_.size() - 1);
+  }
+
+  value_type* lookup(K key)
+  {
+    if (key == empty_ || size_ == 0) {
+      return nullptr;
+    }
+    size_type mask = slots_.size() - 1;
+    size_type i = index(key);
+    for (size_type d = 0; slots_[i].first != empty_; ++d) {
+      if (slots_[i].first == key) {
+        return &slots_[i];
+      }
+      // robin hood invariant: key would have been placed here
+      if (distance(i) < d) {
+        break;
+      }
+      i = (i + 1) & mask;
+    }
+    return nullptr;
+  }
+
+  // inserts a value which isn't in the map yet and
+  // returns the slot where the value was placed
+  value_type* place(value_type value)
+  {
+    size_type mask = slots_.size() - 1;
+    size_type i = index(value.first);
+    value_type *placed = nullptr;
+    for (size_type d = 0; slots_[i].first != empty_; ++d) {
+      size_type existing = distance(i);
+      if (existing < d) {
+        // take the slot from the richer element
+        // and carry on with the displaced one
+        std::swap(value, slots_[i]);
+        if (placed == nullptr) {
+          placed = &slots_[i];
+        }
+        d = existing;
+      }
+      i = (i + 1) & mask;
+    }
+    slots_[i] = value;
+    return placed ? placed : &slots_[i];
+  }
+
+  void erase_slot(size_type i)
+  {
+    size_type mask = slots_.size() - 1;
+    size_type j = (i + 1) & mask;
+    // shift following elements back until an
+    // empty slot or an element at its home is found
+    while (slots_[j].first != empty_ && distance(j) > 0) {
+      slots_[i] = slots_[j];
+      i = j;
+      j = (j + 1) & mask;
+    }
+    slots_[i].first = empty_;
+    slots_[i].second = V();
+    --size_;
+  }
+
+  void rehash(size_type count)
+  {
+    t_slot_vector old(count, value_type(empty_, V()));
+    old.swap(slots_);
+    for (const value_type &slot : old) {
+      if (slot.first != empty_) {
+        place(slot);
+      }
+    }
+  }
+
+  iterator make_iterator(value_type *slot)
+  {
+    return iterator(slot, last_slot(), empty_);
+  }
+
+  value_type* first_slot() { return slots_.data(); }
+  value_type* last_slot() { return slots_.data() + slots_.size(); }
+  const value_type* first_slot() const { return slots_.data(); }
+  const value_type* last_slot() const { return slots_.data() + slots_.size(); }
+
+private:
+  t_slot_vector slots_;
+  size_type size_ = 0;
+  K empty_;
+};
+
+}
+
+#endif //OOS_FLAT_HASH_MAP_HPP
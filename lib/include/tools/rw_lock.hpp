@@ -0,0 +1,257 @@
+#ifndef OOS_RW_LOCK_HPP
+#define OOS_RW_LOCK_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
+namespace oos {
+
+/**
+ * @class rw_lock
+ * @brief Reader writer lock with striped reader counters
+ *
+ * Any number of readers can hold the lock at the
+ * same time while a writer holds it exclusively.
+ * Each reader thread counts itself on one of several
+ * cache line sized stripes, so readers of different
+ * threads don't contend on one atomic word. A writer
+ * raises its flag and waits until all stripes are
+ * drained. Waiting writers are preferred, new readers
+ * wait until the writer is done. A thread which can't
+ * get the lock spins shortly and then blocks on a
+ * condition variable until the lock is released.
+ *
+ * The exclusive lock is recursive for the owning thread,
+ * which may also acquire the lock shared. A shared lock
+ * must be released by the thread which acquired it. The
+ * class meets the Lockable requirements, so it can be
+ * used with std::lock_guard for exclusive locking.
+ */
+class rw_lock
+{
+public:
+  rw_lock() {}
+
+  rw_lock(const rw_lock&) = delete;
+  rw_lock& operator=(const rw_lock&) = delete;
+
+  /**
+   * Acquires the lock shared.
+   */
+  void lock_shared()
+  {
+    while (!try_lock_shared()) {
+      wait([this]() { return !writer_.load(); });
+    }
+  }
+
+  /**
+   * Tries to acquire the lock shared.
+   *
+   * @return True if the lock was acquired
+   */
+  bool try_lock_shared()
+  {
+    std::atomic<unsigned long> &readers = stripes_[stripe_index()].readers;
+    readers.fetch_add(1);
+    // announced before the writer flag is checked, so a
+    // writer either sees the reader or the reader sees
+    // the writer (all operations are seq_cst)
+    if (!writer_.load() || owned()) {
+      return true;
+    }
+    // the writer may wait for the readers to leave
+    readers.fetch_sub(1);
+    wake();
+    return false;
+  }
+
+  /**
+   * Releases the shared lock.
+   */
+  void unlock_shared()
+  {
+    stripes_[stripe_index()].readers.fetch_sub(1);
+    if (writer_.load()) {
+      wake();
+    }
+  }
+
+  /**
+   * Acquires the lock exclusively. New readers
+   * are held back while waiting for the current
+   * readers to leave.
+   */
+  void lock()
+  {
+    if (owned()) {
+      ++depth_;
+      return;
+    }
+    if (!try_set_writer()) {
+      wait([this]() { return try_set_writer(); });
+    }
+    if (!readers_left()) {
+      wait([this]() { return readers_left(); });
+    }
+    own();
+  }
+
+  /**
+   * Tries to acquire the lock exclusively.
+   *
+   * @return True if the lock was acquired
+   */
+  bool try_lock()
+  {
+    if (owned()) {
+      ++depth_;
+      return true;
+    }
+    if (!try_set_writer()) {
+      return false;
+    }
+    if (!readers_left()) {
+      writer_.store(false);
+      wake();
+      return false;
+    }
+    own();
+    return true;
+  }
+
+  /**
+   * Releases the exclusive lock.
+   */
+  void unlock()
+  {
+    if (--depth_ > 0) {
+      return;
+    }
+    owner_.store(std::thread::id());
+    writer_.store(false);
+    wake();
+  }
+
+private:
+  struct alignas(64) stripe
+  {
+    std::atomic<unsigned long> readers{0};
+  };
+
+  static std::size_t stripe_index()
+  {
+    static std::atomic<std::size_t> next(0);
+    static thread_local std::size_t index = next++ % stripe_count;
+    return index;
+  }
+
+  bool owned() const
+  {
+    return owner_.load() == std::this_thread::get_id();
+  }
+
+  void own()
+  {
+    owner_.store(std::this_thread::get_id());
+    depth_ = 1;
+  }
+
+  bool try_set_writer()
+  {
+    bool writer = false;
+    return writer_.compare_exchange_strong(writer, true);
+  }
+
+  bool readers_left() const
+  {
+    for (const stripe &s : stripes_) {
+      if (s.readers.load() > 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  template < class P >
+  void wait(P ready)
+  {
+    for (int i = 0; i < spin_count; ++i) {
+      std::this_thread::yield();
+      if (ready()) {
+        return;
+      }
+    }
+    std::unique_lock<std::mutex> l(mutex_);
+    // announced before the state is checked again, so a
+    // releasing thread either sees the waiter or the waiter
+    // sees the released state (all operations are seq_cst)
+    ++waiters_;
+    cond_.wait(l, ready);
+    --waiters_;
+  }
+
+  void wake()
+  {
+    if (waiters_.load() > 0) {
+      std::lock_guard<std::mutex> l(mutex_);
+      cond_.notify_all();
+    }
+  }
+
+private:
+  static const std::size_t stripe_count = 16;
+  static const int spin_count = 64;
+
+  stripe stripes_[stripe_count];
+
+  std::atomic<bool> writer_{false};
+  // the thread holding the lock exclusively
+  // and the depth of its recursive locking
+  std::atomic<std::thread::id> owner_{std::thread::id()};
+  unsigned long depth_ = 0;
+  std::atomic<int> waiters_{0};
+
+  std::mutex mutex_;
+  std::condition_variable cond_;
+};
+
+/**
+ * @class shared_guard
+ * @brief Holds a lock shared for its lifetime
+ *
+ * @tparam L The type of the lock
+ */
+template < class L >
+class shared_guard
+{
+public:
+  /**
+   * Acquires the given lock shared.
+   *
+   * @param l The lock to acquire
+   */
+  explicit shared_guard(L &l)
+    : lock_(l)
+  {
+    lock_.lock_shared();
+  }
+
+  ~shared_guard()
+  {
+    lock_.unlock_shared();
+  }
+
+  shared_guard(const shared_guard&) = delete;
+  shared_guard& operator=(const shared_guard&) = delete;
+
+private:
+  L &lock_;
+};
+
+}
+
+#endif //OOS_RW_LOCK_HPP
@@ -31,6 +31,7 @@
   #define OOS_API
 #endif
 
+#include <atomic>
 #include <memory>
 
 namespace oos {
@@ -92,6 +93,17 @@ public:
    * @return The new id.
    */
   virtual unsigned long update(unsigned long id) = 0;
+
+  /**
+   * Reserves a run of n consecutive ids
+   * and returns the first id of the run.
+   * The current id is set to the last
+   * id of the run.
+   *
+   * @param n The number of ids to reserve
+   * @return The first reserved id.
+   */
+  virtual unsigned long reserve(unsigned long n);
 };
 /// @endcond
 
@@ -121,6 +133,68 @@ private:
 };
 /// @endcond
 
+/**
+ * @cond OOS_DEV
+ * @class block_sequencer
+ * @brief Lock free sequencer handing out ids in blocks
+ *
+ * Each thread reserves a private block of ids with
+ * one atomic operation on the shared high value and
+ * hands out the ids of its block without any further
+ * synchronization (hi/lo strategy). Ids are unique and
+ * ascending per thread but not ordered across threads.
+ *
+ * Unused ids of a block are skipped once the sequencer
+ * is reset or updated with an id which may lie inside a
+ * block of another thread. current() returns the highest
+ * id handed out so far, not the highest reserved one.
+ */
+class OOS_API block_sequencer : public sequencer_impl
+{
+public:
+  /**
+   * Creates a block sequencer.
+   *
+   * @param block_size The number of ids reserved per block
+   */
+  explicit block_sequencer(unsigned long block_size = 64);
+  virtual ~block_sequencer();
+
+  virtual unsigned long init();
+
+  virtual unsigned long reset(unsigned long id);
+
+  virtual unsigned long next();
+  virtual unsigned long current() const;
+
+  virtual unsigned long update(unsigned long id);
+
+  virtual unsigned long reserve(unsigned long n);
+
+  /**
+   * Returns the number of ids reserved per block.
+   *
+   * @return The block size
+   */
+  unsigned long block_size() const;
+
+private:
+  // distinguishes the thread blocks of different sequencers
+  const unsigned long uid_;
+  const unsigned long block_size_;
+
+  std::atomic<unsigned long> hi_;
+  // the highest id handed out by next() and reserve()
+  // or taken from outside through update()
+  std::atomic<unsigned long> current_;
+  // all blocks of the current epoch lie above this id
+  std::atomic<unsigned long> floor_;
+  // incremented when reset or update hit the reserved
+  // range, invalidates all thread blocks
+  std::atomic<unsigned long> epoch_;
+};
+/// @endcond
+
 /**
  * @class sequencer
  * @brief Interface to create and get unique
@@ -198,6 +272,15 @@ public:
    */
   unsigned long update(unsigned long id);
 
+  /**
+   * Reserves a run of n consecutive
+   * sequence numbers.
+   *
+   * @param n The number of sequence numbers to reserve
+   * @return The first reserved sequence number.
+   */
+  unsigned long reserve(unsigned long n);
+
 private:
   sequencer_impl_ptr impl_;
 };
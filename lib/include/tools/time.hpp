@@ -18,6 +18,7 @@
 
 #include <ctime>
 #include <cstdint>
+#include <functional>
 #include <string>
 
 #ifdef WIN32
@@ -418,4 +419,22 @@ private:
 
 }
 
+namespace std {
+
+/**
+ * Hashes a time by its seconds
+ * and microseconds
+ */
+template <>
+struct hash<oos::time>
+{
+  size_t operator()(const oos::time &t) const
+  {
+    struct timeval tv = t.get_timeval();
+    return hash<long long>()(static_cast<long long>(tv.tv_sec) * 1000000 + tv.tv_usec);
+  }
+};
+
+}
+
 #endif /* TIME_HPP */
\ No newline at end of file
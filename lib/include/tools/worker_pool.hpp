@@ -0,0 +1,125 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WORKER_POOL_HPP
+#define WORKER_POOL_HPP
+
+#ifdef _MSC_VER
+  #ifdef oos_EXPORTS
+    #define OOS_API __declspec(dllexport)
+    #define EXPIMP_TEMPLATE
+  #else
+    #define OOS_API __declspec(dllimport)
+    #define EXPIMP_TEMPLATE extern
+  #endif
+  #pragma warning(disable: 4251)
+#else
+  #define OOS_API
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace oos {
+
+/**
+ * @class worker_pool
+ * @brief A fixed set of threads processing batches of tasks
+ *
+ * The threads of the pool are started once and wait
+ * for batches handed in by run(). The calling thread
+ * processes tasks of its own batch as well, so a batch
+ * is finished even if all workers are busy and run()
+ * may be called from within a task.
+ */
+class OOS_API worker_pool
+{
+public:
+  typedef std::function<void(std::size_t)> t_task; /**< Shortcut for a task */
+
+  /**
+   * Creates a pool with the given number of worker threads.
+   *
+   * @param workers The number of worker threads
+   */
+  explicit worker_pool(std::size_t workers);
+  ~worker_pool();
+
+  worker_pool(const worker_pool&) = delete;
+  worker_pool& operator=(const worker_pool&) = delete;
+
+  /**
+   * Returns the process wide pool with one worker
+   * less than the hardware supports, the calling
+   * thread being the last one.
+   *
+   * @return The process wide pool
+   */
+  static worker_pool& instance();
+
+  /**
+   * Returns the number of worker threads.
+   *
+   * @return The number of worker threads
+   */
+  std::size_t size() const;
+
+  /**
+   * Calls task(i) for each i in [0, tasks) on the
+   * workers and the calling thread and returns once
+   * all calls are done. The first exception thrown by
+   * a task is rethrown here.
+   *
+   * @param tasks The number of tasks
+   * @param task The task to call
+   */
+  void run(std::size_t tasks, const t_task &task);
+
+private:
+  struct batch
+  {
+    const t_task *task = nullptr;
+    std::size_t tasks = 0;
+    std::atomic<std::size_t> next{0};
+    std::size_t done = 0;
+    std::size_t users = 0;
+    std::exception_ptr error;
+  };
+
+  void work();
+  void execute(batch &b);
+
+private:
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable work_cond_;
+  std::condition_variable done_cond_;
+  std::deque<batch*> batches_;
+  bool stop_ = false;
+};
+
+}
+
+#endif /* WORKER_POOL_HPP */
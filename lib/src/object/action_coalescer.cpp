@@ -0,0 +1,98 @@
+#include "object/action_coalescer.hpp"
+#include "object/insert_action.hpp"
+#include "object/update_action.hpp"
+#include "object/delete_action.hpp"
+
+namespace oos {
+
+void action_coalescer::coalesce(const t_action_vactor &actions, t_action_vactor &result)
+{
+  // first find all inserted and deleted objects
+  pass_ = pass::COLLECT;
+  for (const action_ptr &a : actions) {
+    a->accept(this);
+  }
+  pass_ = pass::REDUCE;
+  result_ = &result;
+  result.reserve(result.size() + actions.size());
+  for (const action_ptr &a : actions) {
+    current_ = a;
+    a->accept(this);
+  }
+  current_.reset();
+  result_ = nullptr;
+  inserted_.clear();
+  deleted_.clear();
+  written_.clear();
+}
+
+void action_coalescer::visit(insert_action *a)
+{
+  if (pass_ == pass::COLLECT) {
+    for (object_proxy *proxy : *a) {
+      inserted_.insert(proxy->id());
+    }
+    return;
+  }
+  std::size_t count = 0, kept = 0;
+  for (object_proxy *proxy : *a) {
+    ++count;
+    if (deleted_.find(proxy->id()) == deleted_.end()) {
+      ++kept;
+    }
+  }
+  if (kept == 0) {
+    // all objects were deleted again
+    return;
+  }
+  if (kept == count) {
+    result_->push_back(current_);
+    return;
+  }
+  // some objects were deleted after a savepoint, the
+  // log keeps them to be able to roll back
+  std::shared_ptr<insert_action> ia(new insert_action(a->type(), (void*)nullptr));
+  for (object_proxy *proxy : *a) {
+    if (deleted_.find(proxy->id()) == deleted_.end()) {
+      ia->push_back(proxy);
+    }
+  }
+  result_->push_back(ia);
+}
+
+void action_coalescer::visit(update_action *a)
+{
+  if (pass_ == pass::COLLECT) {
+    return;
+  }
+  unsigned long id = a->proxy()->id();
+  if (inserted_.find(id) != inserted_.end() || deleted_.find(id) != deleted_.end()) {
+    return;
+  }
+  if (written_.find(id) != written_.end()) {
+    // the first update knows the values before the transaction
+    return;
+  }
+  if (a->modified_fields().empty()) {
+    // the object was changed back to its old values
+    return;
+  }
+  written_.insert(id);
+  result_->push_back(current_);
+}
+
+void action_coalescer::visit(delete_action *a)
+{
+  if (pass_ == pass::COLLECT) {
+    deleted_.insert(a->id());
+    return;
+  }
+  if (inserted_.find(a->id()) != inserted_.end()) {
+    return;
+  }
+  if (written_.insert(a->id()).second) {
+    result_->push_back(current_);
+  }
+}
+
+}
@@ -40,9 +40,8 @@ void action_remover::visit(insert_action *a)
   if (i != a->end()) {
     a->erase(i);
   }
-  if (a->empty()) {
-    actions_.erase(actions_.begin() + index_);
-  }
+  // an empty action is kept to keep the action
+  // indices valid, it is left out on commit
 }
 
 void action_remover::visit(update_action *a)
@@ -57,7 +56,7 @@ void action_remover::visit(update_action *a)
    ***********/
 //  if (a->proxy()->id() == id_) {
   if (a->proxy()->id() == proxy_->id()) {
-    actions_.at(0).reset(a->release_delete_action());
+    actions_.at(index_).reset(a->release_delete_action());
   }
 }
 
@@ -11,7 +11,7 @@ namespace oos {
 delete_action::~delete_action()
 {
   if (deleted_) {
-    delete proxy_;
+    detail::object_proxy_pool::destroy(proxy_);
   }
 }
 
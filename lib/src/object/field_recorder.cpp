@@ -0,0 +1,135 @@
+#include "object/field_recorder.hpp"
+
+#include "tools/basic_identifier.hpp"
+#include "tools/identifiable_holder.hpp"
+#include "tools/varchar.hpp"
+#include "tools/date.hpp"
+#include "tools/time.hpp"
+
+#include <cstring>
+
+namespace oos {
+namespace detail {
+
+std::vector<std::string> field_recorder::modified_fields(const t_field_values &before, const t_field_values &after)
+{
+  std::vector<std::string> fields;
+  if (before.size() != after.size()) {
+    // not comparable, treat all fields as modified
+    for (const auto &value : after) {
+      fields.push_back(value.first);
+    }
+    return fields;
+  }
+  for (t_field_values::size_type i = 0; i < after.size(); ++i) {
+    if (before[i].first != after[i].first || before[i].second != after[i].second) {
+      fields.push_back(after[i].first);
+    }
+  }
+  return fields;
+}
+
+void field_recorder::serialize(const char *id, char &x)
+{
+  append(id, &x, sizeof(x));
+}
+
+void field_recorder::serialize(const char *id, short &x)
+{
+  append(id, &x, sizeof(x));
+}
+
+void field_recorder::serialize(const char *id, int &x)
+{
+  append(id, &x, sizeof(x));
+}
+
+void field_recorder::serialize(const char *id, long &x)
+{
+  append(id, &x, sizeof(x));
+}
+
+void field_recorder::serialize(const char *id, unsigned char &x)
+{
+  append(id, &x, sizeof(x));
+}
+
+void field_recorder::serialize(const char *id, unsigned short &x)
+{
+  append(id, &x, sizeof(x));
+}
+
+void field_recorder::serialize(const char *id, unsigned int &x)
+{
+  append(id, &x, sizeof(x));
+}
+
+void field_recorder::serialize(const char *id, unsigned long &x)
+{
+  append(id, &x, sizeof(x));
+}
+
+void field_recorder::serialize(const char *id, bool &x)
+{
+  append(id, &x, sizeof(x));
+}
+
+void field_recorder::serialize(const char *id, float &x)
+{
+  append(id, &x, sizeof(x));
+}
+
+void field_recorder::serialize(const char *id, double &x)
+{
+  append(id, &x, sizeof(x));
+}
+
+void field_recorder::serialize(const char *id, char *x, size_t s)
+{
+  append(id, x, strnlen(x, s));
+}
+
+void field_recorder::serialize(const char *id, std::string &x)
+{
+  append(id, x.data(), x.size());
+}
+
+void field_recorder::serialize(const char *id, varchar_base &x)
+{
+  append(id, x.c_str(), x.size());
+}
+
+void field_recorder::serialize(const char *id, time &x)
+{
+  struct timeval tv = x.get_timeval();
+  append(id, &tv, sizeof(tv));
+}
+
+void field_recorder::serialize(const char *id, date &x)
+{
+  int julian = x.julian_date();
+  append(id, &julian, sizeof(julian));
+}
+
+void field_recorder::serialize(const char *id, basic_identifier &x)
+{
+  // records the underlying value under the field name
+  x.serialize(id, *this);
+}
+
+void field_recorder::serialize(const char *id, identifiable_holder &x, cascade_type)
+{
+  if (x.has_primary_key()) {
+    x.primary_key()->serialize(id, *this);
+  } else {
+    append(id, nullptr, 0);
+  }
+}
+
+void field_recorder::append(const char *id, const void *bytes, size_t size)
+{
+  values_->emplace_back(id, size > 0 ? std::string(static_cast<const char*>(bytes), size) : std::string());
+}
+
+}
+}
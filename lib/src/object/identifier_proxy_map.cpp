@@ -0,0 +1,81 @@
+#include "object/identifier_proxy_map.hpp"
+
+namespace oos {
+
+namespace detail {
+
+bool identifier_proxy_map::insert(const value_type &value)
+{
+  if (find_entry(value.first) != map_.end()) {
+    return false;
+  }
+  if (map_.empty()) {
+    type_ = &typeid(*value.first);
+  }
+  map_.insert(std::make_pair(value.first->hash(), value));
+  return true;
+}
+
+identifier_proxy_map::size_type identifier_proxy_map::erase(const identifier_ptr &pk)
+{
+  t_hash_map::const_iterator i = find_entry(pk);
+  if (i == map_.end()) {
+    return 0;
+  }
+  map_.erase(i);
+  return 1;
+}
+
+object_proxy *identifier_proxy_map::find(const identifier_ptr &pk) const
+{
+  t_hash_map::const_iterator i = find_entry(pk);
+  return i != map_.end() ? i->second.second : nullptr;
+}
+
+object_proxy *identifier_proxy_map::find(const std::string &value) const
+{
+  if (type_ == nullptr) {
+    return nullptr;
+  }
+  return find_value<std::string>(value);
+}
+
+void identifier_proxy_map::reserve(size_type n)
+{
+  map_.reserve(n);
+}
+
+void identifier_proxy_map::clear()
+{
+  map_.clear();
+  type_ = nullptr;
+}
+
+identifier_proxy_map::size_type identifier_proxy_map::size() const
+{
+  return map_.size();
+}
+
+identifier_proxy_map::size_type identifier_proxy_map::bucket_count() const
+{
+  return map_.bucket_count();
+}
+
+bool identifier_proxy_map::empty() const
+{
+  return map_.empty();
+}
+
+identifier_proxy_map::t_hash_map::const_iterator identifier_proxy_map::find_entry(const identifier_ptr &pk) const
+{
+  auto range = map_.equal_range(pk->hash());
+  for (auto i = range.first; i != range.second; ++i) {
+    if (pk->is_same_type(*i->second.first) && pk->equal_to(*i->second.first)) {
+      return i;
+    }
+  }
+  return map_.end();
+}
+
+}
+}
@@ -0,0 +1,104 @@
+#include "object/object_arena.hpp"
+
+namespace oos {
+
+namespace detail {
+
+namespace {
+
+std::size_t align_up(std::size_t size, std::size_t alignment)
+{
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+}
+
+basic_object_arena::basic_object_arena(std::size_t object_size, std::size_t object_alignment, std::size_t chunk_size)
+  : header_size_(align_up(sizeof(slot_header), object_alignment))
+  , slot_size_(header_size_ + align_up(object_size < sizeof(free_slot) ? sizeof(free_slot) : object_size, object_alignment))
+  , chunk_size_(chunk_size > 0 ? chunk_size : 1)
+{
+  // keep the header of every slot aligned
+  slot_size_ = align_up(slot_size_, alignof(slot_header));
+}
+
+basic_object_arena::~basic_object_arena()
+{}
+
+void *basic_object_arena::allocate()
+{
+  char *slot = nullptr;
+  if (free_list_ != nullptr) {
+    slot = reinterpret_cast<char*>(free_list_) - header_size_;
+    free_list_ = free_list_->next;
+  } else {
+    if (cursor_ == cursor_end_) {
+      add_chunk();
+    }
+    slot = cursor_;
+    cursor_ += slot_size_;
+  }
+  char *obj = slot + header_size_;
+  // the header is placed directly in front of the object
+  reinterpret_cast<slot_header*>(obj - sizeof(slot_header))->arena = this;
+  ++size_;
+  return obj;
+}
+
+void basic_object_arena::deallocate(void *p)
+{
+  if (p == nullptr) {
+    return;
+  }
+  slot_header *h = reinterpret_cast<slot_header*>(static_cast<char*>(p) - sizeof(slot_header));
+  h->arena->release(p);
+}
+
+bool basic_object_arena::clear()
+{
+  if (size_ > 0) {
+    return false;
+  }
+  chunks_.clear();
+  cursor_ = cursor_end_ = nullptr;
+  free_list_ = nullptr;
+  return true;
+}
+
+std::size_t basic_object_arena::size() const
+{
+  return size_;
+}
+
+std::size_t basic_object_arena::capacity() const
+{
+  return chunks_.size() * chunk_size_;
+}
+
+std::size_t basic_object_arena::chunk_count() const
+{
+  return chunks_.size();
+}
+
+std::size_t basic_object_arena::slot_size() const
+{
+  return slot_size_;
+}
+
+void basic_object_arena::release(void *p)
+{
+  free_slot *slot = static_cast<free_slot*>(p);
+  slot->next = free_list_;
+  free_list_ = slot;
+  --size_;
+}
+
+void basic_object_arena::add_chunk()
+{
+  chunks_.emplace_back(new char[chunk_size_ * slot_size_]);
+  cursor_ = chunks_.back().get();
+  cursor_end_ = cursor_ + chunk_size_ * slot_size_;
+}
+
+}
+}
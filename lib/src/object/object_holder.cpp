@@ -4,6 +4,7 @@
 
 #include "object/object_holder.hpp"
 #include "object/object_proxy.hpp"
+#include "object/object_proxy_pool.hpp"
 #include "object/object_exception.hpp"
 
 namespace oos {
@@ -53,8 +54,8 @@ object_holder::~object_holder()
      * if proxy was created temporary
      * we can delete it here
      */
-    if (!proxy_->ostore() && proxy_->ptr_set_.empty()) {
-      delete proxy_;
+    if (!proxy_->ostore() && proxy_->holders_ == nullptr) {
+      detail::object_proxy_pool::destroy(proxy_);
     }
   }
 }
@@ -84,8 +85,8 @@ void object_holder::reset(object_proxy *proxy, cascade_type cascade)
      * if proxy was created temporary
      * we can delete it here
      */
-    if (!proxy_->ostore() && proxy_->ptr_set_.empty()) {
-      delete proxy_;
+    if (!proxy_->ostore() && proxy_->holders_ == nullptr) {
+      detail::object_proxy_pool::destroy(proxy_);
     }
   }
   proxy_ = proxy;
@@ -145,7 +146,7 @@ const void*object_holder::ptr() const
 
 void* object_holder::lookup_object()
 {
-  if (proxy_ && proxy_->obj()) {
+  if (proxy_ && proxy_->fetch()) {
     if (proxy_->ostore()) {
       // Todo: callback to object store
 //      proxy_->ostore()->mark_modified(proxy_);
@@ -158,7 +159,7 @@ void* object_holder::lookup_object()
 
 void*object_holder::lookup_object() const
 {
-  return proxy_ ? proxy_->obj() : nullptr;
+  return proxy_ ? proxy_->fetch() : nullptr;
 }
 
 bool
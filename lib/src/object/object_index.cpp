@@ -0,0 +1,127 @@
+#include "object/object_index.hpp"
+#include "object/object_proxy.hpp"
+
+namespace oos {
+
+namespace detail {
+
+basic_object_index::basic_object_index(const char *attribute, index_type type)
+  : attribute_(attribute)
+  , type_(type)
+{}
+
+basic_object_index::~basic_object_index()
+{}
+
+const char *basic_object_index::attribute() const
+{
+  return attribute_.c_str();
+}
+
+index_type basic_object_index::type() const
+{
+  return type_;
+}
+
+void basic_object_index::insert(object_proxy *proxy)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  dirty_.insert(proxy);
+}
+
+void basic_object_index::remove(object_proxy *proxy)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  dirty_.erase(proxy);
+  erase_entry(proxy);
+}
+
+void basic_object_index::mark_modified(object_proxy *proxy)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  dirty_.insert(proxy);
+}
+
+bool basic_object_index::is_marked(object_proxy *proxy)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return dirty_.count(proxy) > 0;
+}
+
+void basic_object_index::clear()
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  dirty_.clear();
+  clear_entries();
+}
+
+std::size_t basic_object_index::size()
+{
+  fetch_marked();
+  std::lock_guard<std::mutex> guard(mutex_);
+  refresh();
+  return entry_count();
+}
+
+void basic_object_index::defer(bool defer)
+{
+  deferred_ = defer;
+}
+
+void basic_object_index::sync()
+{
+  fetch_unloaded();
+  std::lock_guard<std::mutex> guard(mutex_);
+  reindex();
+}
+
+void basic_object_index::fetch_marked()
+{
+  if (!deferred_) {
+    fetch_unloaded();
+  }
+}
+
+void basic_object_index::refresh()
+{
+  if (!deferred_) {
+    reindex();
+  }
+}
+
+void basic_object_index::fetch_unloaded()
+{
+  std::vector<object_proxy*> unloaded;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (object_proxy *proxy : dirty_) {
+      if (proxy->obj() == nullptr) {
+        unloaded.push_back(proxy);
+      }
+    }
+  }
+  // proxies which can't be fetched are erased on refresh
+  for (object_proxy *proxy : unloaded) {
+    proxy->fetch();
+  }
+}
+
+void basic_object_index::reindex()
+{
+  for (object_proxy *proxy : dirty_) {
+    if (proxy->obj() != nullptr) {
+      update_entry(proxy);
+    } else {
+      erase_entry(proxy);
+    }
+  }
+  dirty_.clear();
+}
+
+void *basic_object_index::object(object_proxy *proxy)
+{
+  return proxy->obj();
+}
+
+}
+}
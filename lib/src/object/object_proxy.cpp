@@ -17,6 +17,8 @@
 
 #include "object/object_store.hpp"
 
+#include <thread>
+
 using namespace std;
 
 namespace oos {
@@ -38,12 +40,17 @@ object_proxy::~object_proxy()
 //    ostore_->delete_proxy(id());
   }
   if (obj_) {
-    deleter_(obj_);
+    deleter_(obj_.load());
   }
   ostore_ = 0;
-  for (ptr_set_t::iterator i = ptr_set_.begin(); i != ptr_set_.end(); ++i) {
-    (*i)->proxy_ = 0;
+  object_holder *holder = holders_;
+  while (holder) {
+    object_holder *next = holder->next_holder_;
+    holder->proxy_ = 0;
+    holder->prev_holder_ = holder->next_holder_ = nullptr;
+    holder = next;
   }
+  holders_ = nullptr;
 }
 
 const char *object_proxy::classname() const
@@ -51,6 +58,42 @@ const char *object_proxy::classname() const
   return namer_();
 }
 
+void* object_proxy::fetch()
+{
+  if (node_ && node_->track_access()) {
+    accessed_.store(true, std::memory_order_relaxed);
+  }
+  if (obj_.load(std::memory_order_acquire) == nullptr && primary_key_ && node_ && node_->loader()) {
+    node_->loader()->fetch(this);
+  }
+  return obj_.load(std::memory_order_acquire);
+}
+
+bool object_proxy::accessed() const
+{
+  return accessed_.load(std::memory_order_relaxed);
+}
+
+void object_proxy::accessed(bool a)
+{
+  accessed_.store(a, std::memory_order_relaxed);
+}
+
+void object_proxy::mark_changed()
+{
+  changes_.fetch_add(1, std::memory_order_relaxed);
+}
+
+unsigned long object_proxy::changes() const
+{
+  return changes_.load(std::memory_order_relaxed);
+}
+
+void object_proxy::mark_written(unsigned long changes)
+{
+  changes_.compare_exchange_strong(changes, 0, std::memory_order_relaxed);
+}
+
 object_store *object_proxy::ostore() const
 {
   return ostore_;
@@ -163,14 +206,62 @@ unsigned long object_proxy::reference_count() const
   return reference_counter_;
 }
 
+namespace {
+
+// holders are linked and unlinked by reader threads
+// as well, so the list is guarded by a spin lock
+class holders_guard
+{
+public:
+  explicit holders_guard(std::atomic_flag &flag)
+    : flag_(flag)
+  {
+    while (flag_.test_and_set(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+  ~holders_guard()
+  {
+    flag_.clear(std::memory_order_release);
+  }
+
+private:
+  std::atomic_flag &flag_;
+};
+
+}
+
 void object_proxy::add(object_holder *ptr)
 {
-  ptr_set_.insert(ptr);
+  holders_guard guard(holders_lock_);
+  if (ptr->prev_holder_ || holders_ == ptr) {
+    // already linked
+    return;
+  }
+  ptr->next_holder_ = holders_;
+  if (holders_) {
+    holders_->prev_holder_ = ptr;
+  }
+  holders_ = ptr;
 }
 
 bool object_proxy::remove(object_holder *ptr)
 {
-  return ptr_set_.erase(ptr) == 1;
+  holders_guard guard(holders_lock_);
+  if (!ptr->prev_holder_ && holders_ != ptr) {
+    // not linked to this proxy
+    return false;
+  }
+  if (ptr->prev_holder_) {
+    ptr->prev_holder_->next_holder_ = ptr->next_holder_;
+  } else {
+    holders_ = ptr->next_holder_;
+  }
+  if (ptr->next_holder_) {
+    ptr->next_holder_->prev_holder_ = ptr->prev_holder_;
+  }
+  ptr->prev_holder_ = ptr->next_holder_ = nullptr;
+  return true;
 }
 
 bool object_proxy::valid() const
@@ -207,9 +298,14 @@ bool object_proxy::has_transaction() const
   return ostore_->has_transaction();
 }
 
+detail::snapshot_registry* object_proxy::snapshots() const
+{
+  return ostore_ ? &ostore_->snapshots_ : nullptr;
+}
+
 std::ostream& operator <<(std::ostream &os, const object_proxy &op)
 {
-  os << "proxy [" << &op << "] prev_ [" << op.prev_ << "] next_ [" << op.next_ << "] object [" << op.obj_ << "]";// refs [" << op.ref_count_ << "] ptrs [" << op.ptr_count_ << "]";
+  os << "proxy [" << &op << "] prev_ [" << op.prev_ << "] next_ [" << op.next_ << "] object [" << op.obj_.load() << "]";// refs [" << op.ref_count_ << "] ptrs [" << op.ptr_count_ << "]";
   return os;
 }
 
@@ -0,0 +1,173 @@
+#include "object/object_proxy_pool.hpp"
+#include "object/object_proxy.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+namespace oos {
+
+namespace detail {
+
+namespace {
+
+const std::size_t slot_alignment = alignof(std::max_align_t);
+
+std::size_t align_up(std::size_t size)
+{
+  return (size + slot_alignment - 1) & ~(slot_alignment - 1);
+}
+
+const std::size_t header_size = align_up(sizeof(void*));
+const std::size_t object_size = align_up(sizeof(object_proxy));
+const std::size_t slots_per_page = (object_proxy_pool::page_size - header_size) / object_size;
+
+char* allocate_pages(std::size_t size)
+{
+#ifdef _MSC_VER
+  void *p = _aligned_malloc(size, object_proxy_pool::page_size);
+#else
+  void *p = nullptr;
+  if (posix_memalign(&p, object_proxy_pool::page_size, size) != 0) {
+    p = nullptr;
+  }
+#endif
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return static_cast<char*>(p);
+}
+
+void free_pages(char *p)
+{
+#ifdef _MSC_VER
+  _aligned_free(p);
+#else
+  free(p);
+#endif
+}
+
+}
+
+object_proxy_pool::object_proxy_pool(std::size_t slab_size)
+  : pages_per_slab_(slab_size > slots_per_page ? (slab_size + slots_per_page - 1) / slots_per_page : 1)
+  , slab_size_(pages_per_slab_ * slots_per_page)
+{}
+
+object_proxy_pool::~object_proxy_pool()
+{
+  for (char *slab : slabs_) {
+    free_pages(slab);
+  }
+}
+
+void object_proxy_pool::destroy(object_proxy *proxy)
+{
+  if (proxy == nullptr) {
+    return;
+  }
+  if (!proxy->pooled_) {
+    delete proxy;
+    return;
+  }
+  object_proxy_pool *pool = header(proxy)->pool;
+  proxy->~object_proxy();
+  pool->release(proxy);
+}
+
+void object_proxy_pool::dispose(object_proxy *proxy)
+{
+  if (proxy == nullptr) {
+    return;
+  }
+  if (proxy->pooled_) {
+    proxy->~object_proxy();
+  } else {
+    delete proxy;
+  }
+}
+
+void object_proxy_pool::clear()
+{
+  for (char *slab : slabs_) {
+    free_pages(slab);
+  }
+  slabs_.clear();
+  cursor_ = cursor_end_ = next_page_ = slab_end_ = nullptr;
+  free_list_ = nullptr;
+  size_ = 0;
+}
+
+std::size_t object_proxy_pool::size() const
+{
+  return size_;
+}
+
+std::size_t object_proxy_pool::capacity() const
+{
+  return slabs_.size() * slab_size_;
+}
+
+std::size_t object_proxy_pool::slab_count() const
+{
+  return slabs_.size();
+}
+
+std::size_t object_proxy_pool::slab_size() const
+{
+  return slab_size_;
+}
+
+object_proxy_pool::page_header *object_proxy_pool::header(void *p)
+{
+  return reinterpret_cast<page_header*>(reinterpret_cast<std::uintptr_t>(p) & ~(page_size - 1));
+}
+
+void *object_proxy_pool::allocate()
+{
+  ++size_;
+  if (free_list_ != nullptr) {
+    void *slot = free_list_;
+    free_list_ = free_list_->next;
+    return slot;
+  }
+  if (cursor_ == cursor_end_) {
+    next_page();
+  }
+  void *slot = cursor_;
+  cursor_ += object_size;
+  return slot;
+}
+
+void object_proxy_pool::release(void *p)
+{
+  free_slot *slot = static_cast<free_slot*>(p);
+  slot->next = free_list_;
+  free_list_ = slot;
+  --size_;
+}
+
+void object_proxy_pool::next_page()
+{
+  if (next_page_ == slab_end_) {
+    add_slab();
+  }
+  reinterpret_cast<page_header*>(next_page_)->pool = this;
+  cursor_ = next_page_ + header_size;
+  cursor_end_ = cursor_ + slots_per_page * object_size;
+  next_page_ += page_size;
+}
+
+void object_proxy_pool::add_slab()
+{
+  slabs_.push_back(allocate_pages(pages_per_slab_ * page_size));
+  next_page_ = slabs_.back();
+  slab_end_ = next_page_ + pages_per_slab_ * page_size;
+}
+
+}
+}
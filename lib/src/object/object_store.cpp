@@ -20,6 +20,7 @@
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
+#include <atomic>
 
 using namespace std;
 using namespace std::placeholders;
@@ -28,11 +29,42 @@ namespace oos {
 
 namespace detail {
 
+std::size_t next_type_slot()
+{
+  static std::atomic<std::size_t> slot(0);
+  return slot++;
+}
+
 object_inserter::object_inserter(object_store &ostore)
   : ostore_(ostore) { }
 
 object_inserter::~object_inserter() { }
 
+write_guard::write_guard(object_store &store)
+  : store_(store)
+  , locked_(store.concurrent_reads_)
+{
+  if (locked_) {
+    store_.lock_.lock();
+  }
+  ++store_.write_depth_;
+}
+
+write_guard::~write_guard()
+{
+  if (locked_ && store_.write_depth_ == 1 && store_.transactions_.empty()) {
+    try {
+      store_.publish();
+    } catch (...) {
+      // the readers keep the former committed state
+    }
+  }
+  --store_.write_depth_;
+  if (locked_) {
+    store_.lock_.unlock();
+  }
+}
+
 void object_inserter::reset()
 {
   object_proxies_.clear();
@@ -56,6 +88,9 @@ object_store::object_store()
 
 object_store::~object_store()
 {
+  // no reader is left
+  concurrent_reads_ = false;
+  committed_.reset();
   clear(true);
   delete last_;
   delete first_;
@@ -117,20 +152,24 @@ prototype_iterator object_store::end()
 
 void object_store::clear(bool full)
 {
+  detail::write_guard guard(*this);
+  snapshots_.detach();
+  // destroy all objects, the slots are dropped with the slabs
+  for (auto &i : object_map_) {
+    detail::object_proxy_pool::dispose(i.second);
+  }
+  object_map_.clear();
+  prototype_iterator first = begin();
+  prototype_iterator last = end();
+  while (first != last) {
+    (first++)->forget_objects();
+  }
+  proxy_pool_.clear();
   if (full) {
     while (first_->next != last_) {
       remove_prototype_node(first_->next, true);
     }
-  } else {
-    // only delete objects
-    prototype_iterator first = begin();
-    prototype_iterator last = end();
-    while (first != last) {
-        (first++)->clear(false);
-    }
-//    prototype_tree_.begin()->clear(true);
   }
-  object_map_.clear();
 }
 
 void object_store::clear(const char *type)
@@ -145,6 +184,8 @@ void object_store::clear(const prototype_iterator &node)
 
 prototype_node* object_store::clear(prototype_node *node)
 {
+  detail::write_guard guard(*this);
+  snapshots_.detach();
   prototype_node *current = node->first->next;
   while (current != node->last.get()) {
     current = clear(current);
@@ -167,6 +208,14 @@ bool object_store::empty() const
   return is_empty;
 }
 
+void object_store::reserve(std::size_t count)
+{
+  if (count == 0) {
+    return;
+  }
+  object_map_.reserve(object_map_.size() + count);
+}
+
 size_t object_store::depth(const prototype_node *node) const
 {
   size_t d = 0;
@@ -225,6 +274,9 @@ object_proxy* object_store::find_proxy(unsigned long id) const
   if (i == object_map_.end()) {
     return nullptr;
   } else {
+    if (i->second->node()) {
+      i->second->node()->lookups_.fetch_add(1, std::memory_order_relaxed);
+    }
     return i->second;
   }
 }
@@ -258,6 +310,8 @@ object_proxy* object_store::insert_proxy(object_proxy *proxy)
     throw object_exception("couldn't find object type");
   }
 
+  detail::write_guard guard(*this);
+  proxy->version_ = version_;
   node->insert(proxy);
 
   return object_map_.insert(std::make_pair(proxy->id(), proxy)).first->second;
@@ -271,6 +325,7 @@ void object_store::remove_proxy(object_proxy *proxy)
   if (proxy->node() == nullptr) {
     throw object_exception("prototype node is nullptr");
   }
+  detail::write_guard guard(*this);
   // single deletion
   if (object_map_.erase(proxy->id()) != 1) {
     // couldn't remove object
@@ -279,7 +334,7 @@ void object_store::remove_proxy(object_proxy *proxy)
   }
 
   proxy->node()->remove(proxy);
-  delete proxy;
+  detail::object_proxy_pool::destroy(proxy);
 }
 
 object_proxy* object_store::register_proxy(object_proxy *oproxy)
@@ -299,9 +354,75 @@ object_proxy* object_store::register_proxy(object_proxy *oproxy)
 
 sequencer_impl_ptr object_store::exchange_sequencer(const sequencer_impl_ptr &seq)
 {
+  seq->update(seq_.current());
   return seq_.exchange_sequencer(seq);
 }
 
+const detail::object_proxy_pool &object_store::proxy_pool() const
+{
+  return proxy_pool_;
+}
+
+bool object_store::evict(object_proxy *proxy)
+{
+  prototype_node *node = proxy->node();
+  if (proxy->obj() == nullptr || !proxy->has_identifier() || node == nullptr || node->loader() == nullptr || node->arena_) {
+    return false;
+  }
+  // the items of has many relations aren't fetched again
+  if (node->has_many()) {
+    return false;
+  }
+  // the lock isn't waited for, so the object can't be
+  // used by a reader thread and the calling thread may
+  // still hold the lock shared
+  std::unique_lock<rw_lock> guard(lock_, std::try_to_lock);
+  if (!guard.owns_lock() || !may_evict()) {
+    return false;
+  }
+  // changes not written to the database would be lost
+  if (proxy->changes() > 0) {
+    return false;
+  }
+  void *obj = proxy->obj_;
+  proxy->obj_ = nullptr;
+  proxy->deleter_(obj);
+  node->unloaded_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+bool object_store::may_evict() const
+{
+  return transactions_.empty() && snapshots_.empty() && write_depth_ == 0;
+}
+
+store_stats object_store::stats() const
+{
+  store_stats result;
+  result.object_map_size = object_map_.size();
+  result.object_map_capacity = object_map_.capacity();
+  result.proxy_pool_size = proxy_pool_.size();
+  result.proxy_pool_capacity = proxy_pool_.capacity();
+
+  for (const_iterator node = begin(); node != end(); ++node) {
+    node_stats stats;
+    stats.type = node->type();
+    // own proxies only, child nodes are counted separately
+    stats.proxy_count = node->count;
+    stats.object_count = node->count - node->unloaded_.load(std::memory_order_relaxed);
+    // objects of an arena occupy a whole slot
+    stats.object_bytes = stats.object_count * (node->arena_ ? node->arena_->slot_size() : node->object_size_);
+    stats.proxy_bytes = stats.proxy_count * sizeof(object_proxy);
+    stats.id_map_size = node->id_map_.size();
+    stats.id_map_buckets = node->id_map_.bucket_count();
+    stats.inserts = node->inserts_.load(std::memory_order_relaxed);
+    stats.removes = node->removes_.load(std::memory_order_relaxed);
+    stats.lookups = node->lookups_.load(std::memory_order_relaxed);
+    result.nodes.push_back(stats);
+  }
+  return result;
+}
+
 prototype_node* object_store::find_prototype_node(const char *type) const {
   // check for null
   if (type == 0) {
@@ -348,6 +469,9 @@ prototype_node* object_store::remove_prototype_node(prototype_node *node, bool i
     remove_prototype_node(node->first->next, false);
   }
   // and objects they're containing
+  for (object_proxy *proxy = node->op_first->next_; proxy != node->op_marker; proxy = proxy->next_) {
+    object_map_.erase(proxy->id());
+  }
   node->clear(false);
   // delete prototype node as well
   // unlink node
@@ -357,6 +481,8 @@ prototype_node* object_store::remove_prototype_node(prototype_node *node, bool i
   if (j != prototype_map_.end()) {
     prototype_map_.erase(j);
   }
+  // forget the cached type slot
+  std::replace(type_slots_.begin(), type_slots_.end(), node, static_cast<prototype_node*>(nullptr));
   // find item in typeid map
   t_typeid_prototype_map::iterator k = typeid_prototype_map_.find(node->type_id());
   if (k != typeid_prototype_map_.end()) {
@@ -394,9 +520,137 @@ void object_store::push_transaction(const transaction &tr)
 
 void object_store::pop_transaction()
 {
+  // the outermost transaction publishes its changes
+  detail::write_guard guard(*this);
   transactions_.pop();
 }
 
+void object_store::concurrent_reads(bool enable)
+{
+  if (!transactions_.empty()) {
+    throw object_exception("can't change concurrent reads within a transaction");
+  }
+  if (enable == concurrent_reads_) {
+    return;
+  }
+  std::lock_guard<rw_lock> guard(lock_);
+  concurrent_reads_ = enable;
+  for (prototype_iterator node = begin(); node != end(); ++node) {
+    for (auto &index : node->indexes_) {
+      index->defer(enable);
+    }
+  }
+  if (enable) {
+    publish();
+  } else {
+    committed_.reset();
+  }
+}
+
+bool object_store::concurrent_reads() const
+{
+  return concurrent_reads_;
+}
+
+rw_lock& object_store::lock()
+{
+  return lock_;
+}
+
+oos::snapshot object_store::committed() const
+{
+  return oos::snapshot(committed_);
+}
+
+void object_store::publish()
+{
+  // no object is written while the lock is held
+  for (prototype_iterator node = begin(); node != end(); ++node) {
+    for (auto &index : node->indexes_) {
+      index->sync();
+    }
+  }
+  committed_ = snapshots_.create(this, version_++);
+}
+snapshot object_store::snapshot()
+{
+  if (!transactions_.empty()) {
+    throw object_exception("can't take snapshot within a transaction");
+  }
+  // objects inserted from now on get a newer version
+  return oos::snapshot(snapshots_.create(this, version_++));
+}
+
+void object_store::register_observer(object_observer *observer)
+{
+  observer_list_.push_back(observer);
+}
+
+void object_store::register_observer(object_batch_observer *observer)
+{
+  batch_observer_list_.push_back(observer);
+}
+
+void object_store::unregister_observer(object_observer *observer)
+{
+  observer_list_.remove(observer);
+}
+
+void object_store::unregister_observer(object_batch_observer *observer)
+{
+  batch_observer_list_.remove(observer);
+}
+
+bool object_store::has_observers() const
+{
+  return !observer_list_.empty() || !batch_observer_list_.empty();
+}
+
+void object_store::notify_insert(object_proxy *const *proxies, std::size_t count)
+{
+  if (count == 0) {
+    return;
+  }
+  for (object_batch_observer *observer : batch_observer_list_) {
+    observer->on_insert(proxies, count);
+  }
+  for (object_observer *observer : observer_list_) {
+    for (std::size_t i = 0; i < count; ++i) {
+      observer->on_insert(proxies[i]);
+    }
+  }
+}
+
+void object_store::notify_update(object_proxy *const *proxies, std::size_t count)
+{
+  if (count == 0) {
+    return;
+  }
+  for (object_batch_observer *observer : batch_observer_list_) {
+    observer->on_update(proxies, count);
+  }
+  for (object_observer *observer : observer_list_) {
+    for (std::size_t i = 0; i < count; ++i) {
+      observer->on_update(proxies[i]);
+    }
+  }
+}
+
+void object_store::notify_delete(object_proxy *const *proxies, std::size_t count)
+{
+  if (count == 0) {
+    return;
+  }
+  for (object_batch_observer *observer : batch_observer_list_) {
+    observer->on_delete(proxies, count);
+  }
+  for (object_observer *observer : observer_list_) {
+    for (std::size_t i = 0; i < count; ++i) {
+      observer->on_delete(proxies[i]);
+    }
+  }
+}
+
 transaction object_store::current_transaction()
 {
   return transactions_.top();
@@ -18,6 +18,7 @@
 #include "object/prototype_node.hpp"
 #include "object/object_exception.hpp"
 #include "object/object_proxy.hpp"
+#include "object/object_proxy_pool.hpp"
 
 #include <algorithm>
 
@@ -55,6 +56,11 @@ prototype_node::size() const
   return count;
 }
 
+unsigned long prototype_node::size(bool self) const
+{
+  return self ? count : total_count;
+}
+
 const char *prototype_node::type() const
 {
   return type_.c_str();
@@ -152,11 +158,71 @@ void prototype_node::insert(object_proxy *proxy)
   proxy->node_ = this;
   // adjust size
   ++count;
+  adjust_total_count(1);
+  inserts_.fetch_add(1, std::memory_order_relaxed);
+  if (proxy->obj_ == nullptr) {
+    unloaded_.fetch_add(1, std::memory_order_relaxed);
+  }
   // find and insert primary key
   std::shared_ptr<basic_identifier> pk(proxy->primary_key_);
   if (pk) {
     id_map_.insert(std::make_pair(pk, proxy));
   }
+  // add to attribute indexes
+  for (prototype_node *node = this; node != nullptr; node = node->parent) {
+    for (auto &index : node->indexes_) {
+      index->insert(proxy);
+    }
+  }
+}
+
+void prototype_node::insert(const std::vector<object_proxy*> &proxies)
+{
+  if (proxies.empty()) {
+    return;
+  }
+  // chain the proxies
+  object_proxy *head = proxies.front();
+  object_proxy *tail = proxies.back();
+  for (std::vector<object_proxy*>::size_type i = 1; i < proxies.size(); ++i) {
+    proxies[i - 1]->next_ = proxies[i];
+    proxies[i]->prev_ = proxies[i - 1];
+  }
+  // splice the run like a single proxy (see insert(object_proxy*))
+  object_proxy *successor = count > 0 ? op_marker->prev_ : op_marker;
+  head->prev_ = successor->prev_;
+  if (successor->prev_) {
+    successor->prev_->next_ = head;
+  }
+  tail->next_ = successor;
+  successor->prev_ = tail;
+
+  if (count < 2) {
+    adjust_left_marker(this, tail->next_, head);
+  }
+  if (count == 0) {
+    adjust_right_marker(this, head->prev_, tail);
+  }
+
+  count += proxies.size();
+  adjust_total_count((long)proxies.size());
+  inserts_.fetch_add(proxies.size(), std::memory_order_relaxed);
+
+  if (has_primary_key()) {
+    id_map_.reserve(id_map_.size() + proxies.size());
+  }
+  for (object_proxy *proxy : proxies) {
+    proxy->node_ = this;
+    std::shared_ptr<basic_identifier> pk(proxy->primary_key_);
+    if (pk) {
+      id_map_.insert(std::make_pair(pk, proxy));
+    }
+    for (prototype_node *node = this; node != nullptr; node = node->parent) {
+      for (auto &index : node->indexes_) {
+        index->insert(proxy);
+      }
+    }
+  }
 }
 
 void prototype_node::remove(object_proxy *proxy)
@@ -185,8 +251,20 @@ void prototype_node::remove(object_proxy *proxy)
     }
   }
 
+  // remove from attribute indexes
+  for (prototype_node *node = this; node != nullptr; node = node->parent) {
+    for (auto &index : node->indexes_) {
+      index->remove(proxy);
+    }
+  }
+
   // adjust serializable count for node
   --count;
+  adjust_total_count(-1);
+  removes_.fetch_add(1, std::memory_order_relaxed);
+  if (proxy->obj_ == nullptr) {
+    unloaded_.fetch_sub(1, std::memory_order_relaxed);
+  }
 }
 
 void prototype_node::clear(bool recursive)
@@ -199,11 +277,21 @@ void prototype_node::clear(bool recursive)
       object_proxy *op = op_first->next_;
       // remove serializable proxy from list
       op->unlink();
+      for (prototype_node *node = this; node != nullptr; node = node->parent) {
+        for (auto &index : node->indexes_) {
+          index->remove(op);
+        }
+      }
       // delete serializable proxy and serializable
-      delete op;
+      detail::object_proxy_pool::destroy(op);
     }
     id_map_.clear();
+    adjust_total_count(-(long)count);
     count = 0;
+    unloaded_.store(0, std::memory_order_relaxed);
+    if (arena_) {
+      arena_->clear();
+    }
   }
 
   if (recursive) {
@@ -216,6 +304,30 @@ void prototype_node::clear(bool recursive)
   }
 }
 
+void prototype_node::forget_objects()
+{
+  prototype_node *root = this;
+  while (root->parent != nullptr) {
+    root = root->parent;
+  }
+  if (root == this) {
+    op_first->next_ = op_last;
+    op_last->prev_ = op_first;
+  }
+  op_first = root->op_first;
+  op_marker = op_last = root->op_last;
+  count = 0;
+  total_count = 0;
+  unloaded_.store(0, std::memory_order_relaxed);
+  id_map_.clear();
+  for (auto &index : indexes_) {
+    index->clear();
+  }
+  if (arena_) {
+    arena_->clear();
+  }
+}
+
 void prototype_node::unlink()
 {
   // unlink node
@@ -354,6 +466,37 @@ bool prototype_node::is_abstract() const
   return abstract_;
 }
 
+const detail::basic_object_arena *prototype_node::arena() const
+{
+  return arena_.get();
+}
+
+detail::basic_object_index *prototype_node::find_index(const char *attribute) const
+{
+  for (const prototype_node *node = this; node != nullptr; node = node->parent) {
+    for (auto &index : node->indexes_) {
+      if (index->attribute() == std::string(attribute)) {
+        return index.get();
+      }
+    }
+  }
+  return nullptr;
+}
+
+std::shared_ptr<void> prototype_node::clone(const void *obj) const
+{
+  return clone_func_ ? clone_func_(obj) : std::shared_ptr<void>();
+}
+
+void prototype_node::mark_modified(object_proxy *proxy)
+{
+  for (prototype_node *node = this; node != nullptr; node = node->parent) {
+    for (auto &index : node->indexes_) {
+      index->mark_modified(proxy);
+    }
+  }
+}
+
 void prototype_node::register_foreign_key(const char *id, const std::shared_ptr<basic_identifier> &foreign_key)
 {
   foreign_keys.insert(std::make_pair(id, foreign_key));
@@ -369,13 +512,52 @@ void prototype_node::prepare_foreign_key(prototype_node *master_node, const char
   foreign_key_ids.push_back(std::make_pair(master_node, id));
 }
 
+void prototype_node::loader(detail::object_loader *loader)
+{
+  loader_ = loader;
+}
+
+detail::object_loader* prototype_node::loader() const
+{
+  return loader_;
+}
+
+void prototype_node::register_has_many()
+{
+  has_many_ = true;
+}
+
+bool prototype_node::has_many() const
+{
+  return has_many_;
+}
+
+void prototype_node::track_access(bool track)
+{
+  track_access_.store(track, std::memory_order_relaxed);
+}
+
+bool prototype_node::track_access() const
+{
+  return track_access_.load(std::memory_order_relaxed);
+}
+
+bool prototype_node::is_marked(object_proxy *proxy) const
+{
+  for (const prototype_node *node = this; node != nullptr; node = node->parent) {
+    for (auto &index : node->indexes_) {
+      if (index->is_marked(proxy)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
 object_proxy *prototype_node::find_proxy(const std::shared_ptr<basic_identifier> &pk)
 {
-  detail::t_identifier_map::iterator i = std::find_if(id_map_.begin(), id_map_.end(), [pk](const detail::t_identifier_map::value_type &x) {
-    return *pk == *(x.first);
-  });
-//  t_primary_key_map::iterator i = primary_key_map.find(pk);
-  return (i != id_map_.end() ? i->second : nullptr);
+  lookups_.fetch_add(1, std::memory_order_relaxed);
+  return id_map_.find(pk);
 }
 
 /*
@@ -398,6 +580,13 @@ void prototype_node::adjust_left_marker(prototype_node *root, object_proxy *old_
   }
 }
 
+void prototype_node::adjust_total_count(long n)
+{
+  for (prototype_node *node = this; node != nullptr; node = node->parent) {
+    node->total_count += n;
+  }
+}
+
 void prototype_node::adjust_right_marker(prototype_node *root, object_proxy* old_proxy, object_proxy *new_proxy)
 {
   // store start node
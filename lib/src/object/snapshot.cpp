@@ -0,0 +1,108 @@
+#include "object/snapshot.hpp"
+#include "object/object_store.hpp"
+#include "object/object_exception.hpp"
+
+namespace oos {
+
+namespace detail {
+
+snapshot_data::snapshot_data(object_store *store, unsigned long version)
+  : store_(store)
+  , version_(version)
+{}
+
+object_proxy *snapshot_data::find_live(unsigned long id) const
+{
+  object_proxy *proxy = store_->find_proxy(id);
+  return proxy != nullptr && contains(proxy) ? proxy : nullptr;
+}
+
+prototype_node *snapshot_data::find_node(const char *type) const
+{
+  object_store::const_iterator i = store_->find(type);
+  return i == store_->end() ? nullptr : const_cast<prototype_node*>(i.get());
+}
+
+std::shared_ptr<snapshot_data> snapshot_registry::create(object_store *store, unsigned long version)
+{
+  purge();
+  std::shared_ptr<snapshot_data> data = std::make_shared<snapshot_data>(store, version);
+  snapshots_.push_back(data);
+  return data;
+}
+
+bool snapshot_registry::empty() const
+{
+  return snapshots_.empty();
+}
+
+void snapshot_registry::freeze(object_proxy *proxy)
+{
+  if (snapshots_.empty() || proxy->obj() == nullptr) {
+    return;
+  }
+  std::shared_ptr<void> copy;
+  t_snapshot_list::iterator i = snapshots_.begin();
+  while (i != snapshots_.end()) {
+    std::shared_ptr<snapshot_data> data = i->lock();
+    if (!data) {
+      i = snapshots_.erase(i);
+      continue;
+    }
+    if (data->contains(proxy) && data->frozen_.find(proxy->id()) == data->frozen_.end()) {
+      if (!copy) {
+        copy = proxy->node()->clone(proxy->obj());
+        if (!copy) {
+          throw object_exception("snapshot: object type isn't copy constructible");
+        }
+      }
+      data->frozen_.insert(std::make_pair(proxy->id(), snapshot_data::frozen_object{copy, proxy->node()}));
+    }
+    ++i;
+  }
+}
+
+void snapshot_registry::detach()
+{
+  for (const std::weak_ptr<snapshot_data> &snapshot : snapshots_) {
+    std::shared_ptr<snapshot_data> data = snapshot.lock();
+    if (data) {
+      data->store_ = nullptr;
+      data->frozen_.clear();
+    }
+  }
+  snapshots_.clear();
+}
+
+void snapshot_registry::purge()
+{
+  t_snapshot_list::iterator i = snapshots_.begin();
+  while (i != snapshots_.end()) {
+    if (i->expired()) {
+      i = snapshots_.erase(i);
+    } else {
+      ++i;
+    }
+  }
+}
+
+}
+
+snapshot::snapshot()
+{}
+
+snapshot::snapshot(const std::shared_ptr<detail::snapshot_data> &data)
+  : data_(data)
+{}
+
+bool snapshot::valid() const
+{
+  return data_ && data_->store_ != nullptr;
+}
+
+std::size_t snapshot::copied_objects() const
+{
+  return data_ ? data_->frozen_.size() : 0;
+}
+
+}
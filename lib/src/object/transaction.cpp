@@ -4,10 +4,67 @@
 
 #include "object/transaction.hpp"
 #include "object/object_store.hpp"
+#include "object/action_coalescer.hpp"
+
+#include <algorithm>
 
 namespace oos {
 
-sequencer transaction::sequencer_ = sequencer();
+namespace {
+
+// collects the proxies of all actions per kind
+class notification_collector : public action_visitor
+{
+public:
+  virtual void visit(insert_action *a)
+  {
+    inserted.insert(inserted.end(), a->begin(), a->end());
+  }
+  virtual void visit(update_action *a)
+  {
+    updated.push_back(a->proxy());
+  }
+  virtual void visit(delete_action *a)
+  {
+    deleted.push_back(a->proxy());
+  }
+
+  std::vector<object_proxy*> inserted;
+  std::vector<object_proxy*> updated;
+  std::vector<object_proxy*> deleted;
+};
+
+// marks the updated objects for reindexing
+class index_marker : public action_visitor
+{
+public:
+  virtual void visit(insert_action *) {}
+  virtual void visit(update_action *a)
+  {
+    if (a->proxy()->linked() && a->proxy()->node()) {
+      a->proxy()->node()->mark_modified(a->proxy());
+    }
+  }
+  virtual void visit(delete_action *) {}
+};
+
+// marks the deleted objects of the actions
+// written at a savepoint
+class delete_marker : public action_visitor
+{
+public:
+  virtual void visit(insert_action *) {}
+  virtual void visit(update_action *) {}
+  virtual void visit(delete_action *a)
+  {
+    a->mark_deleted();
+  }
+};
+
+}
+
+// transactions may be created in several threads
+sequencer transaction::sequencer_ = sequencer(std::make_shared<block_sequencer>());
 
 void transaction::null_observer::on_commit(transaction::t_action_vector &actions)
 {
@@ -56,8 +113,35 @@ void transaction::begin()
 void transaction::commit()
 {
   commiting_ = true;
-  transaction_data_->observer_->on_commit(transaction_data_->actions_);
+  // the observers only see the net effect,
+  // the action log is kept for a rollback
+  t_action_vector write_set;
+  action_coalescer coalescer;
+  coalescer.coalesce(transaction_data_->actions_, write_set);
+  if (transaction_data_->written_ == 0) {
+    transaction_data_->observer_->on_commit(write_set);
+  } else {
+    // the actions before were written at a savepoint
+    t_action_vector tail_set;
+    coalescer.coalesce(t_action_vector(transaction_data_->actions_.begin() + transaction_data_->written_, transaction_data_->actions_.end()), tail_set);
+    transaction_data_->observer_->on_commit(tail_set);
+    delete_marker marker;
+    for (action_ptr &a : write_set) {
+      a->accept(&marker);
+    }
+  }
   commiting_ = false;
+  // objects may be modified after the indexes
+  // were refreshed within the transaction
+  index_marker marker;
+  for (action_ptr &a : transaction_data_->actions_) {
+    a->accept(&marker);
+  }
+  notify_observers(write_set);
+  if (!transaction_data_->observer_->durable()) {
+    // the changes may still be lost
+    transaction_data_->observer_->on_pending(std::shared_ptr<undo_log>(new undo_log(*transaction_data_)));
+  }
   cleanup();
 }
 
@@ -76,23 +160,84 @@ void transaction::rollback()
      * clear insert action map
      *
      **************/
-    while (!transaction_data_->actions_.empty()) {
-      action_iterator i = transaction_data_->actions_.begin();
-      action_ptr a = *i;
-      transaction_data_->actions_.erase(i);
-      restore(a);
+    // the observer reverts the savepoints it wrote
+    bool written = commiting_;
+    for (const savepoint_mark &mark : transaction_data_->savepoints_) {
+      written = written || mark.written;
+    }
+    {
+      detail::write_guard guard(transaction_data_->store_.get());
+      restore_all(*transaction_data_);
     }
 
-    if (commiting_) {
+    if (written) {
       transaction_data_->observer_->on_rollback();
-      commiting_ = false;
     }
+    commiting_ = false;
 
     // clear container
     cleanup();
   }
 }
 
+std::size_t transaction::savepoint()
+{
+  if (!transaction_data_->store_.get().has_transaction() ||
+      transaction_data_->store_.get().current_transaction() != *this)
+  {
+    throw object_exception("transaction: transaction isn't current transaction");
+  }
+  std::size_t sp = transaction_data_->savepoints_.size();
+  // the observer gets the actions it hasn't written yet
+  t_action_vector write_set;
+  action_coalescer coalescer;
+  coalescer.coalesce(t_action_vector(transaction_data_->actions_.begin() + transaction_data_->written_, transaction_data_->actions_.end()), write_set);
+  bool written = transaction_data_->observer_->on_savepoint(sp, write_set);
+  if (written) {
+    transaction_data_->written_ = transaction_data_->actions_.size();
+  }
+  transaction_data_->savepoints_.push_back(savepoint_mark{
+    transaction_data_->actions_.size(),
+    transaction_data_->object_buffer_.size(),
+    written,
+    false
+  });
+  // objects modified from now on are backed up again
+  transaction_data_->id_action_index_map_.clear();
+  return sp;
+}
+
+void transaction::rollback_to(std::size_t sp)
+{
+  check_savepoint(sp);
+  // the observer goes first, the store stays
+  // untouched if it fails
+  if (transaction_data_->savepoints_[sp].written) {
+    transaction_data_->observer_->on_rollback_to(sp);
+  }
+  detail::write_guard guard(transaction_data_->store_.get());
+  while (transaction_data_->savepoints_.size() > sp + 1) {
+    restore_from(*transaction_data_, transaction_data_->savepoints_.back().actions, transaction_data_->savepoints_.back().bytes);
+    transaction_data_->savepoints_.pop_back();
+  }
+  restore_from(*transaction_data_, transaction_data_->savepoints_.back().actions, transaction_data_->savepoints_.back().bytes);
+  transaction_data_->written_ = std::min(transaction_data_->written_, transaction_data_->actions_.size());
+  transaction_data_->id_action_index_map_.clear();
+}
+
+void transaction::release(std::size_t sp)
+{
+  check_savepoint(sp);
+  if (transaction_data_->savepoints_[sp].written) {
+    transaction_data_->observer_->on_release(sp);
+  }
+  // the marks are kept, they still separate
+  // the backups of the objects
+  for (std::size_t i = sp; i < transaction_data_->savepoints_.size(); ++i) {
+    transaction_data_->savepoints_[i].released = true;
+  }
+}
+
 void transaction::backup(const action_ptr &a, const oos::object_proxy *proxy)
 {
   a->backup(transaction_data_->object_buffer_);
@@ -100,9 +245,85 @@ void transaction::backup(const action_ptr &a, const oos::object_proxy *proxy)
   transaction_data_->id_action_index_map_.insert(std::make_pair(proxy->id(), transaction_data_->actions_.size() - 1));
 }
 
-void transaction::restore(const action_ptr &a)
+void transaction::restore_all(transaction_data &data)
 {
-  a->restore(transaction_data_->object_buffer_, &transaction_data_->store_.get());
+  // objects may be backed up once per savepoint,
+  // the latest backups are restored first
+  while (!data.savepoints_.empty()) {
+    restore_from(data, data.savepoints_.back().actions, data.savepoints_.back().bytes);
+    data.savepoints_.pop_back();
+  }
+  while (!data.actions_.empty()) {
+    action_iterator i = data.actions_.begin();
+    action_ptr a = *i;
+    data.actions_.erase(i);
+    a->restore(data.object_buffer_, &data.store_.get());
+  }
+}
+
+void transaction::restore_from(transaction_data &data, t_action_vector::size_type first, byte_buffer::size_type offset)
+{
+  // the backups of the actions are at the end of the buffer
+  byte_buffer tail;
+  data.object_buffer_.split(offset, tail);
+  t_action_vector actions(data.actions_.begin() + first, data.actions_.end());
+  data.actions_.erase(data.actions_.begin() + first, data.actions_.end());
+  for (action_ptr &a : actions) {
+    a->restore(tail, &data.store_.get());
+  }
+}
+
+transaction::t_action_vector::size_type transaction::first_action() const
+{
+  return transaction_data_->savepoints_.empty() ? 0 : transaction_data_->savepoints_.back().actions;
+}
+
+transaction::undo_log::undo_log(transaction_data &data)
+  : data_(data.store_.get(), std::shared_ptr<observer>())
+{
+  data_.actions_.swap(data.actions_);
+  data_.savepoints_.swap(data.savepoints_);
+  data.object_buffer_.split(0, data_.object_buffer_);
+}
+
+void transaction::undo_log::rollback()
+{
+  detail::write_guard guard(data_.store_.get());
+  restore_all(data_);
+}
+
+void transaction::check_savepoint(std::size_t sp) const
+{
+  if (!transaction_data_->store_.get().has_transaction() ||
+      transaction_data_->store_.get().current_transaction() != *this)
+  {
+    throw object_exception("transaction: transaction isn't current transaction");
+  }
+  if (sp >= transaction_data_->savepoints_.size() || transaction_data_->savepoints_[sp].released) {
+    throw object_exception("transaction: unknown savepoint");
+  }
+}
+
+void transaction::notify_observers(const t_action_vector &write_set)
+{
+  object_store &store = transaction_data_->store_.get();
+  if (!store.has_observers()) {
+    return;
+  }
+  notification_collector collector;
+  for (const action_ptr &a : write_set) {
+    a->accept(&collector);
+  }
+  store.notify_insert(collector.inserted.data(), collector.inserted.size());
+  store.notify_update(collector.updated.data(), collector.updated.size());
+  store.notify_delete(collector.deleted.data(), collector.deleted.size());
+}
+
+void transaction::mark_modified(object_proxy *proxy)
+{
+  if (proxy->node()) {
+    proxy->node()->mark_modified(proxy);
+  }
 }
 
 void transaction::cleanup()
@@ -110,6 +331,8 @@ void transaction::cleanup()
   transaction_data_->actions_.clear();
   transaction_data_->object_buffer_.clear();
   transaction_data_->id_action_index_map_.clear();
+  transaction_data_->savepoints_.clear();
+  transaction_data_->written_ = 0;
   transaction_data_->store_.get().pop_transaction();
 }
 
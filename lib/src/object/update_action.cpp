@@ -4,6 +4,7 @@
 
 #include "object/update_action.hpp"
 #include "object/action_visitor.hpp"
+#include "object/object_proxy.hpp"
 
 namespace oos {
 
@@ -30,6 +31,10 @@ void update_action::backup(byte_buffer &buffer)
 void update_action::restore(byte_buffer &buffer, object_store *store)
 {
   restore_func_(buffer, this, store, *serializer_);
+  if (proxy_->node()) {
+    // restored values must be reindexed
+    proxy_->node()->mark_modified(proxy_);
+  }
 }
 
 delete_action *update_action::release_delete_action()
@@ -37,4 +42,27 @@ delete_action *update_action::release_delete_action()
   return delete_action_.release();
 }
 
+std::vector<std::string> update_action::modified_fields()
+{
+  if (proxy_->obj() == nullptr) {
+    return std::vector<std::string>();
+  }
+  detail::t_field_values current;
+  record_func_(this, current);
+  if (all_modified_) {
+    std::vector<std::string> fields;
+    for (const auto &field : current) {
+      fields.push_back(field.first);
+    }
+    return fields;
+  }
+  return detail::field_recorder::modified_fields(fields_, current);
+}
+
+void update_action::mark_all_modified()
+{
+  all_modified_ = true;
+  fields_.clear();
+}
+
 }
\ No newline at end of file
@@ -20,6 +20,13 @@ std::string basic_table::name() const
   return node_->type();
 }
 
+void basic_table::load_identifiers(object_store &) { }
+
+bool basic_table::fetch(object_proxy *)
+{
+  return false;
+}
+
 bool basic_table::is_loaded() const
 {
   return is_loaded_;
@@ -40,6 +47,31 @@ basic_table::t_table_map::iterator basic_table::end_table()
   return persistence_.end();
 }
 
+prototype_node *basic_table::node() const
+{
+  return node_;
+}
+
+void basic_table::update(object_proxy *proxy, const std::vector<std::string> &)
+{
+  update(proxy);
+}
+
+void basic_table::fetched(object_proxy *proxy, std::size_t bytes)
+{
+  persistence_.eviction().loaded(proxy, bytes);
+}
+
+connection &basic_table::conn()
+{
+  return persistence_.conn();
+}
+
+std::recursive_mutex &basic_table::connection_mutex()
+{
+  return persistence_.connection_mutex();
+}
+
 void basic_table::append_relation_items(const std::string &, detail::t_identifier_map &, basic_table::t_relation_item_map &) { }
 
 }
\ No newline at end of file
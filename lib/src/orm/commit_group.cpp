@@ -0,0 +1,185 @@
+#include "orm/commit_group.hpp"
+
+#include "sql/connection.hpp"
+
+#include <string>
+
+namespace oos {
+
+commit_group::commit_group(connection &conn, std::recursive_mutex &conn_mutex)
+  : connection_(conn)
+  , connection_mutex_(conn_mutex)
+{}
+
+commit_group::~commit_group()
+{
+  disable();
+}
+
+void commit_group::enable(std::size_t batch_size, std::chrono::milliseconds window)
+{
+  disable();
+  std::lock_guard<std::mutex> guard(mutex_);
+  enabled_ = true;
+  batch_size_ = batch_size;
+  window_ = window;
+  if (window_.count() > 0) {
+    stop_ = false;
+    flusher_ = std::thread(&commit_group::run, this);
+  }
+}
+
+void commit_group::disable()
+{
+  stop();
+  std::lock_guard<std::recursive_mutex> conn_guard(connection_mutex_);
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (open_) {
+    commit_group_locked();
+  }
+  enabled_ = false;
+}
+
+bool commit_group::enabled() const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return enabled_;
+}
+
+std::shared_future<void> commit_group::execute(const std::function<void()> &write)
+{
+  // the connection mutex is always taken first
+  std::lock_guard<std::recursive_mutex> conn_guard(connection_mutex_);
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!enabled_) {
+    connection_.begin();
+    try {
+      write();
+    } catch (...) {
+      connection_.rollback();
+      throw;
+    }
+    connection_.commit();
+    ++commits_;
+    std::promise<void> done;
+    done.set_value();
+    return done.get_future().share();
+  }
+
+  if (!open_) {
+    open_group();
+  }
+  // a failing transaction must not take the group with it
+  std::string savepoint("oos_group_" + std::to_string(++savepoints_));
+  connection_.savepoint(savepoint);
+  try {
+    write();
+  } catch (...) {
+    connection_.rollback_to(savepoint);
+    connection_.release(savepoint);
+    if (pending_ == 0) {
+      // nobody waits for the group yet
+      connection_.rollback();
+      open_ = false;
+      promise_.reset();
+    }
+    throw;
+  }
+  connection_.release(savepoint);
+  ++pending_;
+  std::shared_future<void> result = future_;
+  if (batch_size_ > 0 && pending_ >= batch_size_) {
+    commit_group_locked();
+  }
+  return result;
+}
+
+void commit_group::flush()
+{
+  std::lock_guard<std::recursive_mutex> conn_guard(connection_mutex_);
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (open_) {
+    commit_group_locked();
+  }
+}
+
+std::size_t commit_group::pending() const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return pending_;
+}
+
+std::size_t commit_group::commits() const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return commits_;
+}
+
+void commit_group::open_group()
+{
+  connection_.begin();
+  open_ = true;
+  opened_ = std::chrono::steady_clock::now();
+  promise_ = std::make_shared<std::promise<void>>();
+  future_ = promise_->get_future().share();
+  cond_.notify_all();
+}
+
+void commit_group::commit_group_locked()
+{
+  std::shared_ptr<std::promise<void>> promise(std::move(promise_));
+  open_ = false;
+  pending_ = 0;
+  try {
+    connection_.commit();
+    ++commits_;
+  } catch (...) {
+    std::exception_ptr error = std::current_exception();
+    // the changes of the group are lost, don't
+    // leave the database transaction open
+    try {
+      connection_.rollback();
+    } catch (...) {}
+    promise->set_exception(error);
+    return;
+  }
+  promise->set_value();
+}
+
+void commit_group::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stop_) {
+    if (!open_) {
+      cond_.wait(lock);
+      continue;
+    }
+    std::chrono::steady_clock::time_point deadline = opened_ + window_;
+    if (std::chrono::steady_clock::now() < deadline) {
+      cond_.wait_until(lock, deadline);
+      continue;
+    }
+    // take the connection mutex first like all other
+    // users of the connection and check the group again
+    lock.unlock();
+    std::lock_guard<std::recursive_mutex> conn_guard(connection_mutex_);
+    lock.lock();
+    if (open_ && std::chrono::steady_clock::now() >= opened_ + window_) {
+      commit_group_locked();
+    }
+  }
+}
+
+void commit_group::stop()
+{
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+  if (flusher_.joinable()) {
+    flusher_.join();
+  }
+}
+
+}
@@ -0,0 +1,130 @@
+#include "orm/eviction_policy.hpp"
+
+#include "object/object_store.hpp"
+
+#include <chrono>
+
+namespace oos {
+
+void eviction_policy::budget(std::size_t bytes)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  budget_ = bytes;
+}
+
+std::size_t eviction_policy::budget() const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return budget_;
+}
+
+std::size_t eviction_policy::size() const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return size_;
+}
+
+std::size_t eviction_policy::evicted() const
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  return evicted_;
+}
+
+void eviction_policy::loaded(object_proxy *proxy, std::size_t bytes)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (budget_ == 0 || proxy->node()->has_many()) {
+    return;
+  }
+  // the object is about to be used, don't evict it right away
+  proxy->node()->track_access(true);
+  proxy->accessed(true);
+  clock_.insert(hand_, entry{proxy->id(), bytes});
+  size_ += bytes;
+  if (size_ > budget_) {
+    sweep_locked(*proxy->ostore());
+  }
+}
+
+void eviction_policy::written(const std::shared_future<void> &done, std::vector<std::pair<unsigned long, unsigned long>> changes)
+{
+  if (changes.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  writes_.push_back(write{done, std::move(changes)});
+}
+
+void eviction_policy::sweep(object_store &store)
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  sweep_locked(store);
+}
+
+void eviction_policy::clear()
+{
+  std::lock_guard<std::mutex> guard(mutex_);
+  clock_.clear();
+  hand_ = clock_.end();
+  size_ = 0;
+  writes_.clear();
+}
+
+void eviction_policy::sweep_locked(object_store &store)
+{
+  // the store lock isn't waited for, a thread holding
+  // it shared (i.e. a reader fetching an object) leaves
+  // the sweep to the next safe point
+  std::unique_lock<rw_lock> guard(store.lock(), std::try_to_lock);
+  if (!guard.owns_lock() || !store.may_evict()) {
+    return;
+  }
+  // the writes are durable in the order of their commits
+  while (!writes_.empty() && writes_.front().done.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+    bool durable = true;
+    try {
+      writes_.front().done.get();
+    } catch (...) {
+      durable = false;
+    }
+    // objects of a failed write stay changed
+    for (const std::pair<unsigned long, unsigned long> &change : writes_.front().changes) {
+      object_proxy *proxy = durable ? store.find_proxy(change.first) : nullptr;
+      if (proxy != nullptr) {
+        proxy->mark_written(change.second);
+      }
+    }
+    writes_.pop_front();
+  }
+  if (budget_ > 0 && size_ > budget_) {
+    evict(store);
+  }
+}
+
+void eviction_policy::evict(object_store &store)
+{
+  // one turn of the clock at most, objects accessed
+  // since the last turn survive
+  for (std::size_t n = clock_.size(); n > 0 && size_ > budget_; --n) {
+    if (hand_ == clock_.end()) {
+      hand_ = clock_.begin();
+    }
+    object_proxy *proxy = store.find_proxy(hand_->id);
+    if (proxy == nullptr || proxy->obj() == nullptr) {
+      // removed or already evicted
+      size_ -= hand_->bytes;
+      hand_ = clock_.erase(hand_);
+    } else if (proxy->accessed()) {
+      proxy->accessed(false);
+      ++hand_;
+    } else if (store.evict(proxy)) {
+      size_ -= hand_->bytes;
+      hand_ = clock_.erase(hand_);
+      ++evicted_;
+    } else {
+      ++hand_;
+    }
+  }
+}
+
+}
@@ -9,12 +9,14 @@ namespace oos {
 
 persistence::persistence(const std::string &dns)
   : connection_(dns)
+  , group_commit_(connection_, connection_mutex_)
 {
   connection_.open();
 }
 
 persistence::~persistence()
 {
+  group_commit_.disable();
   tables_.clear();
   connection_.close();
 }
@@ -31,6 +33,7 @@ void persistence::create()
 
 void persistence::drop()
 {
+  group_commit_.flush();
   for (t_table_map::value_type &val : tables_) {
     if (!connection_.exists(val.second->name())) {
       continue;
@@ -42,6 +45,7 @@ void persistence::drop()
 void persistence::clear()
 {
   store_.clear();
+  eviction_.clear();
 }
 
 persistence::t_table_map::iterator persistence::find_table(const std::string &type)
@@ -78,5 +82,30 @@ const connection &persistence::conn() const {
   return connection_;
 }
 
+eviction_policy &persistence::eviction()
+{
+  return eviction_;
+}
+
+const eviction_policy &persistence::eviction() const
+{
+  return eviction_;
+}
+
+std::recursive_mutex &persistence::connection_mutex()
+{
+  return connection_mutex_;
+}
+
+commit_group &persistence::group_commit()
+{
+  return group_commit_;
+}
+
+const commit_group &persistence::group_commit() const
+{
+  return group_commit_;
+}
+
 
 }
\ No newline at end of file
@@ -11,11 +11,17 @@ session::session(persistence &p)
   : persistence_(p)
   , observer_(new session_observer(*this))
 {
-
+  std::promise<void> done;
+  done.set_value();
+  last_commit_ = done.get_future().share();
 }
 
-void session::load()
+void session::load(std::size_t expected_objects)
 {
+  std::lock_guard<std::recursive_mutex> guard(persistence_.connection_mutex());
+  if (expected_objects > 0) {
+    persistence_.store().reserve(expected_objects);
+  }
   prototype_iterator first = persistence_.store().begin();
   prototype_iterator last = persistence_.store().end();
   while (first != last) {
@@ -35,8 +41,51 @@ void session::load()
   }
 }
 
+void session::load(load_mode mode, std::size_t expected_objects)
+{
+  if (mode == load_mode::EAGER) {
+    load(expected_objects);
+    return;
+  }
+  // fetched objects are published to reader threads
+  // without the store lock, so they may not insert
+  // the items of their has many relations
+  for (prototype_iterator i = persistence_.store().begin(); i != persistence_.store().end(); ++i) {
+    if (i->has_many()) {
+      throw object_exception("lazy loading of types with has many relations isn't supported");
+    }
+  }
+  std::lock_guard<std::recursive_mutex> guard(persistence_.connection_mutex());
+  if (expected_objects > 0) {
+    persistence_.store().reserve(expected_objects);
+  }
+  prototype_iterator first = persistence_.store().begin();
+  prototype_iterator last = persistence_.store().end();
+  while (first != last) {
+    prototype_node &node = (*first++);
+    if (node.is_abstract()) {
+      continue;
+    }
+
+    persistence::t_table_map::iterator i = persistence_.find_table(node.type());
+    if (i == persistence_.end()) {
+      // Todo: replace with persistence exception
+      throw object_exception("couldn't find table");
+    }
+    node.loader(i->second.get());
+    if (mode == load_mode::KEYS) {
+      i->second->load_identifiers(persistence_.store());
+    }
+  }
+}
+
 transaction session::begin()
 {
+  if (!persistence_.store().has_transaction()) {
+    undo_failed_commits();
+  }
+  // no transaction is active, a safe point to evict objects
+  persistence_.eviction().sweep(persistence_.store());
   transaction tr(persistence_.store(), observer_);
   tr.begin();
   return persistence_.store().current_transaction();
@@ -52,11 +101,34 @@ const object_store &session::store() const
   return persistence_.store();
 }
 
+std::shared_future<void> session::last_commit() const
+{
+  return last_commit_;
+}
+
 void session::load(const persistence::table_ptr &table)
 {
   table->load(persistence_.store());
 }
 
+void session::undo_failed_commits()
+{
+  // the groups are committed in order
+  std::vector<std::shared_ptr<transaction::undo_log>> failed;
+  while (!pending_commits_.empty() && pending_commits_.front().done.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+    try {
+      pending_commits_.front().done.get();
+    } catch (...) {
+      failed.push_back(pending_commits_.front().log);
+    }
+    pending_commits_.pop_front();
+  }
+  // the latest changes are reverted first
+  for (auto i = failed.rbegin(); i != failed.rend(); ++i) {
+    (*i)->rollback();
+  }
+}
+
 session::session_observer::session_observer(session &s)
   : session_(s)
 {}
@@ -67,17 +139,130 @@ void session::session_observer::on_begin()
 
 void session::session_observer::on_commit(transaction::t_action_vector &actions)
 {
-  session_.persistence_.conn().begin();
+  if (connection_lock_.owns_lock() || !session_.persistence_.group_commit().enabled()) {
+    // on failure the database transaction is
+    // kept open until the transaction is rolled back
+    open();
+    write(actions);
+    session_.persistence_.conn().commit();
+    close();
+    std::promise<void> done;
+    done.set_value();
+    session_.last_commit_ = done.get_future().share();
+  } else {
+    changes_.clear();
+    session_.last_commit_ = session_.persistence_.group_commit().execute([&]() {
+      write(actions);
+    });
+  }
+  // the objects may be evicted once the changes are durable
+  session_.persistence_.eviction().written(session_.last_commit_, std::move(changes_));
+  changes_.clear();
+}
+
+void session::session_observer::on_rollback()
+{
+  // otherwise the commit group already rolled
+  // back the changes written to the database
+  if (connection_lock_.owns_lock()) {
+    changes_.clear();
+    session_.persistence_.conn().rollback();
+    close();
+  }
+}
+
+bool session::session_observer::on_savepoint(std::size_t sp, transaction::t_action_vector &actions)
+{
+  // a transaction of a commit group can't be kept
+  // open, so the savepoint stays in the object store
+  if (!connection_lock_.owns_lock() && session_.persistence_.group_commit().enabled()) {
+    return false;
+  }
+  open();
+  // the written objects may still be rolled back,
+  // the transaction marks them deleted on commit
+  at_savepoint_ = true;
+  try {
+    write(actions);
+  } catch (...) {
+    at_savepoint_ = false;
+    throw;
+  }
+  at_savepoint_ = false;
+  session_.persistence_.conn().savepoint(savepoint_name(sp));
+  return true;
+}
 
+void session::session_observer::on_rollback_to(std::size_t sp)
+{
+  session_.persistence_.conn().rollback_to(savepoint_name(sp));
+  // some of the written objects are reverted, they
+  // are kept until they are written again
+  changes_.clear();
+}
+
+void session::session_observer::on_release(std::size_t sp)
+{
+  session_.persistence_.conn().release(savepoint_name(sp));
+}
+
+bool session::session_observer::durable() const
+{
+  if (session_.last_commit_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    return false;
+  }
+  try {
+    session_.last_commit_.get();
+  } catch (...) {
+    return false;
+  }
+  return true;
+}
+
+void session::session_observer::on_pending(const std::shared_ptr<transaction::undo_log> &log)
+{
+  session_.pending_commits_.push_back(pending_commit{session_.last_commit_, log});
+  // the logs of durable commits aren't needed anymore,
+  // failed ones are rolled back at the next begin
+  while (!session_.pending_commits_.empty() && session_.pending_commits_.front().done.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+    try {
+      session_.pending_commits_.front().done.get();
+    } catch (...) {
+      break;
+    }
+    session_.pending_commits_.pop_front();
+  }
+}
+
+std::string session::session_observer::savepoint_name(std::size_t sp)
+{
+  return "oos_savepoint_" + std::to_string(sp);
+}
+
+void session::session_observer::open()
+{
+  if (connection_lock_.owns_lock()) {
+    return;
+  }
+  connection_lock_ = std::unique_lock<std::recursive_mutex>(session_.persistence_.connection_mutex());
+  try {
+    session_.persistence_.conn().begin();
+  } catch (...) {
+    close();
+    throw;
+  }
+}
+
+void session::session_observer::write(transaction::t_action_vector &actions)
+{
   for (transaction::action_ptr &actptr : actions) {
     actptr->accept(this);
   }
-  session_.persistence_.conn().commit();
 }
 
-void session::session_observer::on_rollback()
+void session::session_observer::close()
 {
-  session_.persistence_.conn().rollback();
+  connection_lock_ = std::unique_lock<std::recursive_mutex>();
 }
 
 void session::session_observer::visit(insert_action *act)
@@ -91,7 +276,9 @@ void session::session_observer::visit(insert_action *act)
   insert_action::const_iterator first = act->begin();
   insert_action::const_iterator last = act->end();
   while (first != last) {
-    i->second->insert((*first++));
+    object_proxy *proxy = *first++;
+    i->second->insert(proxy);
+    changes_.push_back(std::make_pair(proxy->id(), proxy->changes()));
   }
 
 }
@@ -104,7 +291,8 @@ void session::session_observer::visit(update_action *act)
     return;
   }
 
-  i->second->update(act->proxy());
+  i->second->update(act->proxy(), act->modified_fields());
+  changes_.push_back(std::make_pair(act->proxy()->id(), act->proxy()->changes()));
 }
 
 void session::session_observer::visit(delete_action *act)
@@ -117,7 +305,9 @@ void session::session_observer::visit(delete_action *act)
 
   i->second->remove(act->proxy());
 
-  act->mark_deleted();
+  if (!at_savepoint_) {
+    act->mark_deleted();
+  }
 }
 
 
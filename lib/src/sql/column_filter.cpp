@@ -0,0 +1,145 @@
+#include "sql/column_filter.hpp"
+
+#include <algorithm>
+
+namespace oos {
+namespace detail {
+
+column_filter::column_filter(serializer &target, const std::vector<std::string> &columns)
+  : target_(target)
+  , columns_(columns)
+{}
+
+void column_filter::serialize(const char *id, char &x)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x);
+  }
+}
+
+void column_filter::serialize(const char *id, short &x)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x);
+  }
+}
+
+void column_filter::serialize(const char *id, int &x)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x);
+  }
+}
+
+void column_filter::serialize(const char *id, long &x)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x);
+  }
+}
+
+void column_filter::serialize(const char *id, unsigned char &x)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x);
+  }
+}
+
+void column_filter::serialize(const char *id, unsigned short &x)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x);
+  }
+}
+
+void column_filter::serialize(const char *id, unsigned int &x)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x);
+  }
+}
+
+void column_filter::serialize(const char *id, unsigned long &x)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x);
+  }
+}
+
+void column_filter::serialize(const char *id, bool &x)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x);
+  }
+}
+
+void column_filter::serialize(const char *id, float &x)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x);
+  }
+}
+
+void column_filter::serialize(const char *id, double &x)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x);
+  }
+}
+
+void column_filter::serialize(const char *id, char *x, size_t s)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x, s);
+  }
+}
+
+void column_filter::serialize(const char *id, std::string &x)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x);
+  }
+}
+
+void column_filter::serialize(const char *id, varchar_base &x)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x);
+  }
+}
+
+void column_filter::serialize(const char *id, time &x)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x);
+  }
+}
+
+void column_filter::serialize(const char *id, date &x)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x);
+  }
+}
+
+void column_filter::serialize(const char *id, basic_identifier &x)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x);
+  }
+}
+
+void column_filter::serialize(const char *id, identifiable_holder &x, cascade_type cascade)
+{
+  if (accepts(id)) {
+    target_.serialize(id, x, cascade);
+  }
+}
+
+bool column_filter::accepts(const char *id) const
+{
+  return std::find(columns_.begin(), columns_.end(), id) != columns_.end();
+}
+
+}
+}
@@ -59,6 +59,21 @@ void connection::rollback()
   impl_->rollback();
 }
 
+void connection::savepoint(const std::string &name)
+{
+  impl_->savepoint(name);
+}
+
+void connection::rollback_to(const std::string &name)
+{
+  impl_->rollback_to(name);
+}
+
+void connection::release(const std::string &name)
+{
+  impl_->release(name);
+}
+
 std::string connection::type() const
 {
   return type_;
@@ -17,84 +17,228 @@
 
 #include "tools/byte_buffer.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 namespace oos {
 
-byte_buffer::byte_buffer()
+namespace {
+
+enum class pool_state { NONE, ALIVE, DESTROYED };
+
+// trivially destructible, so it can still be read
+// by buffers destroyed after the pool of the thread
+thread_local pool_state pool_state_ = pool_state::NONE;
+
+}
+
+/*
+ * Keeps released chunks of one thread for reuse
+ * up to a limit of pooled bytes.
+ */
+class byte_buffer::chunk_pool
 {
-  chunk_list_.push_back(buffer_chunk());
+public:
+  chunk_pool()
+  {
+    pool_state_ = pool_state::ALIVE;
+  }
+
+  ~chunk_pool()
+  {
+    pool_state_ = pool_state::DESTROYED;
+    for (buffer_chunk *chunk : free_) {
+      delete chunk;
+    }
+  }
+
+  chunk_pool(const chunk_pool&) = delete;
+  chunk_pool& operator=(const chunk_pool&) = delete;
+
+  buffer_chunk* acquire(size_type size)
+  {
+    // take the smallest chunk large enough
+    t_chunk_vector::iterator best = free_.end();
+    for (t_chunk_vector::iterator i = free_.begin(); i != free_.end(); ++i) {
+      if ((*i)->capacity >= size && (best == free_.end() || (*i)->capacity < (*best)->capacity)) {
+        best = i;
+      }
+    }
+    if (best == free_.end()) {
+      return new buffer_chunk(size);
+    }
+    buffer_chunk *chunk = *best;
+    *best = free_.back();
+    free_.pop_back();
+    bytes_ -= chunk->capacity;
+    chunk->read_cursor = 0;
+    chunk->write_cursor = 0;
+    return chunk;
+  }
+
+  void recycle(buffer_chunk *chunk)
+  {
+    if (bytes_ + chunk->capacity > limit_) {
+      delete chunk;
+      return;
+    }
+    free_.push_back(chunk);
+    bytes_ += chunk->capacity;
+  }
+
+  size_type bytes() const
+  {
+    return bytes_;
+  }
+
+  void limit(size_type l)
+  {
+    limit_ = l;
+    while (bytes_ > limit_) {
+      bytes_ -= free_.back()->capacity;
+      delete free_.back();
+      free_.pop_back();
+    }
+  }
+
+private:
+  t_chunk_vector free_;
+  size_type bytes_ = 0;
+  size_type limit_ = 256 * chunk_size;
+};
+
+const byte_buffer::size_type byte_buffer::chunk_size;
+
+byte_buffer::chunk_pool& byte_buffer::pool()
+{
+  static thread_local chunk_pool pool_;
+  return pool_;
 }
 
-byte_buffer::~byte_buffer()
+byte_buffer::byte_buffer()
 {}
 
+byte_buffer::~byte_buffer()
+{
+  clear();
+}
+
 void byte_buffer::append(const void *bytes, byte_buffer::size_type size)
 {
   const char *ptr = (const char*)bytes;
-  size_type bytes_written = 0;
-  while (chunk_list_.back().available() < size) {
-    buffer_chunk &chunk = chunk_list_.back();
-    // copy first part of bytes
-    std::copy(ptr+bytes_written, ptr+bytes_written+chunk.available(), &chunk.data[chunk.write_cursor]);
-    // adjust remaining size
-    size -= chunk.available();
-    // adjust written bytes
-    bytes_written += chunk.available();
-    // adjust cursor
-    chunk.write_cursor += chunk.available();
-    // append new buffer chunk
-    chunk_list_.push_back(buffer_chunk());
-  }
-  if (size > 0) {
-    buffer_chunk &chunk = chunk_list_.back();
-    // append remaining bytes
-    std::copy(ptr+bytes_written, ptr+bytes_written+size, &chunk.data[chunk.write_cursor]);
-    chunk.write_cursor += size;
+  size_ += size;
+  while (size > 0) {
+    if (chunks_.empty() || chunks_.back()->available() == 0) {
+      add_chunk(size);
+    }
+    buffer_chunk &chunk = *chunks_.back();
+    size_type count = std::min(size, chunk.available());
+    std::memcpy(chunk.data + chunk.write_cursor, ptr, count);
+    chunk.write_cursor += count;
+    ptr += count;
+    size -= count;
   }
 }
 
 void byte_buffer::release(void *bytes, byte_buffer::size_type size)
 {
   char *ptr = (char*)bytes;
-  size_type bytes_read = 0;
-  while (!chunk_list_.empty() && chunk_list_.front().used() <= size) {
-    buffer_chunk &chunk = chunk_list_.front();
-    // available bytes are not enough
-    // copy first part
-    std::copy(chunk.data.begin()+chunk.read_cursor, chunk.data.begin()+chunk.read_cursor+chunk.used(), ptr+bytes_read);
-    // adjust remaining size
-    size -= chunk.used();
-    // adjust bytes read
-    bytes_read += chunk.used();
-    // pop back
-    chunk_list_.pop_front();
-    // get next chunk
-  }
-  if (size > 0) {
-    buffer_chunk &chunk = chunk_list_.front();
-    // copy rest of bytes
-    std::copy(chunk.data.begin()+chunk.read_cursor, chunk.data.begin()+chunk.read_cursor+size, ptr+bytes_read);
-    // adjust read cursor
-    chunk.read_cursor += size;
-  }
-  if (chunk_list_.empty()) {
-    chunk_list_.push_back(buffer_chunk());
+  size_ -= std::min(size, size_);
+  while (size > 0 && first_ < chunks_.size()) {
+    buffer_chunk &chunk = *chunks_[first_];
+    size_type count = std::min(size, chunk.used());
+    std::memcpy(ptr, chunk.data + chunk.read_cursor, count);
+    chunk.read_cursor += count;
+    ptr += count;
+    size -= count;
+    if (chunk.used() == 0 && first_ + 1 < chunks_.size()) {
+      // chunk completely read, the last chunk is kept for writing
+      recycle(chunks_[first_]);
+      chunks_[first_++] = nullptr;
+    }
+  }
+  if (size_ == 0) {
+    clear();
   }
 }
 
-byte_buffer::size_type byte_buffer::size() const
+void byte_buffer::reserve(byte_buffer::size_type size)
 {
-  return (chunk_list_.size() * BUF_SIZE) - chunk_list_.back().available() - chunk_list_.front().released();
-  if (chunk_list_.size() == 1) {
-    return BUF_SIZE - chunk_list_.front().available();
-  } else {
-    return (chunk_list_.size() * BUF_SIZE) - chunk_list_.back().available();
+  if (!chunks_.empty() && chunks_.back()->available() >= size) {
+    return;
   }
+  add_chunk(size);
+}
+
+void byte_buffer::split(byte_buffer::size_type offset, byte_buffer &tail)
+{
+  if (offset >= size_) {
+    return;
+  }
+  // find the chunk containing the first byte to move
+  t_chunk_vector::size_type i = first_;
+  size_type skipped = 0;
+  while (skipped + chunks_[i]->used() <= offset) {
+    skipped += chunks_[i++]->used();
+  }
+  buffer_chunk &chunk = *chunks_[i];
+  size_type cursor = chunk.read_cursor + (offset - skipped);
+  tail.reserve(size_ - offset);
+  tail.append(chunk.data + cursor, chunk.write_cursor - cursor);
+  chunk.write_cursor = cursor;
+  for (t_chunk_vector::size_type j = i + 1; j < chunks_.size(); ++j) {
+    tail.append(chunks_[j]->data + chunks_[j]->read_cursor, chunks_[j]->used());
+    recycle(chunks_[j]);
+  }
+  chunks_.resize(i + 1);
+  size_ = offset;
+  if (size_ == 0) {
+    clear();
+  }
+}
+
+byte_buffer::size_type byte_buffer::size() const
+{
+  return size_;
 }
 
 void byte_buffer::clear()
 {
-  chunk_list_.clear();
-  chunk_list_.push_back(buffer_chunk());
+  for (t_chunk_vector::size_type i = first_; i < chunks_.size(); ++i) {
+    recycle(chunks_[i]);
+  }
+  // the vector keeps its capacity
+  chunks_.clear();
+  first_ = 0;
+  size_ = 0;
+}
+
+byte_buffer::size_type byte_buffer::pooled_bytes()
+{
+  return pool_state_ != pool_state::DESTROYED ? pool().bytes() : 0;
+}
+
+void byte_buffer::pool_limit(byte_buffer::size_type limit)
+{
+  if (pool_state_ != pool_state::DESTROYED) {
+    pool().limit(limit);
+  }
+}
+
+void byte_buffer::add_chunk(byte_buffer::size_type size)
+{
+  // chunks grow in steps of the minimal chunk size
+  size_type capacity = std::max<size_type>(1, (size + chunk_size - 1) / chunk_size) * chunk_size;
+  chunks_.push_back(pool_state_ != pool_state::DESTROYED ? pool().acquire(capacity) : new buffer_chunk(capacity));
+}
+
+void byte_buffer::recycle(buffer_chunk *chunk)
+{
+  if (pool_state_ != pool_state::DESTROYED) {
+    pool().recycle(chunk);
+  } else {
+    delete chunk;
+  }
 }
 
 }
@@ -19,6 +19,13 @@
 
 namespace oos {
 
+unsigned long sequencer_impl::reserve(unsigned long n)
+{
+  unsigned long first = current() + 1;
+  update(first + n - 1);
+  return first;
+}
+
 default_sequencer::default_sequencer()
   : number_(0)
 {}
@@ -55,6 +62,132 @@ unsigned long default_sequencer::update(unsigned long id)
   return number_;
 }
 
+namespace {
+
+std::atomic<unsigned long> block_sequencer_uid(0);
+
+// the blocks of the last few sequencers used by this thread
+struct thread_block
+{
+  unsigned long owner = 0;
+  unsigned long epoch = 0;
+  unsigned long next = 1;
+  unsigned long last = 0;
+};
+
+const std::size_t thread_block_count = 4;
+
+// raises the value to the given id if the id is greater
+void raise_to(std::atomic<unsigned long> &value, unsigned long id)
+{
+  unsigned long current = value.load(std::memory_order_relaxed);
+  while (id > current && !value.compare_exchange_weak(current, id, std::memory_order_relaxed)) {
+  }
+}
+
+thread_local thread_block thread_blocks[thread_block_count];
+thread_local std::size_t thread_block_victim = 0;
+
+thread_block& acquire_thread_block(unsigned long owner)
+{
+  for (thread_block &block : thread_blocks) {
+    if (block.owner == owner) {
+      return block;
+    }
+  }
+  thread_block &block = thread_blocks[thread_block_victim++ % thread_block_count];
+  block = thread_block();
+  block.owner = owner;
+  return block;
+}
+
+}
+
+block_sequencer::block_sequencer(unsigned long block_size)
+  : uid_(++block_sequencer_uid)
+  , block_size_(block_size > 0 ? block_size : 1)
+  , hi_(0)
+  , current_(0)
+  , floor_(0)
+  , epoch_(0)
+{}
+
+block_sequencer::~block_sequencer()
+{}
+
+unsigned long block_sequencer::init()
+{
+  return current_.load();
+}
+
+unsigned long block_sequencer::reset(unsigned long id)
+{
+  hi_.store(id);
+  floor_.store(id);
+  current_.store(id);
+  // the thread blocks don't fit the new range
+  ++epoch_;
+  return id;
+}
+
+unsigned long block_sequencer::next()
+{
+  thread_block &block = acquire_thread_block(uid_);
+  unsigned long epoch = epoch_.load(std::memory_order_acquire);
+  if (block.next > block.last || block.epoch != epoch) {
+    // fetch again if the blocks were skipped meanwhile
+    do {
+      block.epoch = epoch;
+      block.next = hi_.fetch_add(block_size_) + 1;
+      epoch = epoch_.load(std::memory_order_acquire);
+    } while (block.epoch != epoch);
+    block.last = block.next + block_size_ - 1;
+  }
+  unsigned long id = block.next++;
+  raise_to(current_, id);
+  return id;
+}
+
+unsigned long block_sequencer::current() const
+{
+  return current_.load();
+}
+
+unsigned long block_sequencer::update(unsigned long id)
+{
+  unsigned long hi = hi_.load();
+  while (id > hi) {
+    if (hi_.compare_exchange_weak(hi, id)) {
+      // ids below the given one may be taken
+      // outside of the sequencer, skip the blocks
+      floor_.store(id);
+      ++epoch_;
+      raise_to(current_, id);
+      return current_.load();
+    }
+  }
+  if (id > floor_.load()) {
+    // the id may lie in a block which isn't
+    // handed out completely, skip the blocks
+    floor_.store(hi);
+    ++epoch_;
+  }
+  raise_to(current_, id);
+  return current_.load();
+}
+
+unsigned long block_sequencer::reserve(unsigned long n)
+{
+  unsigned long first = hi_.fetch_add(n) + 1;
+  raise_to(current_, first + n - 1);
+  return first;
+}
+
+unsigned long block_sequencer::block_size() const
+{
+  return block_size_;
+}
+
 sequencer::sequencer(const sequencer_impl_ptr &impl)
   : impl_(impl)
 {
@@ -95,4 +228,9 @@ unsigned long sequencer::update(unsigned long id)
   return impl_->update(id);
 }
 
+unsigned long sequencer::reserve(unsigned long n)
+{
+  return impl_->reserve(n);
+}
+
 }
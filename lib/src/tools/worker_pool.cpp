@@ -0,0 +1,131 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tools/worker_pool.hpp"
+
+#include <algorithm>
+
+namespace oos {
+
+worker_pool::worker_pool(std::size_t workers)
+{
+  workers_.reserve(workers);
+  for (std::size_t i = 0; i < workers; ++i) {
+    workers_.push_back(std::thread(&worker_pool::work, this));
+  }
+}
+
+worker_pool::~worker_pool()
+{
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  work_cond_.notify_all();
+  for (std::thread &worker : workers_) {
+    worker.join();
+  }
+}
+
+worker_pool &worker_pool::instance()
+{
+  static worker_pool pool(std::max(std::thread::hardware_concurrency(), 2U) - 1);
+  return pool;
+}
+
+std::size_t worker_pool::size() const
+{
+  return workers_.size();
+}
+
+void worker_pool::run(std::size_t tasks, const t_task &task)
+{
+  if (tasks == 0) {
+    return;
+  }
+  batch b;
+  b.task = &task;
+  b.tasks = tasks;
+  if (tasks > 1 && !workers_.empty()) {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      batches_.push_back(&b);
+    }
+    work_cond_.notify_all();
+  }
+  execute(b);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  // the batch lives on this stack, wait for all workers using it
+  done_cond_.wait(lock, [&b]() { return b.done == b.tasks && b.users == 0; });
+  std::deque<batch*>::iterator i = std::find(batches_.begin(), batches_.end(), &b);
+  if (i != batches_.end()) {
+    batches_.erase(i);
+  }
+  if (b.error) {
+    std::rethrow_exception(b.error);
+  }
+}
+
+void worker_pool::work()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    work_cond_.wait(lock, [this]() { return stop_ || !batches_.empty(); });
+    if (stop_) {
+      return;
+    }
+    batch *b = batches_.front();
+    if (b->next.load() >= b->tasks) {
+      // all tasks are taken, the caller finishes the batch
+      batches_.pop_front();
+      continue;
+    }
+    ++b->users;
+    lock.unlock();
+    execute(*b);
+    lock.lock();
+    if (--b->users == 0) {
+      done_cond_.notify_all();
+    }
+  }
+}
+
+void worker_pool::execute(batch &b)
+{
+  while (true) {
+    std::size_t i = b.next.fetch_add(1);
+    if (i >= b.tasks) {
+      return;
+    }
+    std::exception_ptr error;
+    try {
+      (*b.task)(i);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (error && !b.error) {
+      b.error = error;
+    }
+    if (++b.done == b.tasks) {
+      done_cond_.notify_all();
+    }
+  }
+}
+
+}
@@ -0,0 +1,126 @@
+#include "ExpressionBenchmarkUnit.hpp"
+
+#include "../Item.hpp"
+
+#include "object/object_expression.hpp"
+#include "object/object_store.hpp"
+#include "object/object_view.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+
+using namespace oos;
+
+ExpressionBenchmarkUnit::ExpressionBenchmarkUnit()
+  : unit_test("expression", "object expression benchmark unit")
+{
+  add_test("run", std::bind(&ExpressionBenchmarkUnit::run, this), "benchmark typed against type erased expressions");
+}
+
+namespace {
+
+const int rounds = 20;
+
+/*
+ * Runs scan rounds times, prints the throughput and
+ * the speedup against the given baseline and returns
+ * the number of matches of one round.
+ */
+template < class F >
+std::size_t run_benchmark(const char *name, std::size_t objects, double &baseline, F scan)
+{
+  typedef std::chrono::high_resolution_clock clock;
+
+  std::size_t count = 0;
+  auto start = clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    count += scan();
+  }
+  auto stop = clock::now();
+
+  double sec = std::chrono::duration<double>(stop - start).count();
+  double mops = sec > 0 ? objects * rounds / sec / 1000000.0 : 0.0;
+  if (baseline == 0.0) {
+    baseline = mops;
+  }
+  std::cout << "\n  " << std::setw(20) << std::left << name << std::setw(9) << std::right << objects
+            << " objects: " << std::fixed << std::setprecision(1) << std::setw(7) << mops << " Mobjects/s ("
+            << std::setprecision(2) << (baseline > 0 ? mops / baseline : 0.0) << "x)" << std::flush;
+  return count / rounds;
+}
+
+template < class E >
+std::size_t count_ptr(const std::vector<object_ptr<Item>> &items, const E &expr)
+{
+  std::size_t count = 0;
+  for (const object_ptr<Item> &item : items) {
+    if (expr(item)) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+template < class E >
+std::size_t count_raw(const std::vector<const Item*> &items, const E &expr)
+{
+  std::size_t count = 0;
+  for (const Item *item : items) {
+    if (expr.evaluate(item)) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+}
+
+void ExpressionBenchmarkUnit::run()
+{
+  object_store store;
+  store.attach<Item>("item");
+
+  for (int i = 0; i < 100000; ++i) {
+    store.insert(new Item("item", i));
+  }
+
+  // the objects are taken from the view once to measure the expressions only
+  object_view<Item> view(store);
+  std::vector<object_ptr<Item>> items(view.begin(), view.end());
+  std::vector<const Item*> objects;
+  for (const object_ptr<Item> &item : items) {
+    objects.push_back(item.get());
+  }
+
+  auto x = make_var(&Item::get_int);
+  variable<int> v(x);
+  std::unique_ptr<expression> stored(make_expression(v >= 1000 && v < 50000 && v != 4711));
+  auto typed = x >= 1000 && x < 50000 && x != 4711;
+  auto erased = v >= 1000 && v < 50000 && v != 4711;
+
+  // object_ptr based evaluation is the baseline
+  double baseline = 0.0;
+  std::size_t n = items.size();
+  std::size_t virt = run_benchmark("stored object_ptr", n, baseline, [&]() { return count_ptr(items, *stored); });
+  std::size_t erased_ptr = run_benchmark("erased object_ptr", n, baseline, [&]() { return count_ptr(items, erased); });
+  std::size_t typed_ptr = run_benchmark("typed object_ptr", n, baseline, [&]() { return count_ptr(items, typed); });
+  // evaluated on the raw objects like the scans of object_view
+  std::size_t virt_raw = run_benchmark("stored raw", n, baseline, [&]() { return count_raw(objects, *stored); });
+  std::size_t erased_raw = run_benchmark("erased raw", n, baseline, [&]() { return count_raw(objects, erased); });
+  std::size_t typed_raw = run_benchmark("typed raw", n, baseline, [&]() { return count_raw(objects, typed); });
+  std::size_t selected = run_benchmark("typed select", n, baseline, [&]() { return view.select(typed).size(); });
+  std::size_t counted = run_benchmark("typed count_if", n, baseline, [&]() { return view.count_if(typed, 1); });
+  std::cout << "\n";
+
+  UNIT_ASSERT_EQUAL(typed_raw, 48999UL, "expected 48999 matches");
+  UNIT_ASSERT_EQUAL(virt, typed_raw, "expected same result of stored expression");
+  UNIT_ASSERT_EQUAL(erased_ptr, typed_raw, "expected same result of type erased expression");
+  UNIT_ASSERT_EQUAL(typed_ptr, typed_raw, "expected same result of typed expression");
+  UNIT_ASSERT_EQUAL(virt_raw, typed_raw, "expected same result of raw stored expression");
+  UNIT_ASSERT_EQUAL(erased_raw, typed_raw, "expected same result of raw type erased expression");
+  UNIT_ASSERT_EQUAL(selected, typed_raw, "expected same result of select");
+  UNIT_ASSERT_EQUAL(counted, typed_raw, "expected same result of count_if");
+}
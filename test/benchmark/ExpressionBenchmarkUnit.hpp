@@ -0,0 +1,14 @@
+#ifndef OOS_EXPRESSIONBENCHMARKUNIT_HPP
+#define OOS_EXPRESSIONBENCHMARKUNIT_HPP
+
+#include <unit/unit_test.hpp>
+
+class ExpressionBenchmarkUnit : public oos::unit_test
+{
+public:
+  ExpressionBenchmarkUnit();
+
+  void run();
+};
+
+#endif //OOS_EXPRESSIONBENCHMARKUNIT_HPP
@@ -0,0 +1,71 @@
+#include "FlatHashMapBenchmarkUnit.hpp"
+
+#include "tools/flat_hash_map.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace oos;
+
+FlatHashMapBenchmarkUnit::FlatHashMapBenchmarkUnit()
+  : unit_test("flat_map", "flat hash map benchmark unit")
+{
+  add_test("run", std::bind(&FlatHashMapBenchmarkUnit::run, this), "benchmark flat hash map against unordered map");
+}
+
+namespace {
+
+template < class MAP >
+void run_benchmark(const char *name, unsigned long count)
+{
+  typedef std::chrono::high_resolution_clock clock;
+
+  MAP map;
+  int dummy = 0;
+
+  auto start = clock::now();
+  for (unsigned long i = 1; i <= count; ++i) {
+    map.insert(std::make_pair(i, &dummy));
+  }
+  auto inserted = clock::now();
+  std::size_t found = 0;
+  for (unsigned long i = 1; i <= count; ++i) {
+    found += map.find(i) != map.end() ? 1 : 0;
+  }
+  auto searched = clock::now();
+  for (unsigned long i = 1; i <= count; ++i) {
+    map.erase(i);
+  }
+  auto erased = clock::now();
+
+  auto mops = [count](clock::time_point from, clock::time_point to) {
+    double sec = std::chrono::duration<double>(to - from).count();
+    return sec > 0 ? count / sec / 1000000.0 : 0.0;
+  };
+
+  std::cout << "\n  " << std::setw(14) << std::left << name << std::setw(9) << std::right << count
+            << " objects: insert " << std::fixed << std::setprecision(1) << mops(start, inserted)
+            << " Mops/s, find " << mops(inserted, searched)
+            << " Mops/s, erase " << mops(searched, erased) << " Mops/s" << std::flush;
+
+  if (found != count) {
+    throw std::logic_error("benchmark: not all keys were found");
+  }
+}
+
+}
+
+void FlatHashMapBenchmarkUnit::run()
+{
+  typedef flat_hash_map<unsigned long, int*> t_flat_map;
+  typedef std::unordered_map<unsigned long, int*> t_unordered_map;
+
+  for (unsigned long count : { 1000000UL, 10000000UL }) {
+    run_benchmark<t_flat_map>("flat_hash_map", count);
+    run_benchmark<t_unordered_map>("unordered_map", count);
+  }
+  std::cout << "\n";
+}
@@ -0,0 +1,14 @@
+#ifndef OOS_FLATHASHMAPBENCHMARKUNIT_HPP
+#define OOS_FLATHASHMAPBENCHMARKUNIT_HPP
+
+#include <unit/unit_test.hpp>
+
+class FlatHashMapBenchmarkUnit : public oos::unit_test
+{
+public:
+  FlatHashMapBenchmarkUnit();
+
+  void run();
+};
+
+#endif //OOS_FLATHASHMAPBENCHMARKUNIT_HPP
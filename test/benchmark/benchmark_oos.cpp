@@ -0,0 +1,34 @@
+/*
+ * This file is part of OpenObjectStore OOS.
+ *
+ * OpenObjectStore OOS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenObjectStore OOS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenObjectStore OOS. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ExpressionBenchmarkUnit.hpp"
+#include "FlatHashMapBenchmarkUnit.hpp"
+
+#include "unit/test_suite.hpp"
+
+int main(int argc, char *argv[])
+{
+  oos::test_suite suite;
+
+  suite.init(argc, argv);
+
+  suite.register_unit(new FlatHashMapBenchmarkUnit);
+  suite.register_unit(new ExpressionBenchmarkUnit);
+
+  bool result = suite.run();
+  return result ? 0 : 1;
+}
@@ -13,6 +13,10 @@
 #include "version.hpp"
 
 #include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <atomic>
 #include <object/basic_identifier_serializer.hpp>
 
 using namespace oos;
@@ -47,6 +51,25 @@ ObjectStoreTestUnit::ObjectStoreTestUnit()
   add_test("pk", std::bind(&ObjectStoreTestUnit::test_primary_key, this), "object proxy primary key test");
   add_test("has_many", std::bind(&ObjectStoreTestUnit::test_has_many, this), "has many test");
   add_test("on_attach", std::bind(&ObjectStoreTestUnit::test_on_attach, this), "test on attach callback");
+  add_test("proxy_pool", std::bind(&ObjectStoreTestUnit::test_proxy_pool, this), "test object proxy slab allocator");
+  add_test("emplace", std::bind(&ObjectStoreTestUnit::test_emplace, this), "test emplace objects into pooled storage");
+  add_test("holder_list", std::bind(&ObjectStoreTestUnit::test_holder_list, this), "test object holder list of object proxy");
+  add_test("view_size", std::bind(&ObjectStoreTestUnit::test_view_size, this), "test object view size with child nodes");
+  add_test("index", std::bind(&ObjectStoreTestUnit::test_index, this), "test secondary attribute indexes");
+  add_test("insert_range", std::bind(&ObjectStoreTestUnit::test_insert_range, this), "test bulk insert of objects");
+  add_test("get_by_pk", std::bind(&ObjectStoreTestUnit::test_get_by_pk, this), "test object lookup by raw primary key");
+  add_test("concurrent_reads", std::bind(&ObjectStoreTestUnit::test_concurrent_reads, this), "test concurrent readers with one writer");
+  add_test("snapshot", std::bind(&ObjectStoreTestUnit::test_snapshot, this), "test copy on write snapshots");
+  add_test("batch_observer", std::bind(&ObjectStoreTestUnit::test_batch_observer, this), "test single and batched observers");
+  add_test("remove_range", std::bind(&ObjectStoreTestUnit::test_remove_range, this), "test batch removal of objects");
+  add_test("type_slot", std::bind(&ObjectStoreTestUnit::test_type_slot, this), "test prototype lookup by type slot");
+  add_test("stats", std::bind(&ObjectStoreTestUnit::test_stats, this), "test object store statistics");
+  add_test("parallel_view", std::bind(&ObjectStoreTestUnit::test_parallel_view, this), "test parallel scans of an object view");
+  add_test("typed_expression", std::bind(&ObjectStoreTestUnit::test_typed_expression, this), "test expressions of member variables");
+  add_test("ordered_view", std::bind(&ObjectStoreTestUnit::test_ordered_view, this), "test object views in attribute order");
+  add_test("modified_fields", std::bind(&ObjectStoreTestUnit::test_modified_fields, this), "test modified fields of updated objects");
+  add_test("coalesce_actions", std::bind(&ObjectStoreTestUnit::test_coalesce_actions, this), "test net actions of a transaction");
+  add_test("savepoint", std::bind(&ObjectStoreTestUnit::test_savepoint, this), "test rollback to savepoints of a transaction");
 }
 
 void
@@ -1075,3 +1098,1226 @@ void ObjectStoreTestUnit::test_on_attach()
   UNIT_ASSERT_EQUAL("books", table_names[2], "type must be books");
 }
 
+
+void ObjectStoreTestUnit::test_proxy_pool()
+{
+  const detail::object_proxy_pool &pool = ostore_.proxy_pool();
+
+  UNIT_ASSERT_EQUAL(0UL, pool.size(), "pool must be empty");
+  UNIT_ASSERT_EQUAL(0UL, pool.slab_count(), "pool must not have a slab");
+
+  unsigned long count = pool.slab_size() + 10;
+  for (unsigned long i = 0; i < count; ++i) {
+    ostore_.insert(new Item("Item", (int)i));
+  }
+
+  UNIT_ASSERT_EQUAL(count, pool.size(), "invalid number of proxies in pool");
+  UNIT_ASSERT_EQUAL(2UL, pool.slab_count(), "pool must have two slabs");
+
+  object_view<Item> items(ostore_);
+  object_ptr<Item> item = items.front();
+  ostore_.remove(item);
+
+  UNIT_ASSERT_EQUAL(count - 1, pool.size(), "invalid number of proxies in pool");
+
+  // freed slot is recycled
+  ostore_.insert(new Item("Item", 42));
+
+  UNIT_ASSERT_EQUAL(count, pool.size(), "invalid number of proxies in pool");
+  UNIT_ASSERT_EQUAL(2UL, pool.slab_count(), "pool must have two slabs");
+
+  // heap allocated proxies can be inserted as well
+  object_ptr<Item> transient(new Item("Transient", 7));
+  ostore_.insert(transient);
+
+  UNIT_ASSERT_EQUAL(count, pool.size(), "invalid number of proxies in pool");
+
+  ostore_.clear();
+
+  UNIT_ASSERT_EQUAL(0UL, pool.size(), "pool must be empty");
+  UNIT_ASSERT_EQUAL(0UL, pool.slab_count(), "pool must not have a slab");
+  UNIT_ASSERT_TRUE(item.ptr() == nullptr, "removed object must be gone");
+  UNIT_ASSERT_TRUE(transient.ptr() == nullptr, "cleared object must be gone");
+
+  // the cleared store takes new objects
+  ostore_.insert(new Item("Item", 43));
+
+  UNIT_ASSERT_EQUAL(1UL, pool.size(), "invalid number of proxies in pool");
+  UNIT_ASSERT_EQUAL(1UL, pool.slab_count(), "pool must have one slab");
+  UNIT_ASSERT_EQUAL(1UL, object_view<Item>(ostore_).size(), "expected one item");
+}
+
+void ObjectStoreTestUnit::test_emplace()
+{
+  object_store store;
+
+  prototype_iterator node = store.attach<Item>("item", pooled_storage(4));
+
+  const detail::basic_object_arena *arena = node->arena();
+
+  UNIT_ASSERT_NOT_NULL(arena, "node must have an arena");
+  UNIT_ASSERT_EQUAL(0UL, arena->size(), "arena must be empty");
+
+  for (int i = 0; i < 6; ++i) {
+    store.emplace<Item>("Item", i);
+  }
+
+  UNIT_ASSERT_EQUAL(6UL, arena->size(), "invalid number of objects in arena");
+  UNIT_ASSERT_EQUAL(2UL, arena->chunk_count(), "arena must have two chunks");
+
+  object_view<Item> items(store);
+
+  UNIT_ASSERT_EQUAL(6UL, items.size(), "invalid view size");
+
+  std::map<int, const char*> addresses;
+  for (auto item : items) {
+    addresses.insert(std::make_pair(item->get_int(), (const char*)item.get()));
+  }
+
+  UNIT_ASSERT_EQUAL(6UL, addresses.size(), "invalid number of items");
+
+  // objects of one chunk lie side by side
+  UNIT_ASSERT_EQUAL((std::ptrdiff_t)arena->slot_size(), addresses[1] - addresses[0], "objects must be adjacent");
+  UNIT_ASSERT_EQUAL((std::ptrdiff_t)arena->slot_size(), addresses[3] - addresses[2], "objects must be adjacent");
+
+  object_ptr<Item> item = items.front();
+  store.remove(item);
+
+  UNIT_ASSERT_EQUAL(5UL, arena->size(), "invalid number of objects in arena");
+
+  // heap allocated objects may be mixed with pooled ones
+  store.insert(new Item("Heap", 42));
+
+  UNIT_ASSERT_EQUAL(5UL, arena->size(), "invalid number of objects in arena");
+  UNIT_ASSERT_EQUAL(6UL, items.size(), "invalid view size");
+
+  store.clear();
+
+  UNIT_ASSERT_EQUAL(0UL, arena->size(), "arena must be empty");
+  UNIT_ASSERT_EQUAL(0UL, arena->chunk_count(), "arena must not have a chunk");
+
+  // types without pooled storage are created on the heap
+  store.attach<ItemA>("item_a");
+  object_ptr<ItemA> a = store.emplace<ItemA>();
+
+  UNIT_ASSERT_NOT_NULL(a.get(), "object must be created");
+  UNIT_ASSERT_EXCEPTION(store.emplace<ItemB>(), object_exception, "unknown object type", "type must be attached");
+}
+
+void ObjectStoreTestUnit::test_holder_list()
+{
+  object_ptr<Item> item = ostore_.insert(new Item("Item", 1));
+
+  std::vector<object_ptr<Item>> copies(10, item);
+
+  // remove holders from the head, the middle and the tail
+  copies.erase(copies.begin());
+  copies.erase(copies.begin() + 4);
+  copies.pop_back();
+
+  object_ptr<Item> other = ostore_.insert(new Item("Other", 2));
+  copies[2] = other;
+  copies[2] = item;
+
+  for (auto &copy : copies) {
+    UNIT_ASSERT_TRUE(copy.get() == item.get(), "copy must point to item");
+  }
+
+  ostore_.remove(item);
+
+  UNIT_ASSERT_NULL(item.get(), "item must be gone");
+  for (auto &copy : copies) {
+    UNIT_ASSERT_NULL(copy.get(), "copy must be gone");
+  }
+  UNIT_ASSERT_EQUAL(2, other->get_int(), "other item must be left untouched");
+}
+
+void ObjectStoreTestUnit::test_view_size()
+{
+  object_store store;
+  store.attach<Item>("item");
+  store.attach<ItemA, Item>("item_a");
+  store.attach<ItemB, Item>("item_b");
+  store.attach<ItemC, ItemA>("item_c");
+
+  for (int i = 0; i < 3; ++i) {
+    store.insert(new Item);
+    store.insert(new ItemA);
+    store.insert(new ItemB);
+    store.insert(new ItemC);
+  }
+
+  object_view<Item> items(store);
+  object_view<ItemA> items_a(store);
+  object_view<ItemB> items_b(store);
+
+  UNIT_ASSERT_EQUAL(12UL, items.size(), "invalid view size");
+  UNIT_ASSERT_EQUAL(6UL, items_a.size(), "invalid view size");
+  UNIT_ASSERT_EQUAL(3UL, items_b.size(), "invalid view size");
+  UNIT_ASSERT_EQUAL((std::size_t)std::distance(items.begin(), items.end()), items.size(), "size must match iterated size");
+
+  items.skip_siblings(true);
+  items_a.skip_siblings(true);
+
+  UNIT_ASSERT_EQUAL(3UL, items.size(), "invalid view size");
+  UNIT_ASSERT_EQUAL(3UL, items_a.size(), "invalid view size");
+
+  items.skip_siblings(false);
+  items_a.skip_siblings(false);
+
+  object_view<ItemC> items_c(store);
+  object_ptr<ItemC> c = items_c.front();
+  store.remove(c);
+
+  UNIT_ASSERT_EQUAL(11UL, items.size(), "invalid view size");
+  UNIT_ASSERT_EQUAL(5UL, items_a.size(), "invalid view size");
+  UNIT_ASSERT_EQUAL(2UL, items_c.size(), "invalid view size");
+
+  store.clear();
+
+  UNIT_ASSERT_EQUAL(0UL, items.size(), "view must be empty");
+  UNIT_ASSERT_TRUE(items.empty(), "view must be empty");
+}
+
+void ObjectStoreTestUnit::test_index()
+{
+  object_store store;
+  store.attach<Item>("item");
+  store.attach<ItemA, Item>("item_a");
+
+  for (int i = 0; i < 10; ++i) {
+    std::stringstream name;
+    name << "item " << i;
+    store.insert(new Item(name.str(), i));
+  }
+  ItemA *a = new ItemA;
+  a->set_int(5);
+  store.insert(a);
+
+  store.create_index<Item>("val_int", index_type::ORDERED);
+  store.create_index<Item>("val_string");
+
+  UNIT_ASSERT_EXCEPTION(store.create_index<Item>("val_int"), object_exception, "index already exists", "index must not be created twice");
+  UNIT_ASSERT_EXCEPTION(store.create_index<Item>("unknown"), object_exception, "unknown attribute for index", "attribute must exist");
+  UNIT_ASSERT_EXCEPTION(store.create_index<Item>("id"), object_exception, "attribute type can't be indexed", "identifier can't be indexed");
+
+  variable<int> x(make_var<int, Item>("val_int"));
+  variable<std::string> y(make_var<std::string, Item>("val_string"));
+
+  object_view<Item> items(store);
+  object_view<Item> only_items(store, true);
+
+  UNIT_ASSERT_EQUAL(items.select(x == 5).size(), 2UL, "expected two items");
+  UNIT_ASSERT_EQUAL(only_items.select(x == 5).size(), 1UL, "expected one item");
+  UNIT_ASSERT_EQUAL(items.select(x >= 3 && x < 6).size(), 4UL, "expected four items");
+  UNIT_ASSERT_EQUAL(items.select(7 < x).size(), 2UL, "expected two items");
+  UNIT_ASSERT_EQUAL(items.select(y == std::string("item 3")).size(), 1UL, "expected one item");
+  // not indexable expression is answered by a scan
+  UNIT_ASSERT_EQUAL(items.select(x != 5).size(), 9UL, "expected nine items");
+
+  // results of an ordered index are sorted
+  std::vector<object_ptr<Item>> sorted = only_items.select(x > 1);
+  UNIT_ASSERT_EQUAL(sorted.size(), 8UL, "expected eight items");
+  UNIT_ASSERT_EQUAL(sorted.front()->get_int(), 2, "expected value 2");
+  UNIT_ASSERT_EQUAL(sorted.back()->get_int(), 9, "expected value 9");
+
+  // update
+  object_ptr<Item> item = items.select(y == std::string("item 3")).front();
+  item->set_int(42);
+  // changes outside a transaction must be marked
+  UNIT_ASSERT_EQUAL(items.select(x == 42).size(), 0UL, "expected no item");
+  store.mark_modified(item);
+  UNIT_ASSERT_EQUAL(items.select(x == 3).size(), 0UL, "expected no item");
+  UNIT_ASSERT_EQUAL(items.select(x == 42).size(), 1UL, "expected one item");
+
+  // rollback of an update
+  transaction tr(store);
+  tr.begin();
+  item->set_int(43);
+  UNIT_ASSERT_EQUAL(items.select(x == 43).size(), 1UL, "expected one item");
+  tr.rollback();
+  UNIT_ASSERT_EQUAL(items.select(x == 43).size(), 0UL, "expected no item");
+  UNIT_ASSERT_EQUAL(items.select(x == 42).size(), 1UL, "expected one item");
+
+  // changes after a lookup within a transaction
+  // are reindexed on commit
+  Item *raw = item.get();
+  transaction tr1(store);
+  tr1.begin();
+  item->set_int(44);
+  UNIT_ASSERT_EQUAL(items.select(x == 44).size(), 1UL, "expected one item");
+  raw->set_int(45);
+  tr1.commit();
+  UNIT_ASSERT_EQUAL(items.select(x == 44).size(), 0UL, "expected no item");
+  UNIT_ASSERT_EQUAL(items.select(x == 45).size(), 1UL, "expected one item");
+  item->set_int(42);
+  store.mark_modified(item);
+
+  // delete
+  store.remove(item);
+  UNIT_ASSERT_EQUAL(items.select(x == 42).size(), 0UL, "expected no item");
+
+  // rollback of a delete
+  object_ptr<Item> seven = items.select(x == 7).front();
+  transaction tr2(store);
+  tr2.begin();
+  store.remove(seven);
+  UNIT_ASSERT_EQUAL(items.select(x == 7).size(), 0UL, "expected no item");
+  tr2.rollback();
+  UNIT_ASSERT_EQUAL(items.select(x == 7).size(), 1UL, "expected one item");
+
+  UNIT_ASSERT_TRUE(store.drop_index<Item>("val_int"), "index must be dropped");
+  UNIT_ASSERT_FALSE(store.drop_index<Item>("val_int"), "index is already dropped");
+  UNIT_ASSERT_EQUAL(items.select(x == 5).size(), 2UL, "expected two items");
+}
+
+void ObjectStoreTestUnit::test_insert_range()
+{
+  object_store store;
+  store.attach<Item>("item");
+  store.attach<ItemA, Item>("item_a");
+  store.attach<ItemB, Item>("item_b");
+
+  store.insert(new Item("item", 100));
+  store.insert(new ItemB);
+
+  std::vector<ItemA*> items;
+  for (int i = 0; i < 10; ++i) {
+    items.push_back(new ItemA);
+    items.back()->set_int(i);
+  }
+
+  UNIT_ASSERT_EQUAL(store.insert_range<ItemA>(items.begin(), items.end()), 10UL, "expected ten inserted objects");
+
+  object_view<Item> all(store);
+  object_view<ItemA> items_a(store);
+  object_view<ItemB> items_b(store);
+
+  UNIT_ASSERT_EQUAL(all.size(), 12UL, "expected twelve objects");
+  UNIT_ASSERT_EQUAL(items_a.size(), 10UL, "expected ten objects");
+  UNIT_ASSERT_EQUAL(items_b.size(), 1UL, "expected one object");
+
+  unsigned long count = 0;
+  std::map<int, unsigned long> ids;
+  for (object_view<ItemA>::iterator i = items_a.begin(); i != items_a.end(); ++i) {
+    ++count;
+    ids.insert(std::make_pair(i.optr()->get_int(), i.optr().id()));
+  }
+  UNIT_ASSERT_EQUAL(count, 10UL, "expected ten iterated objects");
+  UNIT_ASSERT_EQUAL(ids.size(), 10UL, "expected ten distinct values");
+  // ids are reserved in one block
+  UNIT_ASSERT_EQUAL(ids.rbegin()->second - ids.begin()->second, 9UL, "expected consecutive ids");
+
+  count = 0;
+  for (object_view<Item>::iterator i = all.begin(); i != all.end(); ++i) {
+    ++count;
+  }
+  UNIT_ASSERT_EQUAL(count, 12UL, "expected twelve iterated objects");
+
+  // a single insert after the range gets the next id
+  object_ptr<ItemA> single = store.insert(new ItemA);
+  UNIT_ASSERT_EQUAL(single.id(), ids.rbegin()->second + 1, "expected next id");
+
+  // inserts in a transaction are rolled back at once
+  std::vector<ItemB*> items_b_vec;
+  for (int i = 0; i < 5; ++i) {
+    items_b_vec.push_back(new ItemB);
+  }
+  transaction tr(store);
+  tr.begin();
+  store.insert_range<ItemB>(items_b_vec.begin(), items_b_vec.end());
+  UNIT_ASSERT_EQUAL(items_b.size(), 6UL, "expected six objects");
+  tr.rollback();
+  UNIT_ASSERT_EQUAL(items_b.size(), 1UL, "expected one object");
+  UNIT_ASSERT_EQUAL(all.size(), 13UL, "expected thirteen objects");
+
+  std::vector<Item*> invalid = { new Item, nullptr };
+  UNIT_ASSERT_EXCEPTION(store.insert_range<Item>(invalid.begin(), invalid.end()), object_exception, "object is null", "null object must not be inserted");
+  delete invalid.front();
+  UNIT_ASSERT_EQUAL(all.size(), 13UL, "expected thirteen objects");
+}
+
+namespace {
+
+struct keyed_item
+{
+  keyed_item() {}
+  keyed_item(const std::string &k, int v) : key(k), value(v) {}
+
+  oos::identifier<std::string> key;
+  int value = 0;
+
+  template < class S >
+  void serialize(S &s)
+  {
+    s.serialize("key", key);
+    s.serialize("value", value);
+  }
+};
+
+}
+
+void ObjectStoreTestUnit::test_get_by_pk()
+{
+  object_store store;
+  store.attach<Item>("item");
+  store.attach<keyed_item>("keyed_item");
+
+  std::vector<object_ptr<Item>> items;
+  for (int i = 0; i < 100; ++i) {
+    items.push_back(store.insert(new Item));
+  }
+
+  object_ptr<Item> item = store.get<Item>(items[42]->id());
+  UNIT_ASSERT_TRUE(item == items[42], "expected item 42");
+  // the value is converted into the type of the primary key
+  item = store.get<Item>(static_cast<int>(items[7]->id()));
+  UNIT_ASSERT_TRUE(item == items[7], "expected item 7");
+  item = store.get<Item>(4711L);
+  UNIT_ASSERT_NULL(item.ptr(), "expected no item");
+
+  prototype_iterator node = store.find<Item>();
+  UNIT_ASSERT_EQUAL(node->find_proxy(items[3]->id())->id(), items[3].id(), "expected proxy of item 3");
+  UNIT_ASSERT_EQUAL(node->find_proxy(items[3].primary_key())->id(), items[3].id(), "expected proxy of item 3");
+
+  unsigned long id = items[42]->id();
+  store.remove(items[42]);
+  item = store.get<Item>(id);
+  UNIT_ASSERT_NULL(item.ptr(), "expected no item");
+
+  store.insert(new keyed_item("alpha", 1));
+  store.insert(new keyed_item("beta", 2));
+
+  object_ptr<keyed_item> keyed = store.get<keyed_item>(std::string("beta"));
+  UNIT_ASSERT_NOT_NULL(keyed.ptr(), "expected keyed item");
+  UNIT_ASSERT_EQUAL(keyed->value, 2, "expected value 2");
+  keyed = store.get<keyed_item>(std::string("gamma"));
+  UNIT_ASSERT_NULL(keyed.ptr(), "expected no keyed item");
+  // an integral value never matches a string primary key
+  keyed = store.get<keyed_item>(1L);
+  UNIT_ASSERT_NULL(keyed.ptr(), "expected no keyed item");
+}
+
+void ObjectStoreTestUnit::test_concurrent_reads()
+{
+  object_store store;
+  store.attach<Item>("item");
+
+  std::vector<object_ptr<Item>> items;
+  for (int i = 0; i < 100; ++i) {
+    Item *item = new Item;
+    item->set_int(10);
+    items.push_back(store.insert(item));
+  }
+
+  store.concurrent_reads(true);
+  UNIT_ASSERT_TRUE(store.concurrent_reads(), "expected concurrent reads");
+
+  // the writer moves values between items, so every
+  // committed state sums up to the same total
+  std::atomic<bool> done(false);
+  std::thread writer([&]() {
+    for (int i = 0; i < 500; ++i) {
+      transaction tr(store);
+      tr.begin();
+      items[i % 100]->set_int(items[i % 100]->get_int() + 1);
+      items[(i + 1) % 100]->set_int(items[(i + 1) % 100]->get_int() - 1);
+      if (i % 10 == 0) {
+        tr.rollback();
+      } else {
+        tr.commit();
+      }
+    }
+    done = true;
+  });
+
+  std::atomic<int> mismatches(0);
+  std::atomic<int> reads(0);
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 4; ++r) {
+    readers.push_back(std::thread([&]() {
+      while (!done || reads < 4) {
+        shared_guard<rw_lock> guard(store.lock());
+        snapshot committed = store.committed();
+        int sum = 0;
+        committed.for_each<Item>([&sum](const Item &item) {
+          sum += item.get_int();
+        });
+        if (sum != 1000) {
+          ++mismatches;
+        }
+        ++reads;
+      }
+    }));
+  }
+
+  writer.join();
+  for (std::thread &reader : readers) {
+    reader.join();
+  }
+
+  UNIT_ASSERT_EQUAL(mismatches.load(), 0, "readers must only see committed states");
+
+  int sum = 0;
+  for (const object_ptr<Item> &item : items) {
+    sum += item->get_int();
+  }
+  UNIT_ASSERT_EQUAL(sum, 1000, "expected unchanged total");
+
+  transaction tr(store);
+  tr.begin();
+  UNIT_ASSERT_EXCEPTION(store.concurrent_reads(false), object_exception, "can't change concurrent reads within a transaction", "expected exception");
+  tr.rollback();
+  store.concurrent_reads(false);
+}
+
+namespace {
+
+struct tagged_item : public Item
+{
+  tagged_item() {}
+  explicit tagged_item(const std::string &t) : tag(t) {}
+
+  std::string tag;
+
+  template < class S >
+  void serialize(S &s)
+  {
+    s.serialize(*oos::base_class<Item>(this));
+    s.serialize("tag", tag);
+  }
+};
+
+}
+
+void ObjectStoreTestUnit::test_snapshot()
+{
+  object_store store;
+  store.attach<Item>("item");
+
+  std::vector<object_ptr<Item>> items;
+  for (int i = 0; i < 10; ++i) {
+    Item *item = new Item;
+    item->set_int(i);
+    items.push_back(store.insert(item));
+  }
+
+  snapshot snap = store.snapshot();
+  UNIT_ASSERT_TRUE(snap.valid(), "expected valid snapshot");
+  UNIT_ASSERT_EQUAL(snap.copied_objects(), 0UL, "expected no copies");
+
+  // unmodified objects are shared with the store
+  const Item *shared = snap.get<Item>(items[5].id());
+  UNIT_ASSERT_TRUE(shared == items[5].get(), "expected shared object");
+
+  unsigned long removed_id = items[1].id();
+  transaction tr(store);
+  tr.begin();
+  items[0]->set_int(100);
+  items[0]->set_int(200);
+  store.remove(items[1]);
+  object_ptr<Item> inserted = store.insert(new Item);
+  tr.commit();
+
+  UNIT_ASSERT_EQUAL(snap.copied_objects(), 2UL, "expected two copies");
+  UNIT_ASSERT_EQUAL(items[0]->get_int(), 200, "expected modified value");
+  UNIT_ASSERT_EQUAL(snap.get<Item>(items[0].id())->get_int(), 0, "expected value at snapshot time");
+  UNIT_ASSERT_NOT_NULL(snap.get<Item>(removed_id), "expected removed object");
+  UNIT_ASSERT_EQUAL(snap.get<Item>(removed_id)->get_int(), 1, "expected value at snapshot time");
+  UNIT_ASSERT_NULL(snap.get<Item>(inserted.id()), "inserted object must not be visible");
+
+  int count = 0, sum = 0;
+  snap.for_each<Item>([&](const Item &item) {
+    ++count;
+    sum += item.get_int();
+  });
+  UNIT_ASSERT_EQUAL(count, 10, "expected ten objects");
+  UNIT_ASSERT_EQUAL(sum, 45, "expected sum at snapshot time");
+
+  // rolled back changes leave the copy untouched
+  snapshot second = store.snapshot();
+  tr.begin();
+  items[2]->set_int(42);
+  tr.rollback();
+  UNIT_ASSERT_EQUAL(second.get<Item>(items[2].id())->get_int(), 2, "expected value at snapshot time");
+  UNIT_ASSERT_EQUAL(snap.get<Item>(items[2].id())->get_int(), 2, "expected value at snapshot time");
+
+  tr.begin();
+  UNIT_ASSERT_EXCEPTION(store.snapshot(), object_exception, "can't take snapshot within a transaction", "expected exception");
+  tr.rollback();
+
+  store.clear();
+  UNIT_ASSERT_FALSE(snap.valid(), "expected invalid snapshot");
+  UNIT_ASSERT_NULL(second.get<Item>(items[2].id()), "expected no object");
+
+  // derived objects are copied as their concrete type
+  object_store derived_store;
+  derived_store.attach<Item>("item");
+  derived_store.attach<tagged_item, Item>("tagged_item");
+  tagged_item *first_tagged = new tagged_item("first");
+  first_tagged->set_int(3);
+  object_ptr<tagged_item> tagged = derived_store.insert(first_tagged);
+  object_ptr<Item> base = object_view<Item>(derived_store).front();
+
+  snapshot third = derived_store.snapshot();
+  transaction tr3(derived_store);
+  tr3.begin();
+  base->set_int(7);
+  tagged->tag = "second";
+  tr3.commit();
+
+  UNIT_ASSERT_EQUAL(third.copied_objects(), 1UL, "expected one copy");
+  UNIT_ASSERT_EQUAL(third.get<tagged_item>(tagged.id())->tag, "first", "expected tag at snapshot time");
+  UNIT_ASSERT_EQUAL(third.get<tagged_item>(tagged.id())->get_int(), 3, "expected value at snapshot time");
+
+  // ids of a block sequencer don't follow the insert order
+  object_store block_store;
+  block_store.attach<Item>("item");
+  std::shared_ptr<block_sequencer> seq = std::make_shared<block_sequencer>(8);
+  block_store.exchange_sequencer(seq);
+  object_ptr<Item> early = block_store.insert(new Item);
+  std::thread other([&seq]() { seq->next(); });
+  other.join();
+
+  snapshot fourth = block_store.snapshot();
+  object_ptr<Item> late = block_store.insert(new Item);
+  UNIT_ASSERT_TRUE(late.id() < seq->current(), "expected id below the highest id");
+  UNIT_ASSERT_NOT_NULL(fourth.get<Item>(early.id()), "expected object of snapshot");
+  UNIT_ASSERT_NULL(fourth.get<Item>(late.id()), "inserted object must not be visible");
+  int visible = 0;
+  fourth.for_each<Item>([&](const Item &) { ++visible; });
+  UNIT_ASSERT_EQUAL(visible, 1, "expected one object");
+}
+
+namespace {
+
+struct counting_observer : public object_observer
+{
+  virtual void on_insert(object_proxy *) { ++inserted; }
+  virtual void on_update(object_proxy *) { ++updated; }
+  virtual void on_delete(object_proxy *) { ++deleted; }
+
+  int inserted = 0;
+  int updated = 0;
+  int deleted = 0;
+};
+
+struct recording_observer : public object_batch_observer
+{
+  virtual void on_insert(object_proxy *const *, std::size_t count) { inserted.push_back(count); }
+  virtual void on_update(object_proxy *const *, std::size_t count) { updated.push_back(count); }
+  virtual void on_delete(object_proxy *const *proxies, std::size_t count)
+  {
+    deleted.push_back(count);
+    // deleted proxies are still alive
+    for (std::size_t i = 0; i < count; ++i) {
+      deleted_ids.push_back(proxies[i]->id());
+    }
+  }
+
+  std::vector<std::size_t> inserted;
+  std::vector<std::size_t> updated;
+  std::vector<std::size_t> deleted;
+  std::vector<unsigned long> deleted_ids;
+};
+
+}
+
+void ObjectStoreTestUnit::test_batch_observer()
+{
+  object_store store;
+  store.attach<Item>("item");
+
+  counting_observer single;
+  recording_observer batch;
+  store.register_observer(&single);
+  store.register_observer(&batch);
+
+  object_ptr<Item> item = store.insert(new Item);
+  UNIT_ASSERT_EQUAL(single.inserted, 1, "expected one insert");
+  UNIT_ASSERT_EQUAL(batch.inserted.size(), 1UL, "expected one batch");
+  UNIT_ASSERT_EQUAL(batch.inserted.back(), 1UL, "expected batch of one");
+
+  std::vector<Item*> items;
+  for (int i = 0; i < 10; ++i) {
+    items.push_back(new Item);
+  }
+  store.insert_range<Item>(items.begin(), items.end());
+  UNIT_ASSERT_EQUAL(single.inserted, 11, "expected eleven inserts");
+  UNIT_ASSERT_EQUAL(batch.inserted.size(), 2UL, "expected two batches");
+  UNIT_ASSERT_EQUAL(batch.inserted.back(), 10UL, "expected batch of ten");
+
+  // changes of a transaction are reported at commit
+  object_view<Item> view(store);
+  std::vector<object_ptr<Item>> ptrs;
+  for (object_view<Item>::const_iterator it = view.begin(); it != view.end(); ++it) {
+    ptrs.push_back(it.optr());
+  }
+  transaction tr(store);
+  tr.begin();
+  store.insert(new Item);
+  store.insert(new Item);
+  ptrs[1]->set_int(1);
+  ptrs[2]->set_int(2);
+  ptrs[3]->set_int(3);
+  unsigned long removed_id = ptrs[4].id();
+  store.remove(ptrs[4]);
+  UNIT_ASSERT_EQUAL(single.inserted, 11, "expected no notification before commit");
+  tr.commit();
+
+  UNIT_ASSERT_EQUAL(single.inserted, 13, "expected thirteen inserts");
+  UNIT_ASSERT_EQUAL(single.updated, 3, "expected three updates");
+  UNIT_ASSERT_EQUAL(single.deleted, 1, "expected one delete");
+  UNIT_ASSERT_EQUAL(batch.inserted.back(), 2UL, "expected batch of two");
+  UNIT_ASSERT_EQUAL(batch.updated.size(), 1UL, "expected one update batch");
+  UNIT_ASSERT_EQUAL(batch.updated.back(), 3UL, "expected batch of three");
+  UNIT_ASSERT_EQUAL(batch.deleted.size(), 1UL, "expected one delete batch");
+  UNIT_ASSERT_EQUAL(batch.deleted_ids.back(), removed_id, "expected id of removed object");
+
+  // only the net effect of a transaction is reported
+  tr.begin();
+  ptrs[1]->set_int(5);
+  ptrs[1]->set_int(6);
+  object_ptr<Item> temporary = store.insert(new Item);
+  store.remove(temporary);
+  tr.commit();
+  UNIT_ASSERT_EQUAL(single.updated, 4, "expected one update for two changes");
+  UNIT_ASSERT_EQUAL(single.inserted, 13, "expected no insert of a removed object");
+  UNIT_ASSERT_EQUAL(single.deleted, 1, "expected no delete of an inserted object");
+  UNIT_ASSERT_EQUAL(batch.inserted.size(), 3UL, "expected no insert batch");
+
+  // rolled back changes aren't reported
+  tr.begin();
+  store.insert(new Item);
+  ptrs[1]->set_int(4);
+  tr.rollback();
+  UNIT_ASSERT_EQUAL(single.inserted, 13, "expected thirteen inserts");
+  UNIT_ASSERT_EQUAL(batch.inserted.size(), 3UL, "expected three batches");
+
+  store.unregister_observer(&single);
+  store.unregister_observer(&batch);
+  store.remove(item);
+  UNIT_ASSERT_EQUAL(single.deleted, 1, "expected one delete");
+  UNIT_ASSERT_EQUAL(batch.deleted.size(), 1UL, "expected one delete batch");
+}
+
+void ObjectStoreTestUnit::test_remove_range()
+{
+  typedef ObjectItem<Item> TestItem;
+
+  object_store store;
+  store.attach<Item>("item");
+  store.attach<TestItem>("object_item");
+
+  std::vector<object_ptr<Item>> items;
+  std::vector<object_ptr<TestItem>> test_items;
+  for (int i = 0; i < 5; ++i) {
+    items.push_back(store.insert(new Item("item", i)));
+    TestItem *ti = new TestItem("test item", i);
+    ti->ref(items.back());
+    ti->ptr(object_ptr<Item>(new Item("cascaded", 100 + i)));
+    test_items.push_back(store.insert(ti));
+  }
+
+  object_view<Item> item_view(store);
+  UNIT_ASSERT_EQUAL(item_view.size(), 10UL, "expected ten items");
+
+  // the items are still referenced by the test items
+  UNIT_ASSERT_EXCEPTION(store.remove_range<Item>(items.begin(), items.end()), object_exception, "object is not removable", "items must not be removable");
+  UNIT_ASSERT_EQUAL(item_view.size(), 10UL, "expected ten items");
+
+  // removed together the references vanish
+  std::vector<object_ptr<TestItem>> range(test_items.begin(), test_items.begin() + 2);
+  std::size_t removed = store.remove_range<TestItem>(range.begin(), range.end());
+  UNIT_ASSERT_EQUAL(removed, 4UL, "expected two test items and two cascaded items");
+  UNIT_ASSERT_EQUAL(item_view.size(), 8UL, "expected eight items");
+
+  // objects referenced from the batch are removable within the same batch
+  std::vector<object_ptr<Item>> referenced(items.begin(), items.begin() + 2);
+  removed = store.remove_range<Item>(referenced.begin(), referenced.end());
+  UNIT_ASSERT_EQUAL(removed, 2UL, "expected two items");
+
+  variable<int> y(make_var(&TestItem::get_int));
+  removed = store.remove_if<TestItem>(y >= 3);
+  UNIT_ASSERT_EQUAL(removed, 4UL, "expected two test items and two cascaded items");
+  UNIT_ASSERT_EQUAL(item_view.size(), 4UL, "expected four items");
+
+  variable<int> x(make_var(&Item::get_int));
+  UNIT_ASSERT_EXCEPTION(store.remove_if<Item>(x > 2), object_exception, "object is not removable", "cascaded item is still referenced");
+  removed = store.remove_if<Item>(x > 2 && x < 100);
+  UNIT_ASSERT_EQUAL(removed, 2UL, "expected two items");
+  UNIT_ASSERT_EQUAL(item_view.size(), 2UL, "expected two items");
+}
+
+void ObjectStoreTestUnit::test_type_slot()
+{
+  UNIT_ASSERT_EQUAL(detail::type_slot<Item>::index(), detail::type_slot<Item>::index(), "expected same slot");
+  UNIT_ASSERT_NOT_EQUAL(detail::type_slot<Item>::index(), detail::type_slot<ItemA>::index(), "expected different slots");
+
+  object_store store;
+  UNIT_ASSERT_TRUE(store.find<Item>() == store.end(), "expected no node");
+
+  store.attach<Item>("item");
+  store.attach<ItemA, Item>("item_a");
+
+  UNIT_ASSERT_TRUE(store.find<Item>() == store.find("item"), "expected node of item");
+  UNIT_ASSERT_TRUE(store.find<ItemA>() == store.find("item_a"), "expected node of item_a");
+
+  object_ptr<ItemA> a = store.insert(new ItemA);
+  UNIT_ASSERT_EQUAL(a->id(), 1UL, "expected id one");
+  object_view<Item> view(store);
+  UNIT_ASSERT_EQUAL(view.size(), 1UL, "expected one object");
+
+  // the same type attached twice isn't unique anymore
+  store.attach<ItemB>("item_b");
+  store.attach<ItemB>("other_item_b");
+  UNIT_ASSERT_EXCEPTION(store.find<ItemB>(), object_exception, "type id not unique", "expected exception");
+
+  store.detach("other_item_b");
+  UNIT_ASSERT_TRUE(store.find<ItemB>() == store.find("item_b"), "expected node of item_b");
+
+  store.detach("item_a");
+  UNIT_ASSERT_TRUE(store.find<ItemA>() == store.end(), "expected no node");
+}
+
+void ObjectStoreTestUnit::test_stats()
+{
+  object_store store;
+  store.attach<Item>("item");
+  store.attach<ItemA, Item>("item_a");
+
+  store_stats stats = store.stats();
+  UNIT_ASSERT_EQUAL(stats.nodes.size(), 2UL, "expected two nodes");
+  UNIT_ASSERT_EQUAL(stats.object_map_size, 0UL, "expected no proxies");
+
+  std::vector<object_ptr<Item>> items;
+  for (int i = 0; i < 10; ++i) {
+    items.push_back(store.insert(new Item("item", i)));
+  }
+  store.insert(new ItemA);
+  store.remove(items.back());
+
+  object_ptr<Item> item = store.get<Item>(items.front()->id());
+  UNIT_ASSERT_TRUE(item.get() == items.front().get(), "expected first item");
+
+  stats = store.stats();
+  UNIT_ASSERT_EQUAL(stats.object_map_size, 10UL, "expected ten proxies");
+  UNIT_ASSERT_TRUE(stats.object_map_capacity >= stats.object_map_size, "expected enough slots");
+  UNIT_ASSERT_TRUE(stats.proxy_pool_capacity >= stats.proxy_pool_size, "expected enough proxy slots");
+
+  const node_stats &item_stats = stats.nodes.front();
+  UNIT_ASSERT_EQUAL(item_stats.type, "item", "expected item node first");
+  UNIT_ASSERT_EQUAL(item_stats.proxy_count, 9UL, "expected nine proxies");
+  UNIT_ASSERT_EQUAL(item_stats.object_count, 9UL, "expected nine objects");
+  UNIT_ASSERT_EQUAL(item_stats.object_bytes, 9 * sizeof(Item), "expected size of nine items");
+  UNIT_ASSERT_EQUAL(item_stats.proxy_bytes, 9 * sizeof(object_proxy), "expected size of nine proxies");
+  UNIT_ASSERT_EQUAL(item_stats.id_map_size, 9UL, "expected nine primary keys");
+  UNIT_ASSERT_TRUE(item_stats.id_map_buckets >= 9UL, "expected enough buckets");
+  UNIT_ASSERT_EQUAL(item_stats.inserts, 10UL, "expected ten inserts");
+  UNIT_ASSERT_EQUAL(item_stats.removes, 1UL, "expected one remove");
+  UNIT_ASSERT_TRUE(item_stats.lookups >= 1UL, "expected at least one lookup");
+
+  const node_stats &item_a_stats = stats.nodes.back();
+  UNIT_ASSERT_EQUAL(item_a_stats.type, "item_a", "expected item_a node last");
+  UNIT_ASSERT_EQUAL(item_a_stats.proxy_count, 1UL, "expected one proxy");
+  UNIT_ASSERT_EQUAL(item_a_stats.object_bytes, sizeof(ItemA), "expected size of one item_a");
+  UNIT_ASSERT_EQUAL(item_a_stats.inserts, 1UL, "expected one insert");
+  UNIT_ASSERT_EQUAL(item_a_stats.removes, 0UL, "expected no remove");
+}
+
+void ObjectStoreTestUnit::test_parallel_view()
+{
+  object_store store;
+  store.attach<Item>("item");
+  store.attach<ItemA, Item>("item_a");
+
+  for (int i = 0; i < 1000; ++i) {
+    store.insert(new Item("item", i));
+  }
+  ItemA *a = new ItemA;
+  a->set_int(7);
+  store.insert(a);
+
+  variable<int> x(make_var<int, Item>("val_int"));
+
+  object_view<Item> items(store);
+  object_view<Item> only_items(store, true);
+
+  std::vector<object_ptr<Item>> result = items.filter(x < 100, 4);
+  UNIT_ASSERT_EQUAL(result.size(), 101UL, "expected 101 items");
+  // results keep the order of the view
+  std::vector<object_ptr<Item>> scanned = items.select(x < 100);
+  UNIT_ASSERT_EQUAL(scanned.size(), result.size(), "expected same size as sequential scan");
+  for (std::size_t i = 0; i < result.size(); ++i) {
+    UNIT_ASSERT_EQUAL(result[i].id(), scanned[i].id(), "expected order of sequential scan");
+  }
+
+  UNIT_ASSERT_EQUAL(only_items.filter(x < 100, 3).size(), 100UL, "expected 100 items");
+  UNIT_ASSERT_EQUAL(items.filter(x > 5000).size(), 0UL, "expected no item");
+  // more threads than objects
+  UNIT_ASSERT_EQUAL(items.filter(x == 7, 2000).size(), 2UL, "expected two items");
+
+  std::size_t count = items.count_if(x >= 500, 8);
+  UNIT_ASSERT_EQUAL(count, 500UL, "expected 500 items");
+  count = items.count_if([](const Item &i) { return i.get_int() % 2 == 0; }, 3);
+  UNIT_ASSERT_EQUAL(count, 500UL, "expected 500 even items");
+
+  std::atomic<long> sum(0);
+  only_items.for_each([&sum](const Item &i) { sum += i.get_int(); }, 4);
+  UNIT_ASSERT_EQUAL(sum.load(), 499500L, "expected sum of all values");
+
+  // exceptions of a worker are passed to the caller
+  UNIT_ASSERT_EXCEPTION(items.for_each([](const Item &i) {
+    if (i.get_int() == 999) {
+      throw object_exception("stop");
+    }
+  }, 4), object_exception, "stop", "expected exception of the worker");
+
+  // scans may be nested within the workers of the pool
+  std::atomic<std::size_t> nested(0);
+  only_items.for_each([&](const Item &i) {
+    if (i.get_int() % 100 == 0) {
+      nested += items.count_if(x < 10, 4);
+    }
+  }, 4);
+  UNIT_ASSERT_EQUAL(nested.load(), 110UL, "expected eleven items for ten scans");
+
+  object_store empty;
+  empty.attach<Item>("item");
+  object_view<Item> no_items(empty);
+  UNIT_ASSERT_EQUAL(no_items.filter(x < 100).size(), 0UL, "expected no item");
+  UNIT_ASSERT_EQUAL(no_items.count_if(x < 100), 0UL, "expected no item");
+}
+
+void ObjectStoreTestUnit::test_typed_expression()
+{
+  object_store store;
+  store.attach<Item>("item");
+
+  for (int i = 0; i < 10; ++i) {
+    store.insert(new Item("item", i));
+  }
+
+  auto x = make_var(&Item::get_int);
+  auto y = make_var(&Item::get_string);
+
+  object_view<Item> items(store);
+
+  UNIT_ASSERT_EQUAL(items.count_if(x >= 3 && x <= 7 && x != 5, 1), 4UL, "expected four items");
+  UNIT_ASSERT_EQUAL(items.count_if(6 > x || y == std::string("none"), 1), 6UL, "expected six items");
+  UNIT_ASSERT_EQUAL(items.count_if(!(x < 8), 1), 2UL, "expected two items");
+
+  object_view<Item>::iterator j = std::find_if(items.begin(), items.end(), x == 6);
+  UNIT_ASSERT_EQUAL((*j)->get_int(), 6, "couldn't find item 6");
+
+  // stored type erased
+  variable<int> z(x);
+  std::unique_ptr<expression> exp(make_expression(z == 4));
+  j = std::find_if(items.begin(), items.end(), std::ref(*exp));
+  UNIT_ASSERT_EQUAL((*j)->get_int(), 4, "couldn't find item 4");
+
+  exp.reset(make_expression(x > 4 && x < 6));
+  j = std::find_if(items.begin(), items.end(), std::ref(*exp));
+  UNIT_ASSERT_EQUAL((*j)->get_int(), 5, "couldn't find item 5");
+}
+
+void ObjectStoreTestUnit::test_ordered_view()
+{
+  object_store store;
+  store.attach<Item>("item");
+  store.attach<ItemA, Item>("item_a");
+
+  oos::date first(1, 1, 2015);
+  for (int i = 0; i < 10; ++i) {
+    Item *item = new Item("item", (i * 7) % 10);
+    item->set_date(first + i);
+    store.insert(item);
+  }
+  ItemA *a = new ItemA;
+  a->set_int(5);
+  a->set_date(first + 20);
+  store.insert(a);
+
+  store.create_index<Item>("val_int", index_type::ORDERED);
+  store.create_index<Item>("val_date", index_type::ORDERED);
+  store.create_index<Item>("val_string");
+
+  object_view<Item> items(store);
+  object_view<Item> only_items(store, true);
+
+  ordered_view<Item, int> by_int = items.ordered_by<int>("val_int");
+  std::size_t count = 0;
+  int last = -1;
+  for (ordered_view<Item, int>::iterator i = by_int.begin(); i != by_int.end(); ++i) {
+    UNIT_ASSERT_TRUE(last <= (*i)->get_int(), "expected ascending values");
+    UNIT_ASSERT_EQUAL(i.key(), (*i)->get_int(), "expected key of the object");
+    last = (*i)->get_int();
+    ++count;
+  }
+  UNIT_ASSERT_EQUAL(count, 11UL, "expected eleven items");
+  UNIT_ASSERT_EQUAL(std::distance(only_items.ordered_by<int>("val_int").begin(), only_items.ordered_by<int>("val_int").end()), 10L, "expected ten items");
+
+  // range of values
+  count = 0;
+  for (ordered_view<Item, int>::iterator i = by_int.lower_bound(3); i != by_int.upper_bound(6); ++i) {
+    UNIT_ASSERT_TRUE((*i)->get_int() >= 3 && (*i)->get_int() <= 6, "expected value within range");
+    ++count;
+  }
+  UNIT_ASSERT_EQUAL(count, 5UL, "expected five items");
+  UNIT_ASSERT_TRUE(by_int.lower_bound(42) == by_int.end(), "expected end");
+
+  // top three in descending order
+  ordered_view<Item, int>::reverse_iterator r = by_int.rbegin();
+  UNIT_ASSERT_EQUAL((*r++)->get_int(), 9, "expected value 9");
+  UNIT_ASSERT_EQUAL((*r++)->get_int(), 8, "expected value 8");
+  UNIT_ASSERT_EQUAL((*r++)->get_int(), 7, "expected value 7");
+
+  // latest by date
+  ordered_view<Item, oos::date> by_date = items.ordered_by<oos::date>("val_date");
+  UNIT_ASSERT_TRUE((*by_date.rbegin())->get_date() == first + 20, "expected date of item_a");
+  UNIT_ASSERT_TRUE((*only_items.ordered_by<oos::date>("val_date").rbegin())->get_date() == first + 9, "expected latest date of items");
+  UNIT_ASSERT_TRUE((*by_date.begin())->get_date() == first, "expected first date");
+
+  // index of the parent node
+  object_view<ItemA> items_a(store);
+  ordered_view<ItemA, int> a_by_int = items_a.ordered_by<int>("val_int");
+  UNIT_ASSERT_EQUAL(std::distance(a_by_int.begin(), a_by_int.end()), 1L, "expected one item_a");
+  UNIT_ASSERT_EQUAL((*(--a_by_int.end()))->get_int(), 5, "expected value of item_a");
+
+  // modifications are reflected by a new view
+  object_ptr<Item> item = *by_int.begin();
+  item->set_int(100);
+  store.mark_modified(item);
+  UNIT_ASSERT_EQUAL((--by_int.end()).key(), 9, "expected unchanged key in the old view");
+  UNIT_ASSERT_EQUAL((*items.ordered_by<int>("val_int").rbegin())->get_int(), 100, "expected modified item last");
+  store.remove(item);
+  by_int = items.ordered_by<int>("val_int");
+  UNIT_ASSERT_EQUAL((*by_int.rbegin())->get_int(), 9, "expected value 9");
+  UNIT_ASSERT_EQUAL((*by_int.begin())->get_int(), 1, "expected value 1");
+
+  UNIT_ASSERT_EXCEPTION(items.ordered_by<std::string>("val_string"), object_exception, "no ordered index on attribute", "expected hash index to be rejected");
+  UNIT_ASSERT_EXCEPTION(items.ordered_by<int>("val_double"), object_exception, "no ordered index on attribute", "expected missing index to be rejected");
+  UNIT_ASSERT_EXCEPTION(items.ordered_by<long>("val_int"), object_exception, "attribute index is of a different type", "expected value type to be checked");
+}
+
+namespace {
+
+struct commit_observer : public transaction::observer, public action_visitor
+{
+  void on_begin() {}
+  void on_commit(transaction::t_action_vector &actions)
+  {
+    action_count = actions.size();
+    inserted.clear();
+    updated.clear();
+    deleted.clear();
+    fields.clear();
+    for (auto &a : actions) {
+      a->accept(this);
+    }
+  }
+  void on_rollback() {}
+
+  virtual void visit(insert_action *act)
+  {
+    for (object_proxy *proxy : *act) {
+      inserted.push_back(proxy->id());
+    }
+  }
+  virtual void visit(update_action *act)
+  {
+    updated.push_back(act->proxy()->id());
+    fields = act->modified_fields();
+  }
+  virtual void visit(delete_action *act)
+  {
+    deleted.push_back(act->id());
+    act->mark_deleted();
+  }
+
+  std::size_t action_count = 0;
+  std::vector<unsigned long> inserted;
+  std::vector<unsigned long> updated;
+  std::vector<unsigned long> deleted;
+  std::vector<std::string> fields;
+};
+
+}
+
+void ObjectStoreTestUnit::test_modified_fields()
+{
+  object_store store;
+  store.attach<Item>("item");
+
+  object_ptr<Item> item = store.insert(new Item("hello", 7));
+
+  std::shared_ptr<commit_observer> observer(new commit_observer);
+  transaction tr(store, observer);
+  tr.begin();
+  item->set_int(8);
+  item->set_string("world");
+  item->set_int(9);
+  tr.commit();
+
+  std::vector<std::string> expected = { "val_int", "val_string" };
+  UNIT_ASSERT_TRUE(observer->fields == expected, "expected int and string to be modified");
+
+  // values changed back aren't modified
+  item->set_double(2.0);
+  tr.begin();
+  item->set_double(3.5);
+  item->set_double(2.0);
+  tr.commit();
+  UNIT_ASSERT_TRUE(observer->updated.empty(), "expected no update");
+
+  // recorded values of another object
+  detail::field_recorder recorder;
+  detail::t_field_values before, after;
+  Item other("hello", 7);
+  recorder.record(other, before);
+  other.set_int(8);
+  recorder.record(other, after);
+  expected = { "val_int" };
+  UNIT_ASSERT_TRUE(detail::field_recorder::modified_fields(before, after) == expected, "expected int to be modified");
+  UNIT_ASSERT_TRUE(detail::field_recorder::modified_fields(before, before).empty(), "expected no modified field");
+}
+
+void ObjectStoreTestUnit::test_coalesce_actions()
+{
+  object_store store;
+  store.attach<Item>("item");
+
+  object_ptr<Item> a = store.insert(new Item("a", 1));
+  object_ptr<Item> b = store.insert(new Item("b", 2));
+
+  std::shared_ptr<commit_observer> observer(new commit_observer);
+  transaction tr(store, observer);
+
+  // insert, three updates and a delete leave nothing
+  tr.begin();
+  object_ptr<Item> c = store.insert(new Item("c", 3));
+  c->set_int(4);
+  c->set_int(5);
+  c->set_int(6);
+  store.remove(c);
+  tr.commit();
+  UNIT_ASSERT_EQUAL(observer->action_count, 0UL, "expected no action");
+
+  // insert and update fold into the insert,
+  // repeated updates into one update
+  tr.begin();
+  object_ptr<Item> d = store.insert(new Item("d", 7));
+  d->set_int(8);
+  a->set_int(10);
+  a->set_int(11);
+  a->set_int(12);
+  b->set_int(13);
+  store.remove(b);
+  tr.commit();
+  UNIT_ASSERT_EQUAL(observer->action_count, 3UL, "expected three actions");
+  UNIT_ASSERT_EQUAL(observer->inserted.size(), 1UL, "expected one insert");
+  UNIT_ASSERT_EQUAL(observer->inserted.front(), d.id(), "expected d to be inserted");
+  UNIT_ASSERT_EQUAL(observer->updated.size(), 1UL, "expected one update");
+  UNIT_ASSERT_EQUAL(observer->updated.front(), a.id(), "expected a to be updated");
+  UNIT_ASSERT_EQUAL(observer->deleted.size(), 1UL, "expected one delete");
+  UNIT_ASSERT_EQUAL(observer->deleted.front(), b.id(), "expected b to be deleted");
+  UNIT_ASSERT_EQUAL(d->get_int(), 8, "expected d to be updated");
+  UNIT_ASSERT_EQUAL(a->get_int(), 12, "expected a to be updated");
+
+  // the action log is kept for a rollback
+  unsigned long aid = a.id();
+  tr.begin();
+  object_ptr<Item> e = store.insert(new Item("e", 14));
+  object_ptr<Item> f = store.insert(new Item("f", 15));
+  unsigned long eid = e.id();
+  a->set_int(16);
+  store.remove(a);
+  store.remove(e);
+  tr.rollback();
+  UNIT_ASSERT_TRUE(store.find_proxy(eid) == nullptr, "expected e to be removed");
+  UNIT_ASSERT_TRUE(store.find_proxy(f.id()) == nullptr, "expected f to be removed");
+  object_proxy *proxy = store.find_proxy(aid);
+  UNIT_ASSERT_NOT_NULL(proxy, "expected a to be restored");
+  UNIT_ASSERT_EQUAL(static_cast<Item*>(proxy->obj())->get_int(), 12, "expected old value of a");
+}
+
+void ObjectStoreTestUnit::test_savepoint()
+{
+  object_store store;
+  store.attach<Item>("item");
+
+  object_ptr<Item> a = store.insert(new Item("a", 1));
+  object_ptr<Item> b = store.insert(new Item("b", 2));
+  unsigned long bid = b.id();
+
+  std::shared_ptr<commit_observer> observer(new commit_observer);
+  transaction tr(store, observer);
+
+  tr.begin();
+  a->set_int(2);
+  object_ptr<Item> c = store.insert(new Item("c", 3));
+  unsigned long cid = c.id();
+  std::size_t sp = tr.savepoint();
+  UNIT_ASSERT_EQUAL(sp, 0UL, "expected first savepoint");
+
+  // changes after the savepoint are reverted
+  a->set_int(3);
+  c->set_int(4);
+  object_ptr<Item> d = store.insert(new Item("d", 5));
+  unsigned long did = d.id();
+  store.remove(b);
+  std::size_t sp2 = tr.savepoint();
+  a->set_int(6);
+  store.remove(c);
+  UNIT_ASSERT_EXCEPTION(tr.rollback_to(2), object_exception, "transaction: unknown savepoint", "expected unknown savepoint");
+  tr.rollback_to(sp);
+
+  UNIT_ASSERT_EQUAL(a->get_int(), 2, "expected value of a at savepoint");
+  UNIT_ASSERT_TRUE(store.find_proxy(did) == nullptr, "expected d to be removed");
+  object_proxy *proxy = store.find_proxy(bid);
+  UNIT_ASSERT_NOT_NULL(proxy, "expected b to be restored");
+  UNIT_ASSERT_EQUAL(static_cast<Item*>(proxy->obj())->get_int(), 2, "expected value of b");
+  proxy = store.find_proxy(cid);
+  UNIT_ASSERT_NOT_NULL(proxy, "expected c to be restored");
+  UNIT_ASSERT_EQUAL(static_cast<Item*>(proxy->obj())->get_int(), 3, "expected value of c at savepoint");
+  UNIT_ASSERT_EXCEPTION(tr.rollback_to(sp2), object_exception, "transaction: unknown savepoint", "expected later savepoint to be removed");
+
+  // the savepoint stays valid
+  a->set_int(7);
+  tr.rollback_to(sp);
+  UNIT_ASSERT_EQUAL(a->get_int(), 2, "expected value of a at savepoint");
+
+  a->set_int(8);
+  tr.commit();
+  UNIT_ASSERT_EQUAL(observer->inserted.size(), 1UL, "expected one insert");
+  UNIT_ASSERT_EQUAL(observer->inserted.front(), cid, "expected c to be inserted");
+  UNIT_ASSERT_EQUAL(observer->updated.size(), 1UL, "expected one update");
+  UNIT_ASSERT_EQUAL(observer->updated.front(), a.id(), "expected a to be updated");
+  UNIT_ASSERT_TRUE(observer->deleted.empty(), "expected no delete");
+  UNIT_ASSERT_EQUAL(a->get_int(), 8, "expected committed value of a");
+
+  // a full rollback reverts all savepoints
+  tr.begin();
+  a->set_int(9);
+  tr.savepoint();
+  a->set_int(10);
+  tr.savepoint();
+  store.remove(a);
+  tr.rollback();
+  proxy = store.find_proxy(a.id());
+  UNIT_ASSERT_NOT_NULL(proxy, "expected a to be restored");
+  UNIT_ASSERT_EQUAL(static_cast<Item*>(proxy->obj())->get_int(), 8, "expected value of a before the transaction");
+
+  // objects inserted before and deleted after a savepoint are left out
+  tr.begin();
+  object_ptr<Item> e = store.insert(new Item("e", 11));
+  object_ptr<Item> f = store.insert(new Item("f", 12));
+  tr.savepoint();
+  store.remove(e);
+  a->set_int(13);
+  tr.commit();
+  UNIT_ASSERT_EQUAL(observer->inserted.size(), 1UL, "expected one insert");
+  UNIT_ASSERT_EQUAL(observer->inserted.front(), f.id(), "expected f to be inserted");
+  UNIT_ASSERT_EQUAL(observer->updated.size(), 1UL, "expected one update");
+  UNIT_ASSERT_TRUE(observer->deleted.empty(), "expected no delete");
+}
@@ -42,6 +42,25 @@ public:
   void test_primary_key();
   void test_has_many();
   void test_on_attach();
+  void test_proxy_pool();
+  void test_emplace();
+  void test_holder_list();
+  void test_view_size();
+  void test_index();
+  void test_insert_range();
+  void test_get_by_pk();
+  void test_concurrent_reads();
+  void test_snapshot();
+  void test_batch_observer();
+  void test_remove_range();
+  void test_type_slot();
+  void test_stats();
+  void test_parallel_view();
+  void test_typed_expression();
+  void test_ordered_view();
+  void test_modified_fields();
+  void test_coalesce_actions();
+  void test_savepoint();
 
 private:
   oos::object_store ostore_;
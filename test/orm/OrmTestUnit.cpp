@@ -12,6 +12,9 @@
 
 #include "object/object_view.hpp"
 
+#include <algorithm>
+#include <thread>
+
 using namespace hasmanylist;
 
 OrmTestUnit::OrmTestUnit(const std::string &prefix, const std::string &dns)
@@ -21,9 +24,15 @@ OrmTestUnit::OrmTestUnit(const std::string &prefix, const std::string &dns)
   add_test("create", std::bind(&OrmTestUnit::test_create, this), "test orm create table");
   add_test("insert", std::bind(&OrmTestUnit::test_insert, this), "test orm insert into table");
   add_test("update", std::bind(&OrmTestUnit::test_update, this), "test orm update on table");
+  add_test("update_fields", std::bind(&OrmTestUnit::test_update_fields, this), "test orm update of modified columns");
   add_test("delete", std::bind(&OrmTestUnit::test_delete, this), "test orm delete from table");
   add_test("load", std::bind(&OrmTestUnit::test_load, this), "test orm load from table");
   add_test("load_has_one", std::bind(&OrmTestUnit::test_load_has_one, this), "test orm load has one relation from table");
+  add_test("load_lazy", std::bind(&OrmTestUnit::test_load_lazy, this), "test orm lazy load from table");
+  add_test("remove_lazy", std::bind(&OrmTestUnit::test_remove_lazy, this), "test orm batch removal of lazy loaded objects");
+  add_test("index_lazy", std::bind(&OrmTestUnit::test_index_lazy, this), "test orm index lookup of lazy loaded objects");
+  add_test("fetch_concurrent", std::bind(&OrmTestUnit::test_fetch_concurrent, this), "test orm concurrent fetch of lazy loaded objects");
+  add_test("eviction", std::bind(&OrmTestUnit::test_eviction, this), "test orm eviction of lazy loaded objects");
   add_test("load_has_many", std::bind(&OrmTestUnit::test_load_has_many, this), "test orm load has many from table");
   add_test("load_has_many_int", std::bind(&OrmTestUnit::test_load_has_many_int, this), "test orm load has many int from table");
   add_test("has_many_delete", std::bind(&OrmTestUnit::test_has_many_delete, this), "test orm has many delete item");
@@ -117,6 +126,67 @@ void OrmTestUnit::test_update()
   p.drop();
 }
 
+void OrmTestUnit::test_update_fields()
+{
+  oos::persistence p(dns_);
+
+  p.attach<person>("person");
+
+  p.create();
+
+  oos::session s(p);
+
+  oos::date birthday(18, 5, 1980);
+  auto hans = s.insert(new person("hans", birthday, 180));
+
+  oos::connection c(dns_);
+  c.open();
+
+  // change the name behind the back of the session
+  c.execute("UPDATE person SET name='otto' WHERE id=" + std::to_string(hans->id()));
+
+  // only the modified height is written
+  oos::transaction tr = s.begin();
+  hans->height(179);
+  tr.commit();
+
+  oos::query<person> q("person");
+  auto res = q.select().where(oos::column("id") == hans->id()).execute(c);
+  auto first = res.begin();
+  UNIT_ASSERT_TRUE(first != res.end(), "first must not end");
+  std::unique_ptr<person> p1(first.release());
+  UNIT_EXPECT_EQUAL("otto", p1->name(), "name must not be overwritten");
+  UNIT_EXPECT_EQUAL(179U, p1->height(), "height must be 179");
+  UNIT_EXPECT_EQUAL(p1->birthdate(), birthday, "birthday must be equal");
+
+  // the prepared statement for the same columns is reused
+  tr.begin();
+  hans->height(178);
+  hans->name("georg");
+  tr.commit();
+  tr.begin();
+  hans->height(177);
+  tr.commit();
+
+  res = q.select().where(oos::column("id") == hans->id()).execute(c);
+  first = res.begin();
+  UNIT_ASSERT_TRUE(first != res.end(), "first must not end");
+  p1.reset(first.release());
+  UNIT_EXPECT_EQUAL("georg", p1->name(), "invalid name");
+  UNIT_EXPECT_EQUAL(177U, p1->height(), "height must be 177");
+
+  // explicit updates write all columns
+  hans->height(176);
+  s.update(hans);
+  res = q.select().where(oos::column("id") == hans->id()).execute(c);
+  first = res.begin();
+  UNIT_ASSERT_TRUE(first != res.end(), "first must not end");
+  p1.reset(first.release());
+  UNIT_EXPECT_EQUAL(176U, p1->height(), "height must be 176");
+
+  p.drop();
+}
+
 void OrmTestUnit::test_delete()
 {
   oos::persistence p(dns_);
@@ -247,6 +317,351 @@ void OrmTestUnit::test_load_has_one()
   p.drop();
 }
 
+void OrmTestUnit::test_load_lazy()
+{
+  oos::persistence p(dns_);
+
+  p.attach<person>("person");
+  p.attach<master>("master");
+  p.attach<child>("child");
+
+  p.create();
+
+  unsigned long master_id = 0;
+  {
+    oos::session s(p);
+
+    s.insert(new person("hans", oos::date(18, 5, 1980), 180));
+    s.insert(new person("otto", oos::date(18, 5, 1980), 180));
+
+    auto c = s.insert(new child("child 1"));
+
+    auto m = new master("master 1");
+    m->children = c;
+    master_id = s.insert(m)->id;
+  }
+
+  p.clear();
+
+  {
+    // load primary keys only
+    oos::session s(p);
+
+    s.load(oos::load_mode::KEYS);
+
+    typedef oos::object_view<person> t_person_view;
+    t_person_view persons(s.store());
+
+    UNIT_ASSERT_EQUAL(persons.size(), 2UL, "their must be 2 persons");
+
+    auto person_stats = [&s]() {
+      oos::store_stats stats = s.store().stats();
+      return *std::find_if(stats.nodes.begin(), stats.nodes.end(), [](const oos::node_stats &node) {
+        return node.type == "person";
+      });
+    };
+    UNIT_ASSERT_EQUAL(person_stats().proxy_count, 2UL, "expected two proxies");
+    UNIT_ASSERT_EQUAL(person_stats().object_count, 0UL, "expected no loaded person");
+
+    auto pptr = persons.front();
+    UNIT_ASSERT_FALSE(pptr.is_loaded(), "person must not be loaded");
+    UNIT_ASSERT_TRUE(pptr->name() == "hans" || pptr->name() == "otto", "invalid name");
+    UNIT_ASSERT_TRUE(pptr.is_loaded(), "person must be loaded");
+    UNIT_ASSERT_FALSE(persons.back().is_loaded(), "person must not be loaded");
+    UNIT_ASSERT_EQUAL(person_stats().object_count, 1UL, "expected one loaded person");
+  }
+
+  p.clear();
+
+  {
+    // load nothing
+    oos::session s(p);
+
+    s.load(oos::load_mode::NONE);
+
+    typedef oos::object_view<master> t_master_view;
+    t_master_view masters(s.store());
+
+    UNIT_ASSERT_TRUE(masters.empty(), "master view must be empty");
+
+    auto mptr = s.get<master>(master_id);
+    UNIT_ASSERT_TRUE(mptr.is_loaded(), "master must be loaded");
+    UNIT_ASSERT_EQUAL(mptr->name, "master 1", "invalid name");
+    UNIT_ASSERT_EQUAL(masters.size(), 1UL, "their must be 1 master");
+    UNIT_ASSERT_FALSE(mptr->children.is_loaded(), "child must not be loaded");
+    UNIT_ASSERT_NOT_NULL(mptr->children.get(), "child must be valid");
+    UNIT_ASSERT_EQUAL(mptr->children->name, "child 1", "invalid name");
+
+    UNIT_ASSERT_TRUE(s.get<master>(master_id + 1).get() == nullptr, "master must not exist");
+  }
+
+  p.drop();
+}
+
+void OrmTestUnit::test_remove_lazy()
+{
+  oos::persistence p(dns_);
+
+  p.attach<person>("person");
+
+  p.create();
+
+  {
+    oos::session s(p);
+
+    s.insert(new person("hans", oos::date(18, 5, 1980), 180));
+    s.insert(new person("otto", oos::date(18, 5, 1980), 180));
+    s.insert(new person("georg", oos::date(18, 5, 1980), 180));
+  }
+
+  p.clear();
+
+  {
+    oos::session s(p);
+
+    s.load(oos::load_mode::KEYS);
+
+    typedef oos::object_view<person> t_person_view;
+    t_person_view persons(s.store());
+
+    std::vector<oos::object_ptr<person>> range(persons.begin(), persons.end());
+    range.pop_back();
+
+    UNIT_ASSERT_FALSE(range.front().is_loaded(), "person must not be loaded");
+
+    // unloaded objects are fetched before they are checked
+    std::size_t removed = s.store().remove_range<person>(range.begin(), range.end());
+    UNIT_ASSERT_EQUAL(removed, 2UL, "expected two removed persons");
+    UNIT_ASSERT_EQUAL(persons.size(), 1UL, "expected one person");
+  }
+
+  p.drop();
+}
+
+void OrmTestUnit::test_index_lazy()
+{
+  oos::persistence p(dns_);
+
+  p.attach<person>("person");
+
+  p.create();
+
+  {
+    oos::session s(p);
+
+    s.insert(new person("hans", oos::date(18, 5, 1980), 183));
+    s.insert(new person("otto", oos::date(18, 5, 1980), 175));
+    s.insert(new person("georg", oos::date(18, 5, 1980), 180));
+    s.insert(new person("hilde", oos::date(18, 5, 1980), 168));
+  }
+
+  p.clear();
+
+  {
+    oos::session s(p);
+
+    s.load(oos::load_mode::KEYS);
+
+    s.store().create_index<person>("name", oos::index_type::ORDERED);
+
+    typedef oos::object_view<person> t_person_view;
+    t_person_view persons(s.store());
+
+    UNIT_ASSERT_FALSE(persons.front().is_loaded(), "person must not be loaded");
+
+    // unloaded objects are fetched before they are indexed
+    oos::variable<std::string> name(oos::make_var<std::string, person>("name"));
+    std::vector<oos::object_ptr<person>> found = persons.select(name == std::string("otto"));
+    UNIT_ASSERT_EQUAL(found.size(), 1UL, "expected one person");
+    UNIT_ASSERT_EQUAL(found.front()->height(), 175U, "expected height of otto");
+
+    oos::ordered_view<person, std::string> by_name = persons.ordered_by<std::string>("name");
+    UNIT_ASSERT_EQUAL(std::distance(by_name.begin(), by_name.end()), 4L, "expected four persons");
+    UNIT_ASSERT_EQUAL((*by_name.begin())->name(), "georg", "expected georg");
+  }
+
+  p.clear();
+
+  {
+    oos::session s(p);
+
+    s.load(oos::load_mode::KEYS);
+
+    // unloaded objects aren't evaluated
+    oos::variable<std::string> name(oos::make_var<std::string, person>("name"));
+    std::size_t removed = s.store().remove_if<person>(name < std::string("hilde"));
+    UNIT_ASSERT_EQUAL(removed, 0UL, "expected no removed person");
+
+    typedef oos::object_view<person> t_person_view;
+    t_person_view persons(s.store());
+    UNIT_ASSERT_EQUAL(persons.size(), 4UL, "expected four persons");
+    UNIT_ASSERT_FALSE(persons.front().is_loaded(), "person must not be loaded");
+
+    // fetch the persons through their object_ptr
+    for (const oos::object_ptr<person> &p : persons) {
+      UNIT_ASSERT_FALSE(p->name().empty(), "expected name of person");
+    }
+    removed = s.store().remove_if<person>(name < std::string("hilde"));
+    UNIT_ASSERT_EQUAL(removed, 2UL, "expected two removed persons");
+    UNIT_ASSERT_EQUAL(persons.size(), 2UL, "expected two persons");
+  }
+
+  p.drop();
+}
+
+void OrmTestUnit::test_fetch_concurrent()
+{
+  oos::persistence p(dns_);
+
+  p.attach<person>("person");
+
+  p.create();
+
+  {
+    oos::session s(p);
+
+    oos::transaction tr = s.begin();
+    for (int i = 0; i < 200; ++i) {
+      s.insert(new person("person " + std::to_string(i), oos::date(18, 5, 1980), 180));
+    }
+    tr.commit();
+  }
+
+  p.clear();
+
+  {
+    oos::session s(p);
+
+    s.load(oos::load_mode::KEYS);
+
+    typedef oos::object_view<person> t_person_view;
+    t_person_view persons(s.store());
+    const std::vector<oos::object_ptr<person>> all(persons.begin(), persons.end());
+
+    // reader threads share the prepared statements of the table
+    std::vector<std::thread> readers;
+    std::vector<std::size_t> found(4, 0);
+    for (std::size_t r = 0; r < found.size(); ++r) {
+      readers.push_back(std::thread([&all, &found, r]() {
+        for (const oos::object_ptr<person> &optr : all) {
+          if (optr->name().compare(0, 7, "person ") == 0) {
+            ++found[r];
+          }
+        }
+      }));
+    }
+    for (std::thread &reader : readers) {
+      reader.join();
+    }
+
+    for (std::size_t n : found) {
+      UNIT_ASSERT_EQUAL(n, 200UL, "expected all persons");
+    }
+  }
+
+  p.drop();
+}
+
+void OrmTestUnit::test_eviction()
+{
+  oos::persistence p(dns_);
+
+  p.attach<person>("person");
+
+  p.create();
+
+  std::vector<std::string> names({"hans", "otto", "georg", "hilde", "ute", "manfred"});
+
+  {
+    oos::session s(p);
+
+    for (std::string name : names) {
+      s.insert(new person(name, oos::date(18, 5, 1980), 180));
+    }
+  }
+
+  p.clear();
+
+  {
+    oos::session s(p);
+
+    p.eviction().budget(2 * sizeof(person));
+    s.load(oos::load_mode::KEYS);
+
+    typedef oos::object_view<person> t_person_view;
+    t_person_view persons(s.store());
+
+    std::vector<std::string> loaded;
+    for (auto pptr : persons) {
+      loaded.push_back(pptr->name());
+    }
+    UNIT_ASSERT_EQUAL(loaded.size(), names.size(), "all persons must be loaded");
+    UNIT_ASSERT_GREATER(p.eviction().evicted(), 0UL, "objects must be evicted");
+
+    std::size_t unloaded = 0;
+    for (auto pptr : persons) {
+      if (!pptr.is_loaded()) {
+        ++unloaded;
+      }
+    }
+    UNIT_ASSERT_GREATER(unloaded, 0UL, "persons must be evicted");
+
+    // evicted persons are reloaded
+    auto first = persons.begin();
+    for (const std::string &name : loaded) {
+      UNIT_ASSERT_EQUAL((*first++)->name(), name, "invalid name");
+    }
+
+    // nothing is evicted within a transaction,
+    // beginning it is a safe point for eviction
+    oos::transaction tr = s.begin();
+    std::size_t evicted = p.eviction().evicted();
+    for (auto pptr : persons) {
+      pptr->name();
+    }
+    UNIT_ASSERT_EQUAL(p.eviction().evicted(), evicted, "objects must not be evicted");
+    tr.rollback();
+  }
+
+  p.clear();
+
+  {
+    oos::session s(p);
+
+    s.load(oos::load_mode::KEYS);
+
+    typedef oos::object_view<person> t_person_view;
+    t_person_view persons(s.store());
+
+    // objects modified outside of a transaction are never evicted
+    s.store().create_index<person>("name");
+    oos::object_ptr<person> hans = persons.front();
+    hans->name("johann");
+    s.store().mark_modified(hans);
+    for (auto pptr : persons) {
+      pptr->name();
+    }
+    UNIT_ASSERT_TRUE(hans.is_loaded(), "modified person must not be evicted");
+    oos::variable<std::string> name(oos::make_var<std::string, person>("name"));
+    UNIT_ASSERT_EQUAL(persons.select(name == std::string("johann")).size(), 1UL, "expected modified person");
+
+    // once its change is written the person may be evicted again,
+    // only the changed name is written
+    oos::transaction tr = s.begin();
+    hans->name("johanna");
+    s.store().mark_modified(hans);
+    tr.commit();
+    p.eviction().budget(1);
+    for (int i = 0; i < 2; ++i) {
+      p.eviction().sweep(s.store());
+    }
+    UNIT_ASSERT_FALSE(hans.is_loaded(), "written person must be evicted");
+    UNIT_ASSERT_EQUAL(hans->name(), "johanna", "expected written name");
+  }
+
+  p.drop();
+}
+
 void OrmTestUnit::test_load_has_many()
 {
   oos::persistence p(dns_);
@@ -302,6 +717,15 @@ void OrmTestUnit::test_load_has_many()
     }
   }
 
+  p.clear();
+
+  {
+    oos::session s(p);
+
+    // has many relations aren't fetched lazily
+    UNIT_ASSERT_EXCEPTION(s.load(oos::load_mode::KEYS), oos::object_exception, "lazy loading of types with has many relations isn't supported", "expected has many type to be rejected");
+  }
+
   p.drop();
 }
 
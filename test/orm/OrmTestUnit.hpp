@@ -16,9 +16,15 @@ public:
   void test_create();
   void test_insert();
   void test_update();
+  void test_update_fields();
   void test_delete();
   void test_load();
   void test_load_has_one();
+  void test_load_lazy();
+  void test_remove_lazy();
+  void test_index_lazy();
+  void test_fetch_concurrent();
+  void test_eviction();
   void test_load_has_many();
   void test_load_has_many_int();
   void test_has_many_delete();
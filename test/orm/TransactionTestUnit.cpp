@@ -17,6 +17,9 @@ TransactionTestUnit::TransactionTestUnit(const std::string &name, const std::str
 {
   add_test("simple", std::bind(&TransactionTestUnit::test_simple, this), "simple transaction test");
   add_test("nested", std::bind(&TransactionTestUnit::test_nested, this), "nested transaction test");
+  add_test("savepoint", std::bind(&TransactionTestUnit::test_savepoint, this), "transaction savepoint test");
+  add_test("group_commit", std::bind(&TransactionTestUnit::test_group_commit, this), "group commit transaction test");
+  add_test("group_commit_failure", std::bind(&TransactionTestUnit::test_group_commit_failure, this), "failed group commit transaction test");
   add_test("foreign", std::bind(&TransactionTestUnit::test_foreign, this), "object with foreign key transaction test");
   add_test("list_commit", std::bind(&TransactionTestUnit::test_has_many_list_commit, this), "object with object list transaction commit test");
   add_test("list_rollback", std::bind(&TransactionTestUnit::test_has_many_list_rollback, this), "object with object list transaction rollback test");
@@ -147,6 +150,189 @@ void TransactionTestUnit::test_nested()
   p.drop();
 }
 
+void TransactionTestUnit::test_savepoint()
+{
+  oos::persistence p(dns_);
+
+  p.attach<person>("person");
+
+  p.create();
+
+  oos::session s(p);
+
+  transaction tr = s.begin();
+
+  oos::date d1(21, 12, 1980);
+  auto hans = s.insert(new person("hans", d1, 180));
+  // the changes are written to the database at each savepoint
+  std::size_t sp = tr.savepoint();
+  s.insert(new person("george", d1, 170));
+  hans->height(175);
+  std::size_t sp2 = tr.savepoint();
+  s.insert(new person("jane", d1, 160));
+  tr.rollback_to(sp);
+  UNIT_ASSERT_EXCEPTION(tr.rollback_to(sp2), object_exception, "transaction: unknown savepoint", "savepoint must be removed");
+  hans->height(179);
+  std::size_t sp3 = tr.savepoint();
+  s.insert(new person("otto", d1, 165));
+  tr.release(sp3);
+  UNIT_ASSERT_EXCEPTION(tr.rollback_to(sp3), object_exception, "transaction: unknown savepoint", "savepoint must be released");
+  tr.commit();
+
+  oos::object_view<person> persons(s.store());
+  UNIT_ASSERT_EQUAL(2UL, persons.size(), "size must be two");
+
+  oos::query<person> q("person");
+  oos::connection c(dns_);
+  c.open();
+  auto res = q.select().execute(c);
+  std::size_t count = 0;
+  for (auto first = res.begin(); first != res.end(); ++first) {
+    std::unique_ptr<person> p1(first.release());
+    if (p1->name() == "hans") {
+      UNIT_ASSERT_EQUAL(179U, p1->height(), "height must be 179");
+    } else {
+      UNIT_ASSERT_EQUAL("otto", p1->name(), "name must be 'otto'");
+      UNIT_ASSERT_EQUAL(165U, p1->height(), "height must be 165");
+    }
+    ++count;
+  }
+  UNIT_ASSERT_EQUAL(2UL, count, "expected two persons in the database");
+
+  p.drop();
+}
+
+void TransactionTestUnit::test_group_commit()
+{
+  oos::persistence p(dns_);
+
+  p.attach<person>("person");
+
+  p.create();
+
+  oos::session s(p);
+
+  p.group_commit().enable(3, std::chrono::milliseconds(0));
+
+  UNIT_ASSERT_TRUE(p.group_commit().enabled(), "group commit must be enabled");
+
+  oos::date d1(21, 12, 1980);
+  s.insert(new person("hans", d1, 180));
+  s.insert(new person("george", d1, 170));
+
+  UNIT_ASSERT_EQUAL(2UL, p.group_commit().pending(), "two commits must be pending");
+  UNIT_ASSERT_EQUAL(0UL, p.group_commit().commits(), "database must not be committed");
+  UNIT_ASSERT_TRUE(s.last_commit().wait_for(std::chrono::milliseconds(0)) == std::future_status::timeout, "commit must not be durable");
+
+  std::shared_future<void> second = s.last_commit();
+  s.insert(new person("jane", d1, 165));
+
+  UNIT_ASSERT_EQUAL(0UL, p.group_commit().pending(), "no commit must be pending");
+  UNIT_ASSERT_EQUAL(1UL, p.group_commit().commits(), "database must be committed once");
+  UNIT_ASSERT_TRUE(second.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready, "commit must be durable");
+
+  s.insert(new person("otto", d1, 175));
+  p.group_commit().flush();
+
+  UNIT_ASSERT_EQUAL(2UL, p.group_commit().commits(), "database must be committed twice");
+  UNIT_ASSERT_TRUE(s.last_commit().wait_for(std::chrono::milliseconds(0)) == std::future_status::ready, "commit must be durable");
+
+  // commit after the window elapsed
+  p.group_commit().enable(0, std::chrono::milliseconds(20));
+  s.insert(new person("susi", d1, 160));
+  s.last_commit().wait();
+
+  UNIT_ASSERT_EQUAL(3UL, p.group_commit().commits(), "database must be committed three times");
+
+  p.group_commit().disable();
+
+  UNIT_ASSERT_FALSE(p.group_commit().enabled(), "group commit must be disabled");
+
+  oos::query<person> q("person");
+  oos::connection c(dns_);
+  c.open();
+  auto res = q.select().execute(c);
+  std::size_t count = 0;
+  for (auto first = res.begin(); first != res.end(); ++first) {
+    std::unique_ptr<person> p1(first.release());
+    ++count;
+  }
+  UNIT_ASSERT_EQUAL(5UL, count, "expected five persons in the database");
+
+  p.drop();
+}
+
+void TransactionTestUnit::test_group_commit_failure()
+{
+  oos::persistence p(dns_);
+
+  if (p.conn().type() != "sqlite") {
+    // the failure relies on the database locking of sqlite
+    return;
+  }
+
+  p.attach<person>("person");
+
+  p.create();
+
+  oos::session s(p);
+
+  p.group_commit().enable(2, std::chrono::milliseconds(0));
+
+  // a reading transaction of another connection blocks the commit
+  oos::connection reader(dns_);
+  reader.open();
+  reader.begin();
+  reader.execute("SELECT * FROM person;");
+
+  oos::date d1(21, 12, 1980);
+  s.insert(new person("hans", d1, 180));
+  s.insert(new person("george", d1, 170));
+
+  UNIT_ASSERT_EQUAL(0UL, p.group_commit().pending(), "no commit must be pending");
+  UNIT_ASSERT_EQUAL(0UL, p.group_commit().commits(), "database must not be committed");
+  bool failed = false;
+  try {
+    s.last_commit().get();
+  } catch (std::exception &) {
+    failed = true;
+  }
+  UNIT_ASSERT_TRUE(failed, "group commit must fail");
+
+  // the store keeps the committed objects until the next transaction
+  oos::object_view<person> persons(s.store());
+  UNIT_ASSERT_EQUAL(2UL, persons.size(), "expected two persons in the store");
+
+  reader.rollback();
+  reader.close();
+
+  // the group was rolled back, the next one is committed
+  transaction tr = s.begin();
+  UNIT_ASSERT_EQUAL(0UL, persons.size(), "failed commits must be rolled back in the store");
+  s.insert(new person("jane", d1, 165));
+  tr.commit();
+  p.group_commit().flush();
+  s.last_commit().get();
+  UNIT_ASSERT_EQUAL(1UL, persons.size(), "expected one person in the store");
+
+  UNIT_ASSERT_EQUAL(1UL, p.group_commit().commits(), "database must be committed once");
+
+  p.group_commit().disable();
+
+  oos::query<person> q("person");
+  oos::connection c(dns_);
+  c.open();
+  auto res = q.select().execute(c);
+  std::size_t count = 0;
+  for (auto first = res.begin(); first != res.end(); ++first) {
+    std::unique_ptr<person> p1(first.release());
+    ++count;
+  }
+  UNIT_ASSERT_EQUAL(1UL, count, "expected one person in the database");
+
+  p.drop();
+}
+
 void TransactionTestUnit::test_foreign()
 {
   oos::persistence p(dns_);
@@ -34,6 +34,9 @@ public:
 
   void test_simple();
   void test_nested();
+  void test_savepoint();
+  void test_group_commit();
+  void test_group_commit_failure();
   void test_foreign();
   void test_has_many_list_commit();
   void test_has_many_list_rollback();
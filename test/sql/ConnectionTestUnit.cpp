@@ -18,6 +18,7 @@
 #include "ConnectionTestUnit.hpp"
 
 #include "sql/connection.hpp"
+#include "sql/query.hpp"
 
 #include <fstream>
 
@@ -30,6 +31,7 @@ ConnectionTestUnit::ConnectionTestUnit(const std::string &name, const std::strin
 {
   add_test("open_close", std::bind(&ConnectionTestUnit::test_open_close, this), "open sql test");
   add_test("reopen", std::bind(&ConnectionTestUnit::test_reopen, this), "reopen sql test");
+  add_test("savepoint", std::bind(&ConnectionTestUnit::test_savepoint, this), "savepoint sql test");
 }
 
 ConnectionTestUnit::~ConnectionTestUnit()
@@ -71,6 +73,43 @@ void ConnectionTestUnit::test_reopen()
   UNIT_ASSERT_FALSE(conn.is_open(), "couldn't close sql sql");
 }
 
+void ConnectionTestUnit::test_savepoint()
+{
+  oos::connection conn(connection_string());
+
+  conn.open();
+
+  conn.execute("CREATE TABLE savepoint_test (id INTEGER);");
+
+  conn.begin();
+  conn.execute("INSERT INTO savepoint_test VALUES (1);");
+  conn.savepoint("first");
+  conn.execute("INSERT INTO savepoint_test VALUES (2);");
+  conn.savepoint("second");
+  conn.execute("INSERT INTO savepoint_test VALUES (3);");
+  conn.release("second");
+  conn.rollback_to("first");
+  conn.execute("INSERT INTO savepoint_test VALUES (4);");
+  conn.commit();
+
+  oos::query<> q(&conn, "savepoint_test");
+  auto res = q.select({"id"}).from("savepoint_test").execute();
+
+  std::vector<long> ids;
+  for (auto first = res.begin(); first != res.end(); ++first) {
+    std::unique_ptr<row> r(first.release());
+    ids.push_back(r->at<long>("id"));
+  }
+
+  UNIT_ASSERT_EQUAL(ids.size(), 2UL, "expected two rows");
+  UNIT_ASSERT_EQUAL(ids[0], 1L, "expected first row");
+  UNIT_ASSERT_EQUAL(ids[1], 4L, "expected row after rollback");
+
+  conn.execute("DROP TABLE savepoint_test;");
+
+  conn.close();
+}
+
 std::string ConnectionTestUnit::connection_string()
 {
   return dns_;
@@ -34,6 +34,7 @@ public:
 
   void test_open_close();
   void test_reopen();
+  void test_savepoint();
 
 protected:
   std::string connection_string();
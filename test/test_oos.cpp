@@ -25,6 +25,9 @@
 #include "tools/VarCharTestUnit.hpp"
 #include "tools/FactoryTestUnit.hpp"
 #include "tools/StringTestUnit.hpp"
+#include "tools/FlatHashMapTestUnit.hpp"
+#include "tools/SequencerTestUnit.hpp"
+#include "tools/ByteBufferTestUnit.hpp"
 
 #include "object/ObjectStoreTestUnit.hpp"
 #include "object/ObjectPrototypeTestUnit.hpp"
@@ -74,6 +77,9 @@ int main(int argc, char *argv[])
   suite.register_unit(new VarCharTestUnit);
   suite.register_unit(new FactoryTestUnit);
   suite.register_unit(new StringTestUnit);
+  suite.register_unit(new FlatHashMapTestUnit);
+  suite.register_unit(new SequencerTestUnit);
+  suite.register_unit(new ByteBufferTestUnit);
 
   suite.register_unit(new PrimaryKeyUnitTest);
   suite.register_unit(new PrototypeTreeTestUnit);
@@ -0,0 +1,188 @@
+#include "ByteBufferTestUnit.hpp"
+
+#include "tools/byte_buffer.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace oos;
+
+ByteBufferTestUnit::ByteBufferTestUnit()
+  : unit_test("byte_buffer", "byte buffer test unit")
+{
+  add_test("append_release", std::bind(&ByteBufferTestUnit::test_append_release, this), "test byte buffer append and release");
+  add_test("large_append", std::bind(&ByteBufferTestUnit::test_large_append, this), "test byte buffer appends larger than a chunk");
+  add_test("reserve", std::bind(&ByteBufferTestUnit::test_reserve, this), "test byte buffer reserve");
+  add_test("split", std::bind(&ByteBufferTestUnit::test_split, this), "test byte buffer split");
+  add_test("pool", std::bind(&ByteBufferTestUnit::test_pool, this), "test byte buffer chunk pool");
+}
+
+void ByteBufferTestUnit::test_append_release()
+{
+  byte_buffer buffer;
+  UNIT_ASSERT_EQUAL(buffer.size(), 0UL, "buffer must be empty");
+
+  // fill several chunks with numbers
+  const int count = 10000;
+  for (int i = 0; i < count; ++i) {
+    buffer.append(&i, sizeof(i));
+  }
+  UNIT_ASSERT_EQUAL(buffer.size(), count * sizeof(int), "invalid buffer size");
+
+  // release in the order of appending, interleaved with appends
+  for (int i = 0; i < count; ++i) {
+    int value = -1;
+    buffer.release(&value, sizeof(value));
+    UNIT_ASSERT_EQUAL(value, i, "invalid released value");
+    if (i % 2 == 0) {
+      int next = count + i / 2;
+      buffer.append(&next, sizeof(next));
+    }
+  }
+  for (int i = 0; i < count / 2; ++i) {
+    int value = -1;
+    buffer.release(&value, sizeof(value));
+    UNIT_ASSERT_EQUAL(value, count + i, "invalid released value");
+  }
+  UNIT_ASSERT_EQUAL(buffer.size(), 0UL, "buffer must be empty");
+
+  std::string text("hello world");
+  buffer.append(text.c_str(), text.size());
+  buffer.clear();
+  UNIT_ASSERT_EQUAL(buffer.size(), 0UL, "buffer must be empty");
+}
+
+void ByteBufferTestUnit::test_large_append()
+{
+  byte_buffer buffer;
+
+  char c = 'x';
+  buffer.append(&c, 1);
+
+  std::vector<char> data(3 * byte_buffer::chunk_size + 17);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = (char)(i % 127);
+  }
+  buffer.append(data.data(), data.size());
+  UNIT_ASSERT_EQUAL(buffer.size(), data.size() + 1, "invalid buffer size");
+
+  char first = 0;
+  buffer.release(&first, 1);
+  UNIT_ASSERT_EQUAL(first, 'x', "invalid first byte");
+
+  std::vector<char> result(data.size());
+  buffer.release(result.data(), result.size());
+  UNIT_ASSERT_TRUE(result == data, "released bytes must match appended bytes");
+  UNIT_ASSERT_EQUAL(buffer.size(), 0UL, "buffer must be empty");
+}
+
+void ByteBufferTestUnit::test_reserve()
+{
+  byte_buffer buffer;
+  int value = 42;
+  buffer.append(&value, sizeof(value));
+  buffer.reserve(2 * byte_buffer::chunk_size);
+
+  std::vector<char> data(2 * byte_buffer::chunk_size, 'a');
+  buffer.append(data.data(), data.size());
+  UNIT_ASSERT_EQUAL(buffer.size(), sizeof(value) + data.size(), "invalid buffer size");
+
+  int result = 0;
+  buffer.release(&result, sizeof(result));
+  UNIT_ASSERT_EQUAL(result, 42, "invalid released value");
+  std::vector<char> released(data.size());
+  buffer.release(released.data(), released.size());
+  UNIT_ASSERT_TRUE(released == data, "released bytes must match appended bytes");
+}
+
+void ByteBufferTestUnit::test_split()
+{
+  byte_buffer buffer;
+
+  // numbers over several chunks, the first ones already released
+  const int count = 10000;
+  for (int i = 0; i < count; ++i) {
+    buffer.append(&i, sizeof(i));
+  }
+  for (int i = 0; i < 10; ++i) {
+    int value = -1;
+    buffer.release(&value, sizeof(value));
+  }
+
+  // keep the numbers up to 6000
+  byte_buffer tail;
+  buffer.split((6000 - 10) * sizeof(int), tail);
+  UNIT_ASSERT_EQUAL(buffer.size(), (6000UL - 10) * sizeof(int), "invalid buffer size");
+  UNIT_ASSERT_EQUAL(tail.size(), (count - 6000UL) * sizeof(int), "invalid tail size");
+
+  // appends continue behind the split position
+  int next = -2;
+  buffer.append(&next, sizeof(next));
+  for (int i = 10; i < 6000; ++i) {
+    int value = -1;
+    buffer.release(&value, sizeof(value));
+    UNIT_ASSERT_EQUAL(value, i, "invalid released value");
+  }
+  int value = -1;
+  buffer.release(&value, sizeof(value));
+  UNIT_ASSERT_EQUAL(value, -2, "invalid appended value");
+  UNIT_ASSERT_EQUAL(buffer.size(), 0UL, "buffer must be empty");
+
+  for (int i = 6000; i < count; ++i) {
+    tail.release(&value, sizeof(value));
+    UNIT_ASSERT_EQUAL(value, i, "invalid released tail value");
+  }
+
+  // split on a chunk border and beyond the end
+  std::vector<char> data(2 * byte_buffer::chunk_size, 'a');
+  buffer.append(data.data(), data.size());
+  buffer.split(byte_buffer::chunk_size, tail);
+  UNIT_ASSERT_EQUAL(buffer.size(), (unsigned long)byte_buffer::chunk_size, "invalid buffer size");
+  UNIT_ASSERT_EQUAL(tail.size(), (unsigned long)byte_buffer::chunk_size, "invalid tail size");
+  buffer.split(buffer.size(), tail);
+  UNIT_ASSERT_EQUAL(tail.size(), (unsigned long)byte_buffer::chunk_size, "tail must not grow");
+  buffer.split(0, tail);
+  UNIT_ASSERT_EQUAL(buffer.size(), 0UL, "buffer must be empty");
+  UNIT_ASSERT_EQUAL(tail.size(), 2UL * byte_buffer::chunk_size, "invalid tail size");
+}
+
+void ByteBufferTestUnit::test_pool()
+{
+  const std::size_t size = byte_buffer::chunk_size * 2;
+  // pooled bytes observed in a new thread which starts with an empty pool
+  std::vector<std::size_t> pooled;
+  std::thread t([&pooled, size]() {
+    pooled.push_back(byte_buffer::pooled_bytes());
+    std::vector<char> data(size, 'b');
+    {
+      byte_buffer buffer;
+      buffer.append(data.data(), data.size());
+      pooled.push_back(byte_buffer::pooled_bytes());
+      buffer.clear();
+      pooled.push_back(byte_buffer::pooled_bytes());
+      // the pooled chunk is reused
+      buffer.append(data.data(), data.size());
+      pooled.push_back(byte_buffer::pooled_bytes());
+    }
+    // destroyed buffers return their chunks
+    pooled.push_back(byte_buffer::pooled_bytes());
+    byte_buffer::pool_limit(byte_buffer::chunk_size);
+    pooled.push_back(byte_buffer::pooled_bytes());
+    {
+      byte_buffer buffer;
+      buffer.append(data.data(), data.size());
+    }
+    pooled.push_back(byte_buffer::pooled_bytes());
+  });
+  t.join();
+
+  UNIT_ASSERT_EQUAL(pooled.size(), 7UL, "expected seven observations");
+  UNIT_ASSERT_EQUAL(pooled[0], 0UL, "pool must be empty");
+  UNIT_ASSERT_EQUAL(pooled[1], 0UL, "pool must be empty");
+  UNIT_ASSERT_EQUAL(pooled[2], size, "chunk must be pooled");
+  UNIT_ASSERT_EQUAL(pooled[3], 0UL, "chunk must be reused");
+  UNIT_ASSERT_EQUAL(pooled[4], size, "chunk must be pooled");
+  UNIT_ASSERT_EQUAL(pooled[5], 0UL, "pool must be trimmed");
+  UNIT_ASSERT_EQUAL(pooled[6], 0UL, "chunk must not be pooled");
+}
@@ -0,0 +1,18 @@
+#ifndef OOS_BYTEBUFFERTESTUNIT_HPP
+#define OOS_BYTEBUFFERTESTUNIT_HPP
+
+#include <unit/unit_test.hpp>
+
+class ByteBufferTestUnit : public oos::unit_test
+{
+public:
+  ByteBufferTestUnit();
+
+  void test_append_release();
+  void test_large_append();
+  void test_reserve();
+  void test_split();
+  void test_pool();
+};
+
+#endif //OOS_BYTEBUFFERTESTUNIT_HPP
@@ -0,0 +1,136 @@
+#include "FlatHashMapTestUnit.hpp"
+
+#include "tools/flat_hash_map.hpp"
+
+#include <random>
+#include <unordered_map>
+
+using namespace oos;
+
+FlatHashMapTestUnit::FlatHashMapTestUnit()
+  : unit_test("flat_map", "flat hash map test unit")
+{
+  add_test("insert", std::bind(&FlatHashMapTestUnit::test_insert, this), "test flat hash map insert and find");
+  add_test("erase", std::bind(&FlatHashMapTestUnit::test_erase, this), "test flat hash map erase");
+  add_test("reserve", std::bind(&FlatHashMapTestUnit::test_reserve, this), "test flat hash map reserve");
+  add_test("iterate", std::bind(&FlatHashMapTestUnit::test_iterate, this), "test flat hash map iteration");
+  add_test("random", std::bind(&FlatHashMapTestUnit::test_random, this), "test flat hash map against unordered map");
+}
+
+void FlatHashMapTestUnit::test_insert()
+{
+  flat_hash_map<unsigned long, int> map;
+
+  UNIT_ASSERT_TRUE(map.empty(), "map must be empty");
+  UNIT_ASSERT_TRUE(map.find(1) == map.end(), "key must not be found");
+
+  for (unsigned long i = 1; i <= 100; ++i) {
+    auto result = map.insert(std::make_pair(i, (int)i * 2));
+    UNIT_ASSERT_TRUE(result.second, "value must be inserted");
+  }
+
+  UNIT_ASSERT_EQUAL(100UL, map.size(), "invalid map size");
+
+  auto result = map.insert(std::make_pair(7UL, 0));
+
+  UNIT_ASSERT_FALSE(result.second, "value must not be inserted twice");
+  UNIT_ASSERT_EQUAL(14, result.first->second, "existing value must be returned");
+
+  auto i = map.find(42);
+
+  UNIT_ASSERT_TRUE(i != map.end(), "key must be found");
+  UNIT_ASSERT_EQUAL(84, i->second, "invalid value");
+  UNIT_ASSERT_TRUE(map.find(0) == map.end(), "empty key must not be found");
+  UNIT_ASSERT_TRUE(map.find(101) == map.end(), "key must not be found");
+  UNIT_ASSERT_EXCEPTION(map.insert(std::make_pair(0UL, 1)), std::invalid_argument, "flat_hash_map: key is reserved for empty slots", "empty key must not be inserted");
+}
+
+void FlatHashMapTestUnit::test_erase()
+{
+  flat_hash_map<unsigned long, int> map;
+
+  for (unsigned long i = 1; i <= 100; ++i) {
+    map.insert(std::make_pair(i, (int)i));
+  }
+
+  UNIT_ASSERT_EQUAL(1UL, map.erase(50), "key must be erased");
+  UNIT_ASSERT_EQUAL(0UL, map.erase(50), "key must not be erased twice");
+  UNIT_ASSERT_EQUAL(99UL, map.size(), "invalid map size");
+  UNIT_ASSERT_TRUE(map.find(50) == map.end(), "key must not be found");
+
+  map.erase(map.find(51));
+
+  UNIT_ASSERT_EQUAL(98UL, map.size(), "invalid map size");
+  UNIT_ASSERT_EQUAL(1UL, map.count(52), "key must be found");
+
+  std::size_t capacity = map.capacity();
+  map.clear();
+
+  UNIT_ASSERT_TRUE(map.empty(), "map must be empty");
+  UNIT_ASSERT_EQUAL(capacity, map.capacity(), "capacity must be kept");
+  UNIT_ASSERT_TRUE(map.begin() == map.end(), "map must be empty");
+}
+
+void FlatHashMapTestUnit::test_reserve()
+{
+  flat_hash_map<unsigned long, int> map;
+
+  map.reserve(1000);
+
+  std::size_t capacity = map.capacity();
+
+  UNIT_ASSERT_GREATER(capacity, 1000UL, "capacity must be greater than reserved size");
+
+  for (unsigned long i = 1; i <= 1000; ++i) {
+    map.insert(std::make_pair(i, (int)i));
+  }
+
+  UNIT_ASSERT_EQUAL(capacity, map.capacity(), "map must not be rehashed");
+}
+
+void FlatHashMapTestUnit::test_iterate()
+{
+  flat_hash_map<long, long> map;
+
+  long sum = 0;
+  for (long i = 1; i <= 10; ++i) {
+    map.insert(std::make_pair(i * 1000, i));
+    sum += i;
+  }
+
+  const flat_hash_map<long, long> &cmap = map;
+
+  long result = 0;
+  for (const auto &value : cmap) {
+    result += value.second;
+  }
+
+  UNIT_ASSERT_EQUAL(sum, result, "invalid sum of values");
+}
+
+void FlatHashMapTestUnit::test_random()
+{
+  flat_hash_map<unsigned long, unsigned long> map;
+  std::unordered_map<unsigned long, unsigned long> reference;
+
+  std::mt19937 gen(4711);
+  // a narrow key range forces collisions and erase chains
+  std::uniform_int_distribution<unsigned long> keys(1, 5000);
+
+  for (int i = 0; i < 100000; ++i) {
+    unsigned long key = keys(gen);
+    if (gen() % 3 == 0) {
+      UNIT_ASSERT_EQUAL(reference.erase(key), map.erase(key), "erase result must match");
+    } else {
+      UNIT_ASSERT_EQUAL(reference.insert(std::make_pair(key, key)).second, map.insert(std::make_pair(key, key)).second, "insert result must match");
+    }
+  }
+
+  UNIT_ASSERT_EQUAL(reference.size(), map.size(), "sizes must match");
+
+  for (const auto &value : reference) {
+    auto i = map.find(value.first);
+    UNIT_ASSERT_TRUE(i != map.end(), "key must be found");
+    UNIT_ASSERT_EQUAL(value.second, i->second, "values must match");
+  }
+}
@@ -0,0 +1,18 @@
+#ifndef OOS_FLATHASHMAPTESTUNIT_HPP
+#define OOS_FLATHASHMAPTESTUNIT_HPP
+
+#include <unit/unit_test.hpp>
+
+class FlatHashMapTestUnit : public oos::unit_test
+{
+public:
+  FlatHashMapTestUnit();
+
+  void test_insert();
+  void test_erase();
+  void test_reserve();
+  void test_iterate();
+  void test_random();
+};
+
+#endif //OOS_FLATHASHMAPTESTUNIT_HPP
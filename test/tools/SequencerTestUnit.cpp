@@ -0,0 +1,143 @@
+#include "SequencerTestUnit.hpp"
+
+#include "../Item.hpp"
+
+#include "tools/sequencer.hpp"
+
+#include "object/object_store.hpp"
+#include "object/object_view.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using namespace oos;
+
+SequencerTestUnit::SequencerTestUnit()
+  : unit_test("sequencer", "sequencer test unit")
+{
+  add_test("default", std::bind(&SequencerTestUnit::test_default, this), "test default sequencer");
+  add_test("block", std::bind(&SequencerTestUnit::test_block, this), "test block sequencer");
+  add_test("threads", std::bind(&SequencerTestUnit::test_threads, this), "test block sequencer with several threads");
+  add_test("store", std::bind(&SequencerTestUnit::test_store, this), "test object store with block sequencer");
+}
+
+void SequencerTestUnit::test_default()
+{
+  sequencer seq;
+
+  UNIT_ASSERT_EQUAL(seq.init(), 0UL, "expected zero");
+  UNIT_ASSERT_EQUAL(seq.next(), 1UL, "expected one");
+  UNIT_ASSERT_EQUAL(seq.current(), 1UL, "expected one");
+  UNIT_ASSERT_EQUAL(seq.update(10), 10UL, "expected ten");
+  UNIT_ASSERT_EQUAL(seq.update(5), 10UL, "expected ten");
+  UNIT_ASSERT_EQUAL(seq.reserve(5), 11UL, "expected first reserved id");
+  UNIT_ASSERT_EQUAL(seq.current(), 15UL, "expected last reserved id");
+  UNIT_ASSERT_EQUAL(seq.reset(3), 3UL, "expected three");
+  UNIT_ASSERT_EQUAL(seq.next(), 4UL, "expected four");
+}
+
+void SequencerTestUnit::test_block()
+{
+  std::shared_ptr<block_sequencer> impl = std::make_shared<block_sequencer>(8);
+  sequencer seq(impl);
+
+  UNIT_ASSERT_EQUAL(impl->block_size(), 8UL, "expected block size 8");
+  UNIT_ASSERT_EQUAL(seq.init(), 0UL, "expected zero");
+
+  // ids of one block are handed out in order
+  for (unsigned long i = 1; i <= 8; ++i) {
+    UNIT_ASSERT_EQUAL(seq.next(), i, "expected next id");
+  }
+  UNIT_ASSERT_EQUAL(seq.current(), 8UL, "expected last handed out id");
+  UNIT_ASSERT_EQUAL(seq.next(), 9UL, "expected first id of second block");
+  UNIT_ASSERT_EQUAL(seq.current(), 9UL, "expected last handed out id");
+
+  // reserved runs never overlap with blocks
+  UNIT_ASSERT_EQUAL(seq.reserve(4), 17UL, "expected first reserved id");
+  UNIT_ASSERT_EQUAL(seq.current(), 20UL, "expected last reserved id");
+  UNIT_ASSERT_EQUAL(seq.next(), 10UL, "expected next id of block");
+  UNIT_ASSERT_EQUAL(seq.current(), 20UL, "expected last reserved id");
+
+  // an id inside the reserved range skips the rest of the block
+  UNIT_ASSERT_EQUAL(seq.update(12), 20UL, "expected last handed out id");
+  UNIT_ASSERT_EQUAL(seq.next(), 21UL, "expected first id of a new block");
+  UNIT_ASSERT_EQUAL(seq.current(), 21UL, "expected last handed out id");
+
+  // an id below the skipped blocks keeps the block
+  UNIT_ASSERT_EQUAL(seq.update(15), 21UL, "expected last handed out id");
+  UNIT_ASSERT_EQUAL(seq.next(), 22UL, "expected next id of block");
+
+  // update beyond the reserved range skips the rest of the block
+  UNIT_ASSERT_EQUAL(seq.update(100), 100UL, "expected hundred");
+  UNIT_ASSERT_EQUAL(seq.next(), 101UL, "expected id after update");
+
+  UNIT_ASSERT_EQUAL(seq.reset(0), 0UL, "expected zero");
+  UNIT_ASSERT_EQUAL(seq.next(), 1UL, "expected id after reset");
+
+  // each sequencer has its own blocks
+  sequencer other(std::make_shared<block_sequencer>(8));
+  UNIT_ASSERT_EQUAL(other.next(), 1UL, "expected first id");
+  UNIT_ASSERT_EQUAL(seq.next(), 2UL, "expected next id");
+}
+
+void SequencerTestUnit::test_threads()
+{
+  sequencer seq(std::make_shared<block_sequencer>(16));
+
+  const unsigned long count = 10000;
+  std::vector<std::vector<unsigned long>> ids(4);
+  std::vector<std::thread> threads;
+  for (std::vector<unsigned long> &thread_ids : ids) {
+    threads.push_back(std::thread([&seq, &thread_ids, count]() {
+      for (unsigned long i = 0; i < count; ++i) {
+        thread_ids.push_back(seq.next());
+      }
+    }));
+  }
+  for (std::thread &t : threads) {
+    t.join();
+  }
+
+  std::vector<unsigned long> all;
+  for (const std::vector<unsigned long> &thread_ids : ids) {
+    UNIT_ASSERT_TRUE(std::is_sorted(thread_ids.begin(), thread_ids.end()), "ids of a thread must ascend");
+    all.insert(all.end(), thread_ids.begin(), thread_ids.end());
+  }
+  std::sort(all.begin(), all.end());
+  UNIT_ASSERT_TRUE(std::adjacent_find(all.begin(), all.end()) == all.end(), "ids must be unique");
+  UNIT_ASSERT_EQUAL(all.size(), 4 * count, "expected all ids");
+  UNIT_ASSERT_TRUE(seq.current() >= all.back(), "current must cover all ids");
+}
+
+void SequencerTestUnit::test_store()
+{
+  object_store store;
+  store.attach<Item>("item");
+
+  object_ptr<Item> first = store.insert(new Item);
+  UNIT_ASSERT_EQUAL(first.id(), 1UL, "expected id one");
+
+  // the new sequencer continues after the current id
+  store.exchange_sequencer(std::make_shared<block_sequencer>(32));
+
+  object_ptr<Item> second = store.insert(new Item);
+  UNIT_ASSERT_TRUE(second.id() > first.id(), "expected greater id");
+
+  std::vector<Item*> items;
+  for (int i = 0; i < 10; ++i) {
+    items.push_back(new Item);
+  }
+  store.insert_range<Item>(items.begin(), items.end());
+  object_ptr<Item> third = store.insert(new Item);
+  UNIT_ASSERT_EQUAL(third.id(), second.id() + 1, "expected next id of block");
+
+  object_view<Item> view(store);
+  std::vector<unsigned long> ids;
+  for (object_view<Item>::const_iterator it = view.begin(); it != view.end(); ++it) {
+    ids.push_back(it.optr().id());
+  }
+  std::sort(ids.begin(), ids.end());
+  UNIT_ASSERT_EQUAL(ids.size(), 13UL, "expected thirteen items");
+  UNIT_ASSERT_TRUE(std::adjacent_find(ids.begin(), ids.end()) == ids.end(), "ids must be unique");
+}
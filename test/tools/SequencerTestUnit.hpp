@@ -0,0 +1,17 @@
+#ifndef OOS_SEQUENCERTESTUNIT_HPP
+#define OOS_SEQUENCERTESTUNIT_HPP
+
+#include <unit/unit_test.hpp>
+
+class SequencerTestUnit : public oos::unit_test
+{
+public:
+  SequencerTestUnit();
+
+  void test_default();
+  void test_block();
+  void test_threads();
+  void test_store();
+};
+
+#endif //OOS_SEQUENCERTESTUNIT_HPP